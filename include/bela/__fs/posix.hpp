@@ -0,0 +1,265 @@
+// POSIX backends of the bela::fs tree engines, so they can be built and benchmarked on Linux and macOS
+#ifndef BELA_INTERNAL_FS_POSIX_HPP
+#define BELA_INTERNAL_FS_POSIX_HPP
+#if !defined(_WIN32)
+#include <cerrno>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#if defined(__linux__)
+#include <sys/syscall.h>
+#endif
+#include "remove_tree_internal.hpp"
+#include "walker_internal.hpp"
+
+namespace bela::fs::posix {
+namespace posix_internal {
+inline std::error_code last_error() { return std::error_code(errno, std::generic_category()); }
+
+#if !defined(DT_UNKNOWN)
+// no d_type: every entry is resolved with fstatat
+constexpr unsigned char DT_UNKNOWN = 0;
+#endif
+
+#if defined(__linux__)
+struct linux_dirent64 {
+  uint64_t d_ino;
+  int64_t d_off;
+  unsigned short d_reclen;
+  unsigned char d_type;
+  char d_name[1];
+};
+
+// Enumerate calls fn(name, d_type) for every entry from the first one on, reading 64K of entries per getdents64. name
+// is NUL terminated.
+template <typename Fn> bool Enumerate(int dir, Fn &&fn, std::error_code &ec) {
+  constexpr size_t bufferSize = 64 * 1024;
+  auto buffer = std::make_unique<uint64_t[]>(bufferSize / sizeof(uint64_t));
+  if (lseek(dir, 0, SEEK_SET) < 0) {
+    ec = last_error();
+    return false;
+  }
+  for (;;) {
+    auto n = syscall(SYS_getdents64, dir, buffer.get(), bufferSize);
+    if (n < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      ec = last_error();
+      return false;
+    }
+    if (n == 0) {
+      return true;
+    }
+    auto p = reinterpret_cast<const char *>(buffer.get());
+    for (long offset = 0; offset < n;) {
+      auto e = reinterpret_cast<const linux_dirent64 *>(p + offset);
+      offset += e->d_reclen;
+      std::string_view name(e->d_name);
+      if (name == "." || name == "..") {
+        continue;
+      }
+      if (!fn(name, e->d_type)) {
+        return true;
+      }
+    }
+  }
+}
+#else
+// Enumerate calls fn(name, d_type) for every entry from the first one on, name is NUL terminated. The directory is
+// read through a duplicate so the caller keeps its descriptor.
+template <typename Fn> bool Enumerate(int dir, Fn &&fn, std::error_code &ec) {
+  auto fd = dup(dir);
+  if (fd < 0) {
+    ec = last_error();
+    return false;
+  }
+  auto *d = fdopendir(fd);
+  if (d == nullptr) {
+    ec = last_error();
+    close(fd);
+    return false;
+  }
+  rewinddir(d); // the duplicate shares the offset of a previous pass
+  auto result = true;
+  for (;;) {
+    errno = 0;
+    auto *e = readdir(d);
+    if (e == nullptr) {
+      if (errno != 0) {
+        ec = last_error();
+        result = false;
+      }
+      break;
+    }
+    std::string_view name(e->d_name);
+    if (name == "." || name == "..") {
+      continue;
+    }
+#if defined(DT_DIR)
+    unsigned char type = e->d_type;
+#else
+    unsigned char type = DT_UNKNOWN;
+#endif
+    if (!fn(name, type)) {
+      break;
+    }
+  }
+  closedir(d);
+  return result;
+}
+#endif
+
+// Classify returns the type of an entry. It calls fstatat only when the file system reported no type or for the size
+// of a file or link; size stays -1 otherwise.
+inline EntryType Classify(int dir, std::string_view name, unsigned char type, bool sizes, int64_t &size) {
+  size = -1;
+  auto t = EntryType::Other;
+  switch (type) {
+#if defined(DT_DIR)
+  case DT_DIR:
+    return EntryType::Directory;
+  case DT_REG:
+    t = EntryType::File;
+    break;
+  case DT_LNK:
+    t = EntryType::Symlink;
+    break;
+#endif
+  case DT_UNKNOWN:
+    break;
+  default:
+    return EntryType::Other;
+  }
+  if (type != DT_UNKNOWN && !sizes) {
+    return t;
+  }
+  struct stat st;
+  if (fstatat(dir, name.data(), &st, AT_SYMLINK_NOFOLLOW) != 0) {
+    return t; // removed meanwhile
+  }
+  if (S_ISDIR(st.st_mode)) {
+    return EntryType::Directory;
+  }
+  t = S_ISREG(st.st_mode) ? EntryType::File : S_ISLNK(st.st_mode) ? EntryType::Symlink : EntryType::Other;
+  if (sizes) {
+    size = static_cast<int64_t>(st.st_size);
+  }
+  return t;
+}
+
+struct remove_backend {
+  using handle_type = int;
+  using string_type = std::string;
+  using error_type = std::error_code;
+  static constexpr int invalid = -1;
+  static constexpr int root = AT_FDCWD;
+  bool OpenDir(int parent, const std::string &name, int &dir, std::error_code &ec) {
+    // O_NOFOLLOW: a directory replaced by a symbolic link is not followed out of the tree
+    constexpr int flags = O_RDONLY | O_DIRECTORY | O_NOFOLLOW | O_CLOEXEC;
+    auto fd = openat(parent, name.data(), flags);
+    if (fd < 0 && errno == EACCES && fchmodat(parent, name.data(), S_IRWXU, 0) == 0) {
+      fd = openat(parent, name.data(), flags);
+    }
+    if (fd < 0) {
+      ec = last_error();
+      return false;
+    }
+    dir = fd;
+    return true;
+  }
+  template <typename Fn> bool Enumerate(int dir, Fn &&fn, std::error_code &ec) {
+    return posix_internal::Enumerate(
+        dir,
+        [&](std::string_view name, unsigned char type) {
+          int64_t size = 0;
+          return fn(name, Classify(dir, name, type, false, size) == EntryType::Directory);
+        },
+        ec);
+  }
+  bool RemoveFile(int dir, const std::string &name, std::error_code &ec) {
+    if (unlinkat(dir, name.data(), 0) == 0 || errno == ENOENT) {
+      return true;
+    }
+    ec = last_error();
+    return false;
+  }
+  bool RemoveDir(int parent, const std::string &name, int /*dir*/, std::error_code &ec) {
+    if (unlinkat(parent, name.data(), AT_REMOVEDIR) == 0 || errno == ENOENT) {
+      return true;
+    }
+    ec = last_error();
+    return false;
+  }
+  bool NotEmpty(const std::error_code &ec) { return ec.value() == ENOTEMPTY || ec.value() == EEXIST; }
+  void Close(int dir) { close(dir); }
+};
+
+struct walk_backend {
+  using char_type = char;
+  using handle_type = int;
+  using error_type = std::error_code;
+  bool OpenDir(const std::string &path, bool root, int &dir, std::error_code &ec) {
+    // subdirectories are walked only when they are no links, a link swapped in meanwhile is not followed
+    auto fd = open(path.data(), O_RDONLY | O_DIRECTORY | O_CLOEXEC | (root ? 0 : O_NOFOLLOW));
+    if (fd < 0) {
+      ec = last_error();
+      return false;
+    }
+    dir = fd;
+    return true;
+  }
+  template <typename Fn> bool Enumerate(int dir, bool sizes, Fn &&fn, std::error_code &ec) {
+    return posix_internal::Enumerate(
+        dir,
+        [&](std::string_view name, unsigned char type) {
+          int64_t size = -1;
+          auto t = Classify(dir, name, type, sizes, size);
+          return fn(name, t, size);
+        },
+        ec);
+  }
+  void Close(int dir) { close(dir); }
+};
+} // namespace posix_internal
+
+// ForceDeleteFolders removes the directory path and everything below it, see bela::fs::RemoveOptions. A symbolic
+// link is removed, not followed; path itself must be a directory.
+inline bool ForceDeleteFolders(std::string_view path, const RemoveOptions &opts, RemoveStats &stats,
+                               std::error_code &ec) {
+  posix_internal::remove_backend backend;
+  fs_internal::remover<posix_internal::remove_backend> r(backend, opts);
+  return r.Remove(std::string(path), stats, ec);
+}
+
+using Glob = basic_glob<char>;
+using WalkEntry = basic_walk_entry<char>;
+using WalkOptions = basic_walk_options<char>;
+
+// Walker is bela::fs::Walker on POSIX: directories are read with getdents64 on Linux and readdir elsewhere, types come
+// from d_type. Sizes cost one fstatat per file, turn WalkOptions::sizes off when they are not needed.
+class Walker {
+public:
+  explicit Walker(WalkOptions opts_ = {}) : opts(std::move(opts_)) {}
+  bool Walk(std::string_view root, const std::function<void(const WalkEntry &)> &fn, std::error_code &ec) {
+    stats = WalkStats{};
+    posix_internal::walk_backend backend;
+    fs_internal::walker<posix_internal::walk_backend> w(backend, opts, fn);
+    return w.Walk(root, stats, ec);
+  }
+  const WalkStats &Stats() const { return stats; }
+
+private:
+  WalkOptions opts;
+  WalkStats stats;
+};
+} // namespace bela::fs::posix
+
+#endif
+#endif
@@ -0,0 +1,257 @@
+//
+#ifndef BELA_INTERNAL_REMOVE_TREE_HPP
+#define BELA_INTERNAL_REMOVE_TREE_HPP
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace bela::fs {
+struct RemoveOptions {
+  size_t concurrency{0};      // threads removing the tree, the caller included, 0: one per hardware thread
+  size_t batch{128};          // files deleted as one work item, larger directories are split across threads
+  size_t queueCapacity{1024}; // queued work items at most, when the queue is full a thread removes what it found
+};
+
+struct RemoveStats {
+  uint64_t files{0};       // every entry that is not a directory: files, symbolic links, junctions
+  uint64_t directories{0}; // the root included
+};
+
+namespace fs_internal {
+// remover deletes a directory tree with threads sharing a bounded stack of work items. An item either enumerates one
+// directory or deletes a batch of its files. Entries are opened relative to the handle of their directory, no full
+// path is ever built. Every directory counts its unfinished items: the thread finishing the last one removes the
+// directory and releases its parent, so directories go bottom-up without a second walk.
+//
+// A directory keeps its handle until it is removed, its entries are deleted and its subdirectories removed through it.
+// Items are taken last in, first out, so the tree is removed depth first: the open directories are the ones on the
+// paths the threads are working on, about concurrency times the depth of the tree. Breadth first, every directory of
+// a level would be open at once and a wide tree runs out of descriptors.
+//
+// Backend is the platform part, its functions are called concurrently:
+//
+//  using handle_type; using string_type; using error_type;
+//  static constexpr handle_type invalid; // no handle
+//  static constexpr handle_type root;    // parent of the root, the root's name is its path
+//  bool OpenDir(handle_type parent, const string_type &name, handle_type &dir, error_type &ec);
+//  // Enumerate calls fn(name, isDir) from the first entry on, fn returns false to stop. Links are no directories.
+//  bool Enumerate(handle_type dir, Fn &&fn, error_type &ec);
+//  bool RemoveFile(handle_type dir, const string_type &name, error_type &ec);
+//  bool RemoveDir(handle_type parent, const string_type &name, handle_type dir, error_type &ec);
+//  bool NotEmpty(const error_type &ec);
+//  void Close(handle_type dir);
+template <typename Backend> class remover {
+public:
+  using handle_type = typename Backend::handle_type;
+  using string_type = typename Backend::string_type;
+  using error_type = typename Backend::error_type;
+  remover(Backend &backend_, const RemoveOptions &opts_) : backend(backend_), opts(opts_) {
+    if (opts.concurrency == 0) {
+      opts.concurrency = (std::max)(std::thread::hardware_concurrency(), 1U);
+    }
+    opts.batch = (std::max)(opts.batch, size_t{1});
+  }
+  remover(const remover &) = delete;
+  remover &operator=(const remover &) = delete;
+
+  bool Remove(const string_type &path, RemoveStats &stats, error_type &ec) {
+    auto *root = new node{.name = path};
+    if (!backend.OpenDir(Backend::root, path, root->handle, ec)) {
+      delete root;
+      return false;
+    }
+    queue.emplace_back(item{.dir = root});
+    {
+      // blocking I/O: dedicated threads rather than the shared ThreadPool, which is sized for computation
+      std::vector<std::jthread> threads;
+      for (size_t i = 1; i < opts.concurrency; i++) {
+        threads.emplace_back([this] { Work(); });
+      }
+      Work();
+    }
+    stats.files += files.load(std::memory_order_relaxed);
+    stats.directories += directories.load(std::memory_order_relaxed);
+    if (failed) {
+      ec = std::move(error);
+      return false;
+    }
+    return true;
+  }
+
+private:
+  // a directory whose enumeration fails to empty it is enumerated again: deleting entries while enumerating may skip
+  // some on network file systems, and entries may be created meanwhile
+  static constexpr uint32_t maxPasses = 3;
+  struct node {
+    node *parent{nullptr};
+    string_type name;
+    handle_type handle{Backend::invalid};
+    std::atomic_size_t pending{1}; // the enumeration, queued files batches and subdirectories not yet removed
+    uint32_t passes{1};
+  };
+  // item enumerates dir when files is empty, otherwise deletes files of dir
+  struct item {
+    node *dir{nullptr};
+    std::vector<string_type> files;
+  };
+
+  bool Stopped() const { return stopped.load(std::memory_order_relaxed); }
+  void Fail(error_type &ec) {
+    std::scoped_lock lock(errorMutex);
+    if (!failed) {
+      failed = true;
+      error = std::move(ec);
+      stopped.store(true, std::memory_order_relaxed);
+    }
+  }
+  // TryPush stacks an item unless the stack is full, it moves from it only on success
+  bool TryPush(item &it) {
+    {
+      std::scoped_lock lock(mutex);
+      if (queue.size() >= opts.queueCapacity) {
+        return false;
+      }
+      queue.emplace_back(std::move(it));
+    }
+    cond.notify_one();
+    return true;
+  }
+  // Work runs stacked items, newest first, until the stack is empty and no other thread runs one, which only spawns more
+  void Work() {
+    for (;;) {
+      item it;
+      {
+        std::unique_lock lock(mutex);
+        cond.wait(lock, [this] { return !queue.empty() || busy == 0; });
+        if (queue.empty()) {
+          return;
+        }
+        it = std::move(queue.back());
+        queue.pop_back();
+        busy++;
+      }
+      if (it.files.empty()) {
+        Process(it.dir);
+      } else {
+        RemoveFiles(it.dir, it.files);
+        Release(it.dir);
+      }
+      {
+        std::scoped_lock lock(mutex);
+        if (--busy == 0 && queue.empty()) {
+          cond.notify_all();
+        }
+      }
+    }
+  }
+  void RemoveFiles(node *dir, const std::vector<string_type> &names) {
+    uint64_t removed = 0;
+    for (const auto &name : names) {
+      if (Stopped()) {
+        break;
+      }
+      error_type ec;
+      if (!backend.RemoveFile(dir->handle, name, ec)) {
+        Fail(ec);
+        break;
+      }
+      removed++;
+    }
+    files.fetch_add(removed, std::memory_order_relaxed);
+  }
+  // Process opens and enumerates a directory: subdirectories are queued, files are deleted in batches
+  void Process(node *dir) {
+    error_type ec;
+    if (dir->handle == Backend::invalid && !Stopped() &&
+        !backend.OpenDir(dir->parent->handle, dir->name, dir->handle, ec)) {
+      Fail(ec);
+    }
+    std::vector<string_type> batch;
+    std::vector<node *> overflow; // subdirectories the stack had no room for
+    if (dir->handle != Backend::invalid && !Stopped()) {
+      auto enumerated = backend.Enumerate(
+          dir->handle,
+          [&](auto name, bool isDir) {
+            if (Stopped()) {
+              return false;
+            }
+            if (isDir) {
+              auto *child = new node{.parent = dir, .name = string_type(name)};
+              dir->pending.fetch_add(1, std::memory_order_relaxed);
+              if (item it{.dir = child}; !TryPush(it)) {
+                overflow.emplace_back(child);
+              }
+              return true;
+            }
+            batch.emplace_back(name);
+            if (batch.size() < opts.batch) {
+              return true;
+            }
+            dir->pending.fetch_add(1, std::memory_order_relaxed);
+            if (item it{.dir = dir, .files = std::move(batch)}; !TryPush(it)) {
+              dir->pending.fetch_sub(1, std::memory_order_relaxed);
+              RemoveFiles(dir, it.files);
+            }
+            batch.clear();
+            return true;
+          },
+          ec);
+      if (!enumerated) {
+        Fail(ec);
+      }
+    }
+    RemoveFiles(dir, batch);
+    for (auto *child : overflow) {
+      if (item it{.dir = child}; !TryPush(it)) {
+        Process(child);
+      }
+    }
+    Release(dir);
+  }
+  // Release finishes one item of n, the last one removes n and releases its parent
+  void Release(node *n) {
+    while (n != nullptr && n->pending.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+      auto *parent = n->parent;
+      if (n->handle != Backend::invalid && !Stopped()) {
+        error_type ec;
+        if (backend.RemoveDir(parent != nullptr ? parent->handle : Backend::root, n->name, n->handle, ec)) {
+          directories.fetch_add(1, std::memory_order_relaxed);
+        } else if (backend.NotEmpty(ec) && n->passes < maxPasses) {
+          n->passes++;
+          n->pending.store(1, std::memory_order_relaxed);
+          Process(n);
+          return;
+        } else {
+          Fail(ec);
+        }
+      }
+      if (n->handle != Backend::invalid) {
+        backend.Close(n->handle);
+      }
+      delete n;
+      n = parent;
+    }
+  }
+
+  Backend &backend;
+  RemoveOptions opts;
+  std::mutex mutex;
+  std::condition_variable cond;
+  std::deque<item> queue;
+  size_t busy{0};
+  std::atomic_bool stopped{false};
+  std::atomic_uint64_t files{0};
+  std::atomic_uint64_t directories{0};
+  std::mutex errorMutex;
+  bool failed{false};
+  error_type error;
+};
+} // namespace fs_internal
+} // namespace bela::fs
+
+#endif
@@ -0,0 +1,321 @@
+//
+#ifndef BELA_INTERNAL_WALKER_HPP
+#define BELA_INTERNAL_WALKER_HPP
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <initializer_list>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+#include "../fnmatch.hpp"
+#include "../thread_pool.hpp"
+
+namespace bela::fs {
+enum class EntryType : uint8_t {
+  File,
+  Directory,
+  Symlink, // symbolic links and junctions, never followed
+  Other,   // devices, pipes, sockets
+};
+
+// basic_walk_entry is valid during the callback only. dir is the path of the directory holding the entry, built once
+// per directory: no path is built per entry unless Path() is called.
+template <typename C> struct basic_walk_entry {
+  using string_view_type = std::basic_string_view<C>;
+  static constexpr C separator = std::is_same_v<C, wchar_t> ? C('\\') : C('/');
+  string_view_type dir;
+  string_view_type name;
+  int64_t size{-1}; // bytes of a file or link, -1 for directories and when sizes are off
+  uint32_t depth{0}; // 0: the entry is in the root
+  EntryType type{EntryType::File};
+  bool IsDir() const { return type == EntryType::Directory; }
+  bool IsFile() const { return type == EntryType::File; }
+  bool IsSymlink() const { return type == EntryType::Symlink; }
+  std::basic_string<C> Path() const {
+    std::basic_string<C> path;
+    path.reserve(dir.size() + name.size() + 1);
+    path.append(dir);
+    if (!dir.empty() && dir.back() != separator) {
+      path.push_back(separator);
+    }
+    path.append(name);
+    return path;
+  }
+};
+
+// basic_glob is a set of fnmatch patterns compiled for matching names. Patterns of the common shapes: "name",
+// "prefix*", "*.ext", "*part*" and "*" compare the name directly, the others run FnMatch.
+template <typename C> class basic_glob {
+public:
+  using string_view_type = std::basic_string_view<C>;
+  basic_glob() = default;
+  basic_glob(std::initializer_list<string_view_type> patterns_, int flags_ = 0) : flags(flags_) {
+    for (auto p : patterns_) {
+      Add(p);
+    }
+  }
+  void Add(string_view_type pattern) {
+    auto literal = [this](string_view_type s) {
+      return std::ranges::none_of(s, [this](C c) {
+        return c == '*' || c == '?' || c == '[' || c == '\\' || (CaseFold() && static_cast<uint32_t>(c) >= 0x80);
+      });
+    };
+    compiled c{.k = kind::wildcard, .pattern = std::basic_string<C>(pattern)};
+    // a leading period must be matched explicitly with fnmatch::Period, FnMatch knows the rule
+    if ((flags & fnmatch::Period) == 0 && !pattern.empty()) {
+      auto n = pattern.size();
+      if (n == 1 && pattern[0] == '*') {
+        c.k = kind::any;
+      } else if (literal(pattern)) {
+        c.k = kind::literal;
+        c.text = pattern;
+      } else if (n >= 2 && pattern.front() == '*' && pattern.back() == '*' && literal(pattern.substr(1, n - 2))) {
+        c.k = kind::contains;
+        c.text = pattern.substr(1, n - 2);
+      } else if (pattern.front() == '*' && literal(pattern.substr(1))) {
+        c.k = kind::suffix;
+        c.text = pattern.substr(1);
+      } else if (pattern.back() == '*' && literal(pattern.substr(0, n - 1))) {
+        c.k = kind::prefix;
+        c.text = pattern.substr(0, n - 1);
+      }
+      if (CaseFold()) {
+        std::ranges::transform(c.text, c.text.begin(), Fold);
+      }
+    }
+    patterns.emplace_back(std::move(c));
+  }
+  bool Empty() const { return patterns.empty(); }
+  // Match reports whether name matches any pattern
+  bool Match(string_view_type name) const {
+    // Unicode case folding may map a non-ASCII character to an ASCII one, leave such names to FnMatch
+    auto direct = !CaseFold() || std::ranges::none_of(name, [](C c) { return static_cast<uint32_t>(c) >= 0x80; });
+    for (const auto &p : patterns) {
+      if (!direct || p.k == kind::wildcard) {
+        if (bela::FnMatch(p.pattern, name, flags)) {
+          return true;
+        }
+        continue;
+      }
+      string_view_type text(p.text);
+      switch (p.k) {
+      case kind::any:
+        return true;
+      case kind::literal:
+        if (Equal(name, text)) {
+          return true;
+        }
+        break;
+      case kind::prefix:
+        if (name.size() >= text.size() && Equal(name.substr(0, text.size()), text)) {
+          return true;
+        }
+        break;
+      case kind::suffix:
+        if (name.size() >= text.size() && Equal(name.substr(name.size() - text.size()), text)) {
+          return true;
+        }
+        break;
+      case kind::contains:
+        if (text.empty() || Contains(name, text)) {
+          return true;
+        }
+        break;
+      default:
+        break;
+      }
+    }
+    return false;
+  }
+
+private:
+  enum class kind : uint8_t { any, literal, prefix, suffix, contains, wildcard };
+  struct compiled {
+    kind k{kind::wildcard};
+    std::basic_string<C> pattern;
+    std::basic_string<C> text; // the literal part of pattern, folded to lower case with fnmatch::CaseFold
+  };
+  bool CaseFold() const { return (flags & fnmatch::CaseFold) != 0; }
+  static C Fold(C c) { return c >= 'A' && c <= 'Z' ? static_cast<C>(c + ('a' - 'A')) : c; }
+  bool Equal(string_view_type name, string_view_type text) const {
+    if (!CaseFold()) {
+      return name == text;
+    }
+    return std::ranges::equal(name, text, [](C a, C b) { return Fold(a) == b; });
+  }
+  bool Contains(string_view_type name, string_view_type text) const {
+    if (!CaseFold()) {
+      return name.find(text) != string_view_type::npos;
+    }
+    return !std::ranges::search(name, text, [](C a, C b) { return Fold(a) == b; }).empty();
+  }
+  std::vector<compiled> patterns;
+  int flags{0};
+};
+
+template <typename C> struct basic_walk_options {
+  ThreadPool *pool{nullptr}; // runs the directories, nullptr: ThreadPool::Default()
+  basic_glob<C> include;     // when not empty, entries other than directories must match
+  basic_glob<C> exclude;     // matching entries are skipped, matching directories are not descended
+  // prune is called for every entry that passed exclude, returning true skips it and does not descend a directory
+  std::function<bool(const basic_walk_entry<C> &)> prune;
+  uint32_t maxDepth{UINT32_MAX}; // directories at this depth are reported but not descended
+  bool sizes{true};              // POSIX: one fstatat per file, Windows: free
+  bool ignoreErrors{false};      // skip directories that cannot be read instead of failing, they are counted
+};
+
+struct WalkStats {
+  uint64_t files{0}; // entries other than directories
+  uint64_t directories{0};
+  uint64_t bytes{0};  // sum of the file sizes
+  uint64_t errors{0}; // directories skipped with ignoreErrors
+};
+
+namespace fs_internal {
+// walker enumerates a directory tree on a thread pool. Every directory is a task of one TaskGroup: its subdirectories
+// are spawned as tasks on the worker that found them and stolen by idle workers, so a tree fans out across the pool
+// while each worker mostly walks depth first. Directories are read with the large-buffer APIs of the platform, types
+// and sizes come from the enumeration.
+//
+// Backend is the platform part, its functions are called concurrently:
+//
+//  using char_type; using handle_type; using error_type;
+//  bool OpenDir(const std::basic_string<char_type> &path, bool root, handle_type &dir, error_type &ec);
+//  // Enumerate calls fn(name, type, size) for every entry, fn returns false to stop
+//  bool Enumerate(handle_type dir, bool sizes, Fn &&fn, error_type &ec);
+//  void Close(handle_type dir);
+template <typename Backend> class walker {
+public:
+  using char_type = typename Backend::char_type;
+  using string_type = std::basic_string<char_type>;
+  using string_view_type = std::basic_string_view<char_type>;
+  using handle_type = typename Backend::handle_type;
+  using error_type = typename Backend::error_type;
+  using entry_type = basic_walk_entry<char_type>;
+  using visit_type = std::function<void(const entry_type &)>;
+  walker(Backend &backend_, const basic_walk_options<char_type> &opts_, const visit_type &fn_)
+      : backend(backend_), opts(opts_), fn(fn_) {}
+  walker(const walker &) = delete;
+  walker &operator=(const walker &) = delete;
+
+  bool Walk(string_view_type root, WalkStats &stats, error_type &ec) {
+    handle_type h;
+    string_type dir(root);
+    if (!backend.OpenDir(dir, true, h, ec)) {
+      return false;
+    }
+    // the root handle is closed here until its task is queued, then by the task
+    closer owner{backend, h};
+    TaskGroup group(opts.pool != nullptr ? *opts.pool : ThreadPool::Default());
+    group.Run([this, &group, h, dir = std::move(dir)] { Enumerate(group, dir, h, 0); });
+    owner.owned = false;
+    // rethrows the first exception of fn
+    group.Wait();
+    stats.files += files.load(std::memory_order_relaxed);
+    stats.directories += directories.load(std::memory_order_relaxed);
+    stats.bytes += bytes.load(std::memory_order_relaxed);
+    stats.errors += errors.load(std::memory_order_relaxed);
+    if (failed) {
+      ec = std::move(error);
+      return false;
+    }
+    return true;
+  }
+
+private:
+  struct closer {
+    Backend &backend;
+    handle_type h;
+    bool owned{true};
+    ~closer() {
+      if (owned) {
+        backend.Close(h);
+      }
+    }
+  };
+  void Fail(TaskGroup &group, error_type &ec) {
+    if (opts.ignoreErrors) {
+      errors.fetch_add(1, std::memory_order_relaxed);
+      return;
+    }
+    std::scoped_lock lock(errorMutex);
+    if (!failed) {
+      failed = true;
+      error = std::move(ec);
+      group.Cancel();
+    }
+  }
+  bool Accept(const entry_type &e) const {
+    if (!opts.exclude.Empty() && opts.exclude.Match(e.name)) {
+      return false;
+    }
+    if (opts.prune && opts.prune(e)) {
+      return false;
+    }
+    return e.IsDir() || opts.include.Empty() || opts.include.Match(e.name);
+  }
+  void Process(TaskGroup &group, const string_type &dir, uint32_t depth) {
+    handle_type h;
+    error_type ec;
+    if (!backend.OpenDir(dir, false, h, ec)) {
+      Fail(group, ec);
+      return;
+    }
+    Enumerate(group, dir, h, depth);
+  }
+  void Enumerate(TaskGroup &group, const string_type &dir, handle_type h, uint32_t depth) {
+    closer c{backend, h};
+    uint64_t nfiles = 0;
+    uint64_t ndirs = 0;
+    uint64_t nbytes = 0;
+    error_type ec;
+    auto enumerated = backend.Enumerate(
+        h, opts.sizes,
+        [&](string_view_type name, EntryType type, int64_t size) {
+          if (group.Cancelled()) {
+            return false;
+          }
+          entry_type e{.dir = dir, .name = name, .size = size, .depth = depth, .type = type};
+          if (!Accept(e)) {
+            return true;
+          }
+          fn(e);
+          if (type != EntryType::Directory) {
+            nfiles++;
+            nbytes += static_cast<uint64_t>((std::max)(size, int64_t{0}));
+            return true;
+          }
+          ndirs++;
+          if (depth < opts.maxDepth) {
+            group.Run([this, &group, child = e.Path(), depth] { Process(group, child, depth + 1); });
+          }
+          return true;
+        },
+        ec);
+    if (!enumerated) {
+      Fail(group, ec);
+    }
+    files.fetch_add(nfiles, std::memory_order_relaxed);
+    directories.fetch_add(ndirs, std::memory_order_relaxed);
+    bytes.fetch_add(nbytes, std::memory_order_relaxed);
+  }
+
+  Backend &backend;
+  const basic_walk_options<char_type> &opts;
+  const visit_type &fn;
+  std::atomic_uint64_t files{0};
+  std::atomic_uint64_t directories{0};
+  std::atomic_uint64_t bytes{0};
+  std::atomic_uint64_t errors{0};
+  std::mutex errorMutex;
+  bool failed{false};
+  error_type error;
+};
+} // namespace fs_internal
+} // namespace bela::fs
+
+#endif
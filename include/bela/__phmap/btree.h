@@ -1806,6 +1806,24 @@ namespace priv {
         template <typename InputIterator>
         void insert_iterator_multi(InputIterator b, InputIterator e);
 
+        // Builds this empty btree from the n values returned in order by next().
+        // The values must be sorted (and distinct for unique containers). Leaves
+        // are packed full and built bottom-up with no key comparison and no node
+        // split, so loading is O(n).
+        template <typename Next>
+        void bulk_load(size_type n, Next &next);
+
+        // Bulk loads the sorted range [b, e). Unique containers keep the first of
+        // a run of equal keys, like repeated insert_unique() would.
+        template <typename ForwardIterator>
+        void bulk_load_sorted(ForwardIterator b, ForwardIterator e);
+
+        // Bulk loads the union of x and y in a single linear pass. Values of x
+        // come before equal values of y, unique containers drop those of y.
+        // Values are moved out of non-const trees.
+        template <typename Btree>
+        void bulk_load_merged(Btree *x, Btree *y);
+
         // Erase the specified iterator from the btree. The iterator must be valid
         // (i.e. not equal to end()).  Return an iterator pointing to the node after
         // the one that was erased (or end() if none exists).
@@ -2013,6 +2031,34 @@ namespace priv {
             deallocate(node_type::LeafSize(node->max_count()), node);
         }
 
+        // The shape of one level of a bulk loaded tree: `count` nodes share
+        // `items` values (leaves) or children (internal nodes). All nodes but the
+        // last two hold `capacity` items, the last two split the rest evenly so
+        // that neither underflows.
+        struct bulk_level {
+            size_type count;
+            size_type items;
+            size_type capacity;
+
+            size_type rest() const { return items - (count - 2) * capacity; }
+            size_type node_items(size_type i) const {
+                if (count == 1) return items;
+                if (i + 2 < count) return capacity;
+                return i + 2 == count ? (rest() + 1) / 2 : rest() / 2;
+            }
+            size_type first_item(size_type i) const {
+                if (count == 1 || i + 1 < count) return i * capacity;
+                return (count - 2) * capacity + (rest() + 1) / 2;
+            }
+        };
+
+        // Fills node, the i-th node of levels[level], and its subtree in order.
+        // Children are attached before they are filled so that the partial tree
+        // can be cleared when a value constructor throws.
+        template <typename Next>
+        void bulk_fill(const bulk_level *levels, int level, size_type i,
+                       node_type *node, Next &next);
+
         // Rebalances or splits the node iter points to.
         void rebalance_or_split(iterator *iter);
 
@@ -2481,6 +2527,147 @@ namespace priv {
         }
     }
 
+    template <typename P>
+    template <typename Next>
+    void btree<P>::bulk_load(size_type n, Next &next) {
+        assert(empty());
+        if (n == 0) return;
+        bulk_level levels[64];
+        int height = 0;
+        node_type *root = nullptr;
+        if (n <= kNodeValues) {
+            // A root leaf only as large as needed, as insertions would leave it.
+            levels[0] = {1, n, n};
+            root = new_leaf_root_node(static_cast<int>(n));
+        } else {
+            // The fewest leaves that hold n values once one value per leaf but the
+            // last moves up as a delimiter, then the fewest nodes on each level
+            // above that hold the children below.
+            size_type count = (n + kNodeValues + 1) / (kNodeValues + 1);
+            levels[0] = {count, n - (count - 1), kNodeValues};
+            while (levels[height].count > 1) {
+                const size_type children = levels[height].count;
+                count = (children + kNodeValues) / (kNodeValues + 1);
+                levels[++height] = {count, children, kNodeValues + 1};
+            }
+            root = new_internal_node(nullptr);
+        }
+        PHMAP_INTERNAL_TRY {
+            bulk_fill(levels, height, 0, root, next);
+        }
+        PHMAP_INTERNAL_CATCH_ANY {
+            internal_clear(root);
+            PHMAP_INTERNAL_RETHROW;
+        }
+        node_type *leftmost = root;
+        while (!leftmost->leaf()) leftmost = leftmost->child(0);
+        node_type *rightmost = root;
+        while (!rightmost->leaf()) rightmost = rightmost->child(rightmost->count());
+        // The leftmost leaf is stored as the parent of the root.
+        root->set_parent(leftmost);
+        mutable_root() = root;
+        rightmost_ = rightmost;
+        size_ = n;
+    }
+
+    template <typename P>
+    template <typename Next>
+    void btree<P>::bulk_fill(const bulk_level *levels, int level, size_type i,
+                             node_type *node, Next &next) {
+        const size_type items = levels[level].node_items(i);
+        if (level == 0) {
+            for (size_type j = 0; j < items; ++j) {
+                node->value_init(j, mutable_allocator(), next());
+                node->set_count(static_cast<typename node_type::field_type>(j + 1));
+            }
+            return;
+        }
+        const size_type first = levels[level].first_item(i);
+        for (size_type j = 0; j < items; ++j) {
+            node_type *child =
+                level == 1 ? new_leaf_node(node) : new_internal_node(node);
+            if (j != 0) {
+                // The delimiter between child j - 1 and child j.
+                PHMAP_INTERNAL_TRY {
+                    node->value_init(j - 1, mutable_allocator(), next());
+                }
+                PHMAP_INTERNAL_CATCH_ANY {
+                    level == 1 ? delete_leaf_node(child) : delete_internal_node(child);
+                    PHMAP_INTERNAL_RETHROW;
+                }
+            }
+            node->init_child(static_cast<int>(j), child);
+            node->set_count(static_cast<typename node_type::field_type>(j));
+            bulk_fill(levels, level - 1, first + j, child, next);
+        }
+    }
+
+    template <typename P>
+    template <typename ForwardIterator>
+    void btree<P>::bulk_load_sorted(ForwardIterator b, ForwardIterator e) {
+        // Returns the position after the run of keys equal to *it (after it for
+        // multi containers).
+        auto skip = [&](ForwardIterator it) {
+            ForwardIterator cur = it;
+            ++it;
+            if (!params_type::is_multi_container::value) {
+                while (it != e &&
+                       !compare_keys(params_type::key(*cur), params_type::key(*it))) {
+                    ++it;
+                }
+            }
+            return it;
+        };
+        size_type n = 0;
+        for (ForwardIterator it = b, prev = b; it != e; prev = it, it = skip(it)) {
+            // The range must be sorted.
+            assert(n == 0 ||
+                   !compare_keys(params_type::key(*it), params_type::key(*prev)));
+            ++n;
+        }
+        auto next = [&]() -> decltype(*b) {
+            ForwardIterator cur = b;
+            b = skip(b);
+            return *cur;
+        };
+        bulk_load(n, next);
+    }
+
+    template <typename P>
+    template <typename Btree>
+    void btree<P>::bulk_load_merged(Btree *x, Btree *y) {
+        static_assert(std::is_same<btree, Btree>::value ||
+                      std::is_same<const btree, Btree>::value,
+                      "Btree type must be same or const.");
+        constexpr bool multi = params_type::is_multi_container::value;
+        size_type n = x->size() + y->size();
+        auto i = x->begin();
+        auto j = y->begin();
+        if (!multi) {
+            while (i != x->end() && j != y->end()) {
+                if (compare_keys(i.key(), j.key())) {
+                    ++i;
+                } else if (compare_keys(j.key(), i.key())) {
+                    ++j;
+                } else {
+                    --n;
+                    ++i;
+                    ++j;
+                }
+            }
+            i = x->begin();
+            j = y->begin();
+        }
+        auto next = [&]() -> decltype(maybe_move_from_iterator(i)) {
+            if (j == y->end() || (i != x->end() && !compare_keys(j.key(), i.key()))) {
+                if (!multi && j != y->end() && !compare_keys(i.key(), j.key())) ++j;
+                return maybe_move_from_iterator(i++);
+            }
+            return maybe_move_from_iterator(j++);
+        };
+        bulk_load(n, next);
+    }
+
     template <typename P>
     constexpr bool btree<P>::static_assert_validation() {
         static_assert(std::is_nothrow_copy_constructible<key_compare>::value,
@@ -3420,6 +3607,28 @@ namespace priv {
         }
 
     protected:
+        // Builders behind from_sorted() and merge_sorted() of the final
+        // containers. An rvalue range hands its values over.
+        template <typename Container, typename Range>
+        static Container from_sorted_range(Range &&range, const key_compare &comp,
+                                           const allocator_type &alloc) {
+            Container c(comp, alloc);
+            if constexpr (std::is_rvalue_reference<Range &&>::value) {
+                c.tree_.bulk_load_sorted(std::make_move_iterator(std::begin(range)),
+                                         std::make_move_iterator(std::end(range)));
+            } else {
+                c.tree_.bulk_load_sorted(std::begin(range), std::end(range));
+            }
+            return c;
+        }
+        // Values are copied from const containers and moved from the others.
+        template <typename Container, typename Source>
+        static Container merge_sorted_containers(Source &x, Source &y) {
+            Container c(x.key_comp(), x.get_allocator());
+            c.tree_.bulk_load_merged(&x.tree_, &y.tree_);
+            return c;
+        }
+
         Tree tree_;
     };
 
@@ -3863,6 +4072,22 @@ namespace priv {
         using Base::get_allocator;
         using Base::key_comp;
         using Base::value_comp;
+
+        // Builds the set from a sorted range in O(n), the first of equal keys is kept.
+        // Leaves are packed full, see btree::bulk_load().
+        template <typename Range>
+        static btree_set from_sorted(Range &&range,
+                                     const typename Base::key_compare &comp = typename Base::key_compare(),
+                                     const typename Base::allocator_type &alloc = typename Base::allocator_type()) {
+            return Base::template from_sorted_range<btree_set>(std::forward<Range>(range), comp, alloc);
+        }
+        // Merges x and y into a new set in O(n + m), keys of x win over equal keys of y.
+        static btree_set merge_sorted(const btree_set &x, const btree_set &y) {
+            return Base::template merge_sorted_containers<btree_set>(x, y);
+        }
+        static btree_set merge_sorted(btree_set &&x, btree_set &&y) {
+            return Base::template merge_sorted_containers<btree_set>(x, y);
+        }
     };
 
     // Swaps the contents of two `phmap::btree_set` containers.
@@ -3922,6 +4147,22 @@ namespace priv {
         using Base::get_allocator;
         using Base::key_comp;
         using Base::value_comp;
+
+        // Builds the multiset from a sorted range in O(n).
+        // Leaves are packed full, see btree::bulk_load().
+        template <typename Range>
+        static btree_multiset from_sorted(Range &&range,
+                                          const typename Base::key_compare &comp = typename Base::key_compare(),
+                                          const typename Base::allocator_type &alloc = typename Base::allocator_type()) {
+            return Base::template from_sorted_range<btree_multiset>(std::forward<Range>(range), comp, alloc);
+        }
+        // Merges x and y into a new multiset in O(n + m), values of x come before equal values of y.
+        static btree_multiset merge_sorted(const btree_multiset &x, const btree_multiset &y) {
+            return Base::template merge_sorted_containers<btree_multiset>(x, y);
+        }
+        static btree_multiset merge_sorted(btree_multiset &&x, btree_multiset &&y) {
+            return Base::template merge_sorted_containers<btree_multiset>(x, y);
+        }
     };
 
     // Swaps the contents of two `phmap::btree_multiset` containers.
@@ -3985,6 +4226,22 @@ namespace priv {
         using Base::get_allocator;
         using Base::key_comp;
         using Base::value_comp;
+
+        // Builds the map from a sorted range in O(n), the first of equal keys is kept.
+        // Leaves are packed full, see btree::bulk_load().
+        template <typename Range>
+        static btree_map from_sorted(Range &&range,
+                                     const typename Base::key_compare &comp = typename Base::key_compare(),
+                                     const typename Base::allocator_type &alloc = typename Base::allocator_type()) {
+            return Base::template from_sorted_range<btree_map>(std::forward<Range>(range), comp, alloc);
+        }
+        // Merges x and y into a new map in O(n + m), keys of x win over equal keys of y.
+        static btree_map merge_sorted(const btree_map &x, const btree_map &y) {
+            return Base::template merge_sorted_containers<btree_map>(x, y);
+        }
+        static btree_map merge_sorted(btree_map &&x, btree_map &&y) {
+            return Base::template merge_sorted_containers<btree_map>(x, y);
+        }
     };
 
     // Swaps the contents of two `phmap::btree_map` containers.
@@ -4043,6 +4300,22 @@ namespace priv {
         using Base::get_allocator;
         using Base::key_comp;
         using Base::value_comp;
+
+        // Builds the multimap from a sorted range in O(n).
+        // Leaves are packed full, see btree::bulk_load().
+        template <typename Range>
+        static btree_multimap from_sorted(Range &&range,
+                                          const typename Base::key_compare &comp = typename Base::key_compare(),
+                                          const typename Base::allocator_type &alloc = typename Base::allocator_type()) {
+            return Base::template from_sorted_range<btree_multimap>(std::forward<Range>(range), comp, alloc);
+        }
+        // Merges x and y into a new multimap in O(n + m), values of x come before equal values of y.
+        static btree_multimap merge_sorted(const btree_multimap &x, const btree_multimap &y) {
+            return Base::template merge_sorted_containers<btree_multimap>(x, y);
+        }
+        static btree_multimap merge_sorted(btree_multimap &&x, btree_multimap &&y) {
+            return Base::template merge_sorted_containers<btree_multimap>(x, y);
+        }
     };
 
     // Swaps the contents of two `phmap::btree_multimap` containers.
@@ -0,0 +1,111 @@
+// Allocation profiling: counting allocators and memory resources that attribute heap use to a subsystem
+#ifndef BELA_ALLOC_STATS_HPP
+#define BELA_ALLOC_STATS_HPP
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <memory>
+#include <string_view>
+#include <vector>
+
+namespace bela::alloc_stats {
+// Tag names the subsystem an allocation is charged to. Tags are constant initialized and live as long as the program:
+//
+//  constinit bela::alloc_stats::Tag zipTag{"hazel.zip"};
+//  bela::alloc_stats::CountingResource resource(zipTag);
+//  hazel::zip::Reader zr(&resource);
+//  ...
+//  for (const auto &s : bela::alloc_stats::Collect()) {
+//    bela::FPrintF(stderr, L"%s: %d allocations, %d bytes, peak %d\n", s.name, s.allocations, s.bytes, s.peak);
+//  }
+//
+// Every thread counts into its own slots without locks, the live and peak bytes of a tag are shared atomics so they
+// stay exact when memory is freed on another thread than the one that allocated it.
+struct Tag {
+  constexpr Tag(const char *name_) : name(name_) {}
+  Tag(const Tag &) = delete;
+  Tag &operator=(const Tag &) = delete;
+  const char *name;
+  std::atomic<int64_t> live{0};
+  std::atomic<int64_t> peak{0};
+  std::atomic<uint32_t> id{0};
+};
+// maxTags tags get per thread counts, later tags only track live and peak bytes
+constexpr size_t maxTags = 64;
+
+void RecordAllocate(Tag &tag, size_t bytes);
+void RecordDeallocate(Tag &tag, size_t bytes);
+
+// Stats of one tag. In a thread report live and peak are the bytes allocated minus freed by that thread, in Collect
+// they are the exact process wide values of the tag.
+struct Stats {
+  std::string_view name;
+  uint64_t allocations{0};
+  uint64_t deallocations{0};
+  uint64_t bytes{0}; // total bytes allocated
+  int64_t live{0};
+  int64_t peak{0};
+};
+
+// ThreadReport returns the stats of the calling thread, Collect the sum over every thread; both sorted by name
+std::vector<Stats> ThreadReport();
+std::vector<Stats> Collect();
+// Reset clears the per thread counts and the peaks, live bytes are kept since the memory is still allocated. No thread
+// may allocate through a tag concurrently.
+void Reset();
+
+// CountingResource forwards to an upstream resource and charges every allocation to a tag. Pass it to pmr containers
+// or to the parsers that take a std::pmr::memory_resource.
+class CountingResource : public std::pmr::memory_resource {
+public:
+  explicit CountingResource(Tag &tag_, std::pmr::memory_resource *upstream_ = std::pmr::get_default_resource())
+      : tag(&tag_), upstream(upstream_) {}
+  CountingResource(const CountingResource &) = delete;
+  CountingResource &operator=(const CountingResource &) = delete;
+  std::pmr::memory_resource *Upstream() const { return upstream; }
+
+private:
+  void *do_allocate(size_t bytes, size_t alignment) override {
+    auto *p = upstream->allocate(bytes, alignment);
+    RecordAllocate(*tag, bytes);
+    return p;
+  }
+  void do_deallocate(void *p, size_t bytes, size_t alignment) override {
+    RecordDeallocate(*tag, bytes);
+    upstream->deallocate(p, bytes, alignment);
+  }
+  bool do_is_equal(const std::pmr::memory_resource &other) const noexcept override { return this == &other; }
+  Tag *tag;
+  std::pmr::memory_resource *upstream;
+};
+
+// CountingAllocator is a std::allocator that charges every allocation to a tag, for containers with a fixed allocator
+// type:
+//
+//  std::vector<Symbol, bela::alloc_stats::CountingAllocator<Symbol>> syms(elfTag);
+template <typename T> class CountingAllocator {
+public:
+  using value_type = T;
+  CountingAllocator(Tag &tag_) noexcept : tag(&tag_) {}
+  template <typename U> CountingAllocator(const CountingAllocator<U> &other) noexcept : tag(other.GetTag()) {}
+  T *allocate(size_t n) {
+    auto *p = std::allocator<T>{}.allocate(n);
+    RecordAllocate(*tag, n * sizeof(T));
+    return p;
+  }
+  void deallocate(T *p, size_t n) noexcept {
+    RecordDeallocate(*tag, n * sizeof(T));
+    std::allocator<T>{}.deallocate(p, n);
+  }
+  Tag *GetTag() const noexcept { return tag; }
+  template <typename U> bool operator==(const CountingAllocator<U> &other) const noexcept {
+    return tag == other.GetTag();
+  }
+
+private:
+  Tag *tag;
+};
+} // namespace bela::alloc_stats
+
+#endif
@@ -0,0 +1,152 @@
+// Awaitable file reads, process exit and timers for bela::Task
+#ifndef BELA_ASYNC_HPP
+#define BELA_ASYNC_HPP
+#include <chrono>
+#include <coroutine>
+#include <span>
+#include "base.hpp"
+#include "io.hpp"
+#include "task.hpp"
+
+namespace bela {
+namespace async_internal {
+// operation is one pending system operation, its completion callback runs on the system thread pool and hands the
+// coroutine to a bela pool, so the code after co_await never runs on a system I/O thread
+struct operation {
+  void Resume() { pool->Submit([h = continuation] { h.resume(); }); }
+  ThreadPool *pool{nullptr};
+  std::coroutine_handle<> continuation;
+};
+
+// overlapped_operation is passed to the kernel as the OVERLAPPED of a read, the completion finds it from there
+struct overlapped_operation : OVERLAPPED, operation {
+  overlapped_operation() : OVERLAPPED{} {}
+  DWORD result{NO_ERROR};
+  DWORD bytes{0};
+};
+} // namespace async_internal
+
+namespace io {
+// AsyncFile reads a file with overlapped I/O bound to the system thread pool: a read does not occupy a thread while it
+// is pending, many reads can be in flight at once and each coroutine continues on the bela pool when its read
+// completes. Reads that the cache satisfies immediately complete without suspending.
+//
+//  bela::Task<bool> Parse(bela::io::AsyncFile &file, bela::error_code &ec) {
+//    std::vector<uint8_t> buffer(64 * 1024);
+//    int64_t n = 0;
+//    if (!co_await file.ReadAt(buffer, 0, n, ec)) {
+//      co_return false;
+//    }
+//    ...
+//  }
+class AsyncFile {
+private:
+  class read_awaiter : async_internal::overlapped_operation {
+  public:
+    read_awaiter(const AsyncFile *file_, std::span<uint8_t> buffer_, int64_t pos_, int64_t &outlen_,
+                 bela::error_code &ec_)
+        : file(file_), buffer(buffer_), pos(pos_), outlen(outlen_), ec(ec_) {
+      pool = file->pool;
+    }
+    bool await_ready() noexcept { return false; }
+    bool await_suspend(std::coroutine_handle<> h);
+    bool await_resume();
+
+  private:
+    friend class AsyncFile;
+    const AsyncFile *file;
+    std::span<uint8_t> buffer;
+    int64_t pos;
+    int64_t &outlen;
+    bela::error_code &ec;
+  };
+  void Free();
+  void MoveFrom(AsyncFile &&o);
+
+public:
+  AsyncFile() = default;
+  AsyncFile(const AsyncFile &) = delete;
+  AsyncFile &operator=(const AsyncFile &) = delete;
+  AsyncFile(AsyncFile &&o) { MoveFrom(std::move(o)); }
+  AsyncFile &operator=(AsyncFile &&o) {
+    MoveFrom(std::move(o));
+    return *this;
+  }
+  ~AsyncFile() { Free(); }
+  // Open opens file for reading, completed reads resume their coroutines on pool
+  bool Open(std::wstring_view file, bela::error_code &ec, ThreadPool &pool_ = ThreadPool::Default());
+  // Close cancels pending reads, they complete with ERROR_OPERATION_ABORTED
+  void Close() { Free(); }
+  explicit operator bool() const { return fd != INVALID_HANDLE_VALUE; }
+  HANDLE NativeFD() const { return fd; }
+  int64_t Size(bela::error_code &ec) const { return bela::io::Size(fd, ec); }
+  // ReadAt reads up to buffer.size() bytes starting at offset pos, co_await returns false on error. 0 <= outlen <=
+  // buffer.size(), outlen is 0 at the end of the file. buffer, outlen and ec must stay valid until the read completed.
+  [[nodiscard]] read_awaiter ReadAt(std::span<uint8_t> buffer, int64_t pos, int64_t &outlen,
+                                    bela::error_code &ec) const {
+    return read_awaiter(this, buffer, pos, outlen, ec);
+  }
+
+private:
+  HANDLE fd{INVALID_HANDLE_VALUE};
+  PTP_IO io{nullptr};
+  ThreadPool *pool{nullptr};
+  // reads completed synchronously do not queue a completion
+  bool skipOnSuccess{false};
+};
+} // namespace io
+
+namespace async_internal {
+class sleep_awaiter : operation {
+public:
+  sleep_awaiter(int64_t ticks_, ThreadPool &pool_) : ticks(ticks_) { pool = &pool_; }
+  bool await_ready() noexcept { return ticks <= 0; }
+  void await_suspend(std::coroutine_handle<> h);
+  void await_resume() noexcept {}
+
+private:
+  static void CALLBACK OnTimer(PTP_CALLBACK_INSTANCE instance, PVOID context, PTP_TIMER timer);
+  int64_t ticks;
+};
+
+class exit_awaiter : operation {
+public:
+  exit_awaiter(HANDLE process_, DWORD &exitCode_, bela::error_code &ec_, ThreadPool &pool_)
+      : process(process_), exitCode(exitCode_), ec(ec_) {
+    pool = &pool_;
+  }
+  bool await_ready() noexcept { return WaitForSingleObject(process, 0) == WAIT_OBJECT_0; }
+  bool await_suspend(std::coroutine_handle<> h);
+  bool await_resume();
+
+private:
+  static void CALLBACK OnExit(PTP_CALLBACK_INSTANCE instance, PVOID context, PTP_WAIT wait, TP_WAIT_RESULT result);
+  HANDLE process;
+  DWORD &exitCode;
+  bela::error_code &ec;
+  DWORD result{NO_ERROR};
+};
+} // namespace async_internal
+
+// SleepFor suspends the calling coroutine for at least d without blocking a thread, it continues on pool:
+// co_await bela::SleepFor(std::chrono::milliseconds(100))
+template <typename Rep, typename Period>
+[[nodiscard]] async_internal::sleep_awaiter SleepFor(std::chrono::duration<Rep, Period> d,
+                                                     ThreadPool &pool = ThreadPool::Default()) {
+  // timer due times are in 100 nanosecond ticks, round up so the coroutine never wakes early
+  using ticks_t = std::chrono::duration<int64_t, std::ratio<1, 10'000'000>>;
+  return async_internal::sleep_awaiter(std::chrono::ceil<ticks_t>(d).count(), pool);
+}
+
+namespace process {
+// WaitExit suspends the calling coroutine until process exits and stores its exit code, co_await returns false on
+// error. process needs SYNCHRONIZE and PROCESS_QUERY_LIMITED_INFORMATION access and must stay open until the wait
+// completed, the coroutine continues on pool.
+[[nodiscard]] inline async_internal::exit_awaiter WaitExit(HANDLE process, DWORD &exitCode, bela::error_code &ec,
+                                                           ThreadPool &pool = ThreadPool::Default()) {
+  return async_internal::exit_awaiter(process, exitCode, ec, pool);
+}
+} // namespace process
+} // namespace bela
+
+#endif
@@ -0,0 +1,50 @@
+// Bela batched file header reader
+#ifndef BELA_BATCH_READER_HPP
+#define BELA_BATCH_READER_HPP
+#include <functional>
+#include <span>
+#include "base.hpp"
+#include "bytes_view.hpp"
+
+namespace bela::io {
+// BatchCompletion describes one finished read. data points into a buffer owned by the BatchReader and is only valid
+// during the callback.
+struct BatchCompletion {
+  size_t index{0};                         // index of file in the submitted span
+  int64_t size{bela::SizeUnInitialized};   // file size, SizeUnInitialized when open failed
+  bela::bytes_view data;                   // bytes read at offset, may be shorter than the slot buffer
+  const bela::error_code &ec;              // per-file error
+};
+
+using batch_callback_t = std::function<void(const BatchCompletion &)>;
+
+// BatchReader reads the leading bytes (or bytes at a fixed offset) of many files. Opening is spread over a small set of
+// submitter threads, reads are issued as overlapped I/O against one completion port and completions are drained in
+// batches with GetQueuedCompletionStatusEx on the calling thread, so the callback (e.g. hazel::LookupBytes) overlaps
+// with outstanding I/O. All buffers are allocated once in the constructor.
+class BatchReader {
+public:
+  // bufferSize: bytes read per file; depth: maximum number of in-flight reads; concurrency: submitter threads, 0 means
+  // derived from the number of processors.
+  BatchReader(size_t bufferSize = 4096, size_t depth = 64, size_t concurrency = 0);
+  BatchReader(const BatchReader &) = delete;
+  BatchReader &operator=(const BatchReader &) = delete;
+  ~BatchReader();
+  // Read reads every file and calls fn once per file, in completion order, on the calling thread. Per-file failures are
+  // reported through BatchCompletion::ec; Read only fails when the completion port cannot be used.
+  bool Read(std::span<const std::wstring> files, const batch_callback_t &fn, bela::error_code &ec, int64_t offset = 0);
+  size_t BufferSize() const { return bufferSize; }
+  size_t Depth() const { return depth; }
+
+private:
+  struct Slot;
+  size_t bufferSize{0};
+  size_t depth{0};
+  size_t concurrency{0};
+  std::vector<uint8_t> arena;
+  std::vector<Slot> slots;
+};
+
+} // namespace bela::io
+
+#endif
@@ -4,8 +4,11 @@
 #include "__phmap/btree.h"
 
 namespace bela {
+// The btree containers also build from sorted input in O(n) with from_sorted(range) and merge two containers in
+// linear time with merge_sorted(x, y), both pack leaves full instead of splitting nodes like repeated inserts.
 using phmap::btree_map;
 using phmap::btree_multimap;
+using phmap::btree_multiset;
 using phmap::btree_set;
 } // namespace bela
 
@@ -0,0 +1,254 @@
+// Sharded concurrent cache built on parallel_flat_hash_map
+#ifndef BELA_CONCURRENT_CACHE_HPP
+#define BELA_CONCURRENT_CACHE_HPP
+#include <array>
+#include <future>
+#include <mutex>
+#include <optional>
+#include <vector>
+#include "phmap.hpp"
+
+namespace bela {
+struct cache_stats {
+  uint64_t hits{0};
+  uint64_t misses{0};
+  // loader runs: misses that joined a load already in flight are not counted
+  uint64_t loads{0};
+  uint64_t evictions{0};
+};
+
+// ConcurrentCache is a bounded key/value cache for many threads. Entries live in a parallel_flat_hash_map with 2^N
+// submaps, each guarded by its own mutex; a key only ever locks its submap, so there is no global lock. Every submap
+// holds about maxSize/2^N entries and evicts with CLOCK: a hit marks the entry referenced, the hand clears marks and
+// evicts the first unmarked entry. New entries start unmarked, so keys used once leave before keys used twice.
+//
+// GetOrLoad is single-flight: concurrent misses on one key run loader once, the other callers wait for its result (or
+// its exception, in which case nothing is cached). V is returned by copy, cache std::shared_ptr<const T> for large
+// values.
+template <typename K, typename V, typename Hash = phmap::Hash<K>, typename Eq = phmap::EqualTo<K>, size_t N = 6>
+class ConcurrentCache {
+public:
+  explicit ConcurrentCache(size_t maxSize)
+      : shardCapacity((std::max)((maxSize + shardCount - 1) / shardCount, static_cast<size_t>(1))) {}
+  ConcurrentCache(const ConcurrentCache &) = delete;
+  ConcurrentCache &operator=(const ConcurrentCache &) = delete;
+
+  // GetOrLoad returns the cached value for key, or the result of loader(key) which is then cached
+  template <typename Loader> V GetOrLoad(const K &key, Loader &&loader) {
+    std::optional<V> value;
+    std::shared_future<V> inflight;
+    std::optional<std::promise<V>> promise;
+    auto hashval = table.hash(key);
+    auto idx = table_t::subidx(hashval);
+    table.with_submap_m(idx, [&](auto &set) {
+      auto &s = shards[idx];
+      if (auto it = set.find(key, hashval); it != set.end()) {
+        auto &e = it->second;
+        if (e.value) {
+          s.stats.hits++;
+          e.referenced = true;
+          value = *e.value;
+          return;
+        }
+        s.stats.misses++;
+        inflight = e.inflight;
+        return;
+      }
+      s.stats.misses++;
+      s.stats.loads++;
+      promise.emplace();
+      entry e;
+      e.inflight = promise->get_future().share();
+      e.loader = &*promise;
+      Admit(set, s, key, hashval, std::move(e));
+    });
+    if (value) {
+      return std::move(*value);
+    }
+    if (!promise) {
+      return inflight.get();
+    }
+    try {
+      V loaded = loader(key);
+      table.with_submap_m(idx, [&](auto &set) {
+        // the entry may have been erased (or erased and loaded again by another caller) meanwhile
+        if (auto it = set.find(key, hashval); it != set.end() && it->second.loader == &*promise) {
+          auto &e = it->second;
+          e.value = loaded;
+          e.inflight = {};
+          e.loader = nullptr;
+        }
+      });
+      promise->set_value(loaded);
+      return loaded;
+    } catch (...) {
+      table.with_submap_m(idx, [&](auto &set) {
+        if (auto it = set.find(key, hashval); it != set.end() && it->second.loader == &*promise) {
+          Remove(set, shards[idx], it);
+        }
+      });
+      promise->set_exception(std::current_exception());
+      throw;
+    }
+  }
+
+  // Get returns the cached value, it does not wait for a load in flight
+  std::optional<V> Get(const K &key) {
+    std::optional<V> value;
+    WithShard(key, [&](auto &set, shard &s, size_t hashval) {
+      auto it = set.find(key, hashval);
+      if (it == set.end() || !it->second.value) {
+        s.stats.misses++;
+        return;
+      }
+      s.stats.hits++;
+      it->second.referenced = true;
+      value = *it->second.value;
+    });
+    return value;
+  }
+
+  // Put inserts or replaces the value of key
+  void Put(const K &key, V value) {
+    WithShard(key, [&](auto &set, shard &s, size_t hashval) {
+      if (auto it = set.find(key, hashval); it != set.end()) {
+        it->second.value = std::move(value);
+        return;
+      }
+      entry e;
+      e.value = std::move(value);
+      Admit(set, s, key, hashval, std::move(e));
+    });
+  }
+
+  bool Erase(const K &key) {
+    bool erased = false;
+    WithShard(key, [&](auto &set, shard &s, size_t hashval) {
+      if (auto it = set.find(key, hashval); it != set.end()) {
+        Remove(set, s, it);
+        erased = true;
+      }
+    });
+    return erased;
+  }
+
+  void Clear() {
+    for (size_t i = 0; i < shardCount; i++) {
+      table.with_submap_m(i, [&](auto &set) {
+        set.clear();
+        auto &s = shards[i];
+        s.ring.clear();
+        s.freeSlots.clear();
+        s.hand = 0;
+      });
+    }
+  }
+
+  size_t Size() const { return table.size(); }
+  size_t Capacity() const { return shardCapacity * shardCount; }
+
+  cache_stats Stats() {
+    cache_stats total;
+    for (size_t i = 0; i < shardCount; i++) {
+      table.with_submap_m(i, [&](auto &) {
+        auto &s = shards[i].stats;
+        total.hits += s.hits;
+        total.misses += s.misses;
+        total.loads += s.loads;
+        total.evictions += s.evictions;
+      });
+    }
+    return total;
+  }
+
+private:
+  static constexpr size_t shardCount = size_t{1} << N;
+  struct entry {
+    std::optional<V> value;
+    // set while the first caller runs the loader, identified by its promise
+    std::shared_future<V> inflight;
+    const void *loader{nullptr};
+    size_t slot{0};
+    bool referenced{false};
+  };
+  using map_t = phmap::parallel_flat_hash_map<K, entry, Hash, Eq,
+                                              phmap::priv::Allocator<phmap::priv::Pair<const K, entry>>, N, std::mutex>;
+  struct table_t : map_t {
+    using map_t::subidx;
+  };
+  struct ring_slot {
+    K key;
+    bool live{false};
+  };
+  // CLOCK state of one submap, guarded by the submap's mutex
+  struct alignas(64) shard {
+    std::vector<ring_slot> ring;
+    std::vector<size_t> freeSlots;
+    size_t hand{0};
+    cache_stats stats;
+  };
+
+  template <typename Fn> void WithShard(const K &key, Fn fn) {
+    auto hashval = table.hash(key);
+    auto idx = table_t::subidx(hashval);
+    table.with_submap_m(idx, [&](auto &set) { fn(set, shards[idx], hashval); });
+  }
+
+  template <typename Set> void Admit(Set &set, shard &s, const K &key, size_t hashval, entry &&e) {
+    size_t slot = 0;
+    if (!s.freeSlots.empty()) {
+      slot = s.freeSlots.back();
+      s.freeSlots.pop_back();
+    } else if (s.ring.size() < shardCapacity) {
+      slot = s.ring.size();
+      s.ring.emplace_back();
+    } else {
+      slot = Evict(set, s);
+    }
+    s.ring[slot].key = key;
+    s.ring[slot].live = true;
+    e.slot = slot;
+    set.emplace_with_hash(hashval, std::piecewise_construct, std::forward_as_tuple(key),
+                          std::forward_as_tuple(std::move(e)));
+  }
+
+  // Evict frees a ring slot. Loads in flight are never evicted; when every entry is loading the shard grows instead.
+  template <typename Set> size_t Evict(Set &set, shard &s) {
+    for (size_t n = 0; n < 2 * s.ring.size(); n++) {
+      auto h = s.hand;
+      s.hand = (s.hand + 1) % s.ring.size();
+      auto &rs = s.ring[h];
+      auto it = set.find(rs.key);
+      if (!rs.live || it == set.end()) {
+        return h;
+      }
+      auto &e = it->second;
+      if (!e.value) {
+        continue;
+      }
+      if (e.referenced) {
+        e.referenced = false;
+        continue;
+      }
+      set._erase(it);
+      rs.live = false;
+      s.stats.evictions++;
+      return h;
+    }
+    s.ring.emplace_back();
+    return s.ring.size() - 1;
+  }
+
+  template <typename Set, typename Iterator> void Remove(Set &set, shard &s, Iterator it) {
+    s.ring[it->second.slot].live = false;
+    s.freeSlots.emplace_back(it->second.slot);
+    set._erase(it);
+  }
+
+  table_t table;
+  std::array<shard, shardCount> shards;
+  const size_t shardCapacity;
+};
+} // namespace bela
+
+#endif
@@ -0,0 +1,140 @@
+// Runtime CPU feature detection and kernel dispatch
+#ifndef BELA_CPU_HPP
+#define BELA_CPU_HPP
+#include <array>
+#include <atomic>
+#include <cassert>
+#include <cstdint>
+#include <initializer_list>
+#include <string>
+#include <string_view>
+
+// BELA_TARGET marks a function that may use instructions beyond the compilation baseline, GCC and Clang refuse to
+// inline intrinsics into functions without it. MSVC accepts intrinsics anywhere. Such a function must only be reached
+// through a dispatcher that checked the features first.
+#if defined(__GNUC__) || defined(__clang__)
+#define BELA_TARGET(features) __attribute__((target(features)))
+#else
+#define BELA_TARGET(features)
+#endif
+
+namespace bela::cpu {
+// Feature is one instruction set extension, values are bits so a kernel can require several
+enum Feature : uint64_t {
+  SSE2 = 1ULL << 0,
+  SSSE3 = 1ULL << 1,
+  SSE41 = 1ULL << 2,
+  SSE42 = 1ULL << 3,
+  POPCNT = 1ULL << 4,
+  AVX = 1ULL << 5,
+  AVX2 = 1ULL << 6,
+  FMA = 1ULL << 7,
+  BMI1 = 1ULL << 8,
+  BMI2 = 1ULL << 9,
+  AVX512F = 1ULL << 10,
+  AVX512BW = 1ULL << 11,
+  AVX512VL = 1ULL << 12,
+  SHA = 1ULL << 13,    // SHA-1 and SHA-256 instructions
+  PCLMUL = 1ULL << 14, // carry-less multiply: PCLMULQDQ on x86, PMULL on ARM
+  AES = 1ULL << 15,
+  NEON = 1ULL << 16,
+  CRC32 = 1ULL << 17, // ARMv8 CRC32 instructions, SSE4.2 covers CRC32C on x86
+};
+
+// Features returns the features of the running CPU, detected on first use. AVX and AVX-512 are only reported when the
+// operating system saves their registers.
+uint64_t Features();
+inline bool Has(uint64_t required) { return (Features() & required) == required; }
+// FeatureNames lists the names of the features in mask, for logs and test output: "sse2 ssse3 avx2"
+std::string FeatureNames(uint64_t mask);
+
+#if defined(_M_X64) || defined(__x86_64__) || defined(_M_IX86) || defined(__i386__)
+// CPUID executes the cpuid instruction, regs receives eax, ebx, ecx and edx
+void CPUID(uint32_t leaf, uint32_t subleaf, uint32_t regs[4]);
+#endif
+
+// Kernel is one implementation of an operation and the features it needs, a kernel that needs nothing is the portable
+// fallback
+template <typename Fn> struct Kernel {
+  uint64_t required{0};
+  Fn *fn{nullptr};
+  std::string_view name;
+};
+
+// Dispatcher holds the implementations of one operation, best first, and calls the first one the CPU supports. The
+// choice is made on the first call and cached in an atomic function pointer, later calls cost one indirect call.
+// Dispatchers are constant initialized, so they can be used from static initializers of other translation units.
+//
+//  constinit bela::cpu::Dispatcher<size_t(const char *, size_t)> countLines{
+//      {bela::cpu::AVX2, CountLinesAVX2, "avx2"},
+//      {bela::cpu::SSE2, CountLinesSSE2, "sse2"},
+//      {0, CountLinesPortable, "portable"},
+//  };
+//  auto n = countLines(data, size);
+//
+// Tests force an implementation with Override, or run every supported one through Kernels.
+template <typename Fn> class Dispatcher;
+template <typename R, typename... Args> class Dispatcher<R(Args...)> {
+public:
+  using function_type = R(Args...);
+  static constexpr size_t maxKernels = 8;
+  constexpr Dispatcher(std::initializer_list<Kernel<function_type>> kernels_) {
+    assert(kernels_.size() <= maxKernels && kernels_.size() != 0);
+    for (const auto &k : kernels_) {
+      if (size < maxKernels) {
+        kernels[size++] = k;
+      }
+    }
+  }
+  Dispatcher(const Dispatcher &) = delete;
+  Dispatcher &operator=(const Dispatcher &) = delete;
+
+  R operator()(Args... args) const { return Get()(static_cast<Args>(args)...); }
+  // Get returns the selected implementation
+  function_type *Get() const {
+    if (auto *fn = resolved.load(std::memory_order_acquire); fn != nullptr) {
+      return fn;
+    }
+    // racing threads select the same kernel
+    auto *fn = Select(Features());
+    resolved.store(fn, std::memory_order_release);
+    return fn;
+  }
+  // Select returns the best implementation for a CPU with the given features
+  function_type *Select(uint64_t features) const {
+    for (size_t i = 0; i < size; i++) {
+      if ((features & kernels[i].required) == kernels[i].required) {
+        return kernels[i].fn;
+      }
+    }
+    return kernels[size - 1].fn;
+  }
+  // Name returns the name of the selected implementation
+  std::string_view Name() const {
+    auto *fn = Get();
+    for (size_t i = 0; i < size; i++) {
+      if (kernels[i].fn == fn) {
+        return kernels[i].name;
+      }
+    }
+    return "override";
+  }
+  // Override replaces the selected implementation, nullptr selects again from the CPU features
+  void Override(function_type *fn) { resolved.store(fn, std::memory_order_release); }
+  // Kernels calls visitor(kernel) for every implementation the running CPU supports
+  template <typename Visitor> void Kernels(Visitor &&visitor) const {
+    for (size_t i = 0; i < size; i++) {
+      if (Has(kernels[i].required)) {
+        visitor(kernels[i]);
+      }
+    }
+  }
+
+private:
+  std::array<Kernel<function_type>, maxKernels> kernels{};
+  size_t size{0};
+  mutable std::atomic<function_type *> resolved{nullptr};
+};
+} // namespace bela::cpu
+
+#endif
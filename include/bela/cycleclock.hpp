@@ -0,0 +1,42 @@
+// CPU cycle counter clock
+#ifndef BELA_CYCLECLOCK_HPP
+#define BELA_CYCLECLOCK_HPP
+#include <intrin.h>
+#include "time.hpp"
+
+namespace bela {
+// CycleClock reads the processor's timestamp counter (RDTSC on x86, CNTVCT_EL0 on ARM64). A read is a single
+// instruction and does not serialize, so it is the cheapest way to timestamp hot paths; convert differences of two
+// reads with ToDuration(). The frequency is calibrated once against MonotonicNow() on first use (about 10ms) unless the
+// architecture reports it. Readings are only comparable across cores when Invariant() is true, otherwise use
+// bela::MonotonicNow().
+class CycleClock {
+public:
+  CycleClock() = delete;
+  static int64_t Now() {
+#if defined(_M_X64) || defined(__x86_64__) || defined(_M_IX86) || defined(__i386__)
+    return static_cast<int64_t>(__rdtsc());
+#elif defined(_M_ARM64) || defined(_M_ARM64EC)
+    return static_cast<int64_t>(_ReadStatusReg(ARM64_SYSREG(3, 3, 14, 0, 2))); // CNTVCT_EL0
+#elif defined(__aarch64__)
+    int64_t v;
+    asm volatile("mrs %0, cntvct_el0" : "=r"(v));
+    return v;
+#else
+    return MonotonicCycles();
+#endif
+  }
+  // Frequency returns counter ticks per second
+  static int64_t Frequency();
+  // Invariant reports whether the counter runs at a constant rate on every core, across P- and C-states
+  static bool Invariant();
+  static bela::Duration ToDuration(int64_t cycles);
+  // Elapsed returns the duration since a previous Now() reading
+  static bela::Duration Elapsed(int64_t start) { return ToDuration(Now() - start); }
+
+private:
+  static int64_t MonotonicCycles();
+};
+} // namespace bela
+
+#endif
@@ -1,6 +1,7 @@
 // DATETIME
 #ifndef BELA_DATETIME_HPP
 #define BELA_DATETIME_HPP
+#include <span>
 #include "time.hpp"
 
 namespace bela {
@@ -53,21 +54,67 @@ constexpr std::int_least64_t daysSinceEpoch(std::int_least64_t Y) {
   return Y * 365 + Y / 4 - Y / 100 + Y / 400 - unixEpochDays;
 }
 
+// Civil date conversion from Cassio Neri and Lorenz Schneider, "Euclidean affine functions and their application to
+// calendar algorithms" (2022). Days and years are shifted by a whole number of 400-year cycles so that all arithmetic
+// is unsigned, then the year/month/day are obtained with multiplications and shifts instead of loops.
+constexpr uint64_t civilCycles = 14700000; // ~5.9 billion years, covers every year MakeDateTime accepts
+constexpr uint64_t civilDayShift = 719468 + 146097 * civilCycles;
+constexpr uint64_t civilYearShift = 400 * civilCycles;
+constexpr int64_t civilMinDays = -static_cast<int64_t>(civilDayShift);
+
+struct civil_day {
+  int64_t year;
+  int month;
+  int day;
+};
+
+// CivilFromDays: days since 1970-01-01 to proleptic Gregorian date. REQUIRES: days >= civilMinDays
+constexpr civil_day CivilFromDays(int64_t days) {
+  const auto n = static_cast<uint64_t>(days) + civilDayShift;
+  // century and day of century
+  const auto n1 = 4 * n + 3;
+  const auto c = n1 / 146097;
+  const auto nc = static_cast<uint32_t>(n1 % 146097) / 4;
+  // year of century and day of year (year starts on March 1st)
+  const auto n2 = 4 * static_cast<uint64_t>(nc) + 3;
+  const auto p2 = 2939745ULL * n2;
+  const auto z = static_cast<uint32_t>(p2 >> 32);
+  const auto ny = static_cast<uint32_t>(p2) / 2939745 / 4;
+  // month and day
+  const auto n3 = 2141 * ny + 197913;
+  const auto m = n3 >> 16;
+  const auto d = (n3 & 0xFFFF) / 2141;
+  const uint32_t j = ny >= 306 ? 1 : 0;
+  return civil_day{
+      .year = static_cast<int64_t>(100 * c + z + j - civilYearShift),
+      .month = static_cast<int>(m - 12 * j),
+      .day = static_cast<int>(d + 1),
+  };
+}
+
+// DaysFromCivil: proleptic Gregorian date to days since 1970-01-01, the date must be valid
+constexpr int64_t DaysFromCivil(int64_t y, int mon, int d) {
+  const uint32_t j = mon <= 2 ? 1 : 0;
+  const auto y1 = static_cast<uint64_t>(y) + civilYearShift - j;
+  const auto m1 = static_cast<uint32_t>(mon) + 12 * j;
+  const auto q1 = y1 / 100;
+  const auto yc = 1461 * y1 / 4 - q1 + q1 / 4;
+  const auto mc = (979 * m1 - 2919) / 32;
+  return static_cast<int64_t>(yc + mc + static_cast<uint32_t>(d - 1) - civilDayShift);
+}
+
+// days since Sunday - [0, 6], 1970-01-01 is Thursday
+constexpr int WeekdayFromDays(int64_t days) { return static_cast<int>((days % 7 + 11) % 7); }
+
 constexpr int64_t DaysSinceEpoch(std::int_least64_t y, std::int_least8_t mon, std::int_least8_t d) {
-  auto leapYear = IsLeapYear(y);
-  auto mondays = leapYear ? time_internal::LeapMonths[mon - 1] : time_internal::Months[mon - 1];
-  if (d < 1 || d > mondays) {
+  if (mon < 1 || mon > 12) {
     return 0;
   }
-  auto days = time_internal::daysSinceEpoch(y);
-  for (auto i = 1; i < mon; i++) {
-    days += time_internal::Months[i - 1];
-  }
-  if (mon > 2 && leapYear) {
-    days++;
+  auto mondays = IsLeapYear(y) ? time_internal::LeapMonths[mon - 1] : time_internal::Months[mon - 1];
+  if (d < 1 || d > mondays) {
+    return 0;
   }
-  days += d - 1;
-  return days;
+  return DaysFromCivil(y, mon, d);
 }
 
 std::wstring FormatDateTimeW(const DateTime &dt, bool nano);
@@ -78,12 +125,7 @@ std::string FormatDateTimeA(const DateTime &dt, bool nano);
 constexpr Weekday GetWeekday(std::int_least64_t y, std::int_least8_t mon, std::int_least8_t d) {
   // 1969-12-31 Wednesday -1 day
   // 1970-01-01 Thursday 0 day
-  auto days = time_internal::DaysSinceEpoch(y, mon, d);
-  auto wday = (days + 3 + 1) % 7;
-  if (wday < 0) {
-    wday += 7;
-  }
-  return static_cast<Weekday>(wday);
+  return static_cast<Weekday>(time_internal::WeekdayFromDays(time_internal::DaysSinceEpoch(y, mon, d)));
 }
 
 class DateTime {
@@ -133,6 +175,24 @@ template <> inline std::string DateTime::Format<char>(bool nano) const {
   return time_internal::FormatDateTimeA(*this, nano);
 }
 
+// DateTimeColumns receives UTC civil fields in struct-of-arrays layout for columnar exports. weekday and nsec may be
+// left empty when not needed, every other span must hold at least as many elements as the input.
+struct DateTimeColumns {
+  std::span<std::int_fast64_t> year;
+  std::span<std::int_least8_t> month;
+  std::span<std::int_least8_t> day;
+  std::span<std::int_least8_t> hour;
+  std::span<std::int_least8_t> minute;
+  std::span<std::int_least8_t> second;
+  std::span<std::int_least8_t> weekday;
+  std::span<std::int_least32_t> nsec;
+};
+
+// MakeDateTimes converts Unix seconds or bela::Time values to civil fields in bulk, returns false if a column is too
+// short. Values must be within the range accepted by DateTime.
+bool MakeDateTimes(std::span<const int64_t> seconds, const DateTimeColumns &out);
+bool MakeDateTimes(std::span<const bela::Time> times, const DateTimeColumns &out);
+
 std::int_least32_t TimeZoneOffset();
 
 inline bela::DateTime LocalDateTime(bela::Time t) {
@@ -154,6 +214,42 @@ template <typename CharT = wchar_t, typename Allocator = std::allocator<CharT>>
   return DateTime(t).Format<CharT>(nano);
 }
 
+// ParseRFC3339 parses "YYYY-MM-DDTHH:MM:SS[.fraction](Z|+hh:mm|-hh:mm)" directly into a bela::Time. 't' and ' ' are
+// accepted as date/time separator and 'z' as UTC designator; fractional digits beyond nanoseconds are truncated.
+bool ParseRFC3339(std::string_view sv, bela::Time *t);
+bool ParseRFC3339(std::wstring_view sv, bela::Time *t);
+
+// TimestampFormatter writes RFC3339 timestamps with a fixed number of fractional digits into caller-provided buffers
+// without allocating. The "YYYY-MM-DDTHH:MM:SS" prefix is cached per second so consecutive stamps within one second
+// only format the fraction. An instance is not thread-safe; use one per thread (see FormatTimestamp).
+class TimestampFormatter {
+public:
+  // enough for a 12-digit year with sign, 9 fractional digits and "+hh:mm"
+  static constexpr size_t MaxLength = sizeof("-292277022657-01-27T08:29:52.999999999+08:00") - 1;
+  // tz: same convention as DateTime::TimeZoneOffset(); digits: fractional second digits [0, 9]
+  explicit TimestampFormatter(std::int_least32_t tz = 0, int digits = 9) noexcept;
+  // Format returns the number of characters written (no terminating zero), or 0 when buffer is too small
+  size_t Format(bela::Time t, std::span<char> buffer) noexcept;
+  size_t Format(bela::Time t, std::span<wchar_t> buffer) noexcept;
+  constexpr auto TimeZoneOffset() const noexcept { return tzoffset; }
+
+private:
+  void Refresh(int64_t sec) noexcept;
+  template <typename CharT> size_t FormatInternal(bela::Time t, std::span<CharT> buffer) noexcept;
+  int64_t cached{(std::numeric_limits<int64_t>::min)()};
+  std::int_least32_t tzoffset{0};
+  int digits{9};
+  uint32_t divisor{1};
+  uint8_t prefixLength{0};
+  uint8_t suffixLength{0};
+  char prefix[32];
+  char suffix[8];
+};
+
+// FormatTimestamp formats t as UTC with nanoseconds using a thread local TimestampFormatter
+size_t FormatTimestamp(bela::Time t, std::span<char> buffer) noexcept;
+size_t FormatTimestamp(bela::Time t, std::span<wchar_t> buffer) noexcept;
+
 std::wstring_view WeekdayName(Weekday wd, bool shortname = true) noexcept;
 std::wstring_view MonthName(Month mon, bool shortname = true) noexcept;
 } // namespace bela
@@ -3,6 +3,8 @@
 #define BELA_FS_HPP
 #include "base.hpp"
 #include "str_cat.hpp"
+#include "__fs/remove_tree_internal.hpp"
+#include "__fs/walker_internal.hpp"
 #include <stdio.h>
 
 namespace bela::fs {
@@ -58,6 +60,34 @@ private:
 bool ForceDeleteFile(HANDLE FileHandle, bela::error_code &ec);
 bool ForceDeleteFile(std::wstring_view path, bela::error_code &ec);
 bool ForceDeleteFolders(std::wstring_view path, bela::error_code &ec);
+// ForceDeleteFolders removes the directory path and everything below it with opts.concurrency threads, see
+// RemoveOptions. Junctions and symbolic links are removed, not followed. Counts of removed entries are added to stats.
+bool ForceDeleteFolders(std::wstring_view path, const RemoveOptions &opts, RemoveStats &stats, bela::error_code &ec);
+
+using Glob = basic_glob<wchar_t>;
+using WalkEntry = basic_walk_entry<wchar_t>;
+using WalkOptions = basic_walk_options<wchar_t>;
+
+// Walker enumerates a directory tree on a thread pool, replacing hand written Finder recursions:
+//
+//  bela::fs::WalkOptions opts;
+//  opts.include = bela::fs::Glob({L"*.dll", L"*.exe"}, bela::fnmatch::CaseFold);
+//  opts.exclude = bela::fs::Glob({L".git", L"node_modules"});
+//  bela::fs::Walker walker(std::move(opts));
+//  walker.Walk(L"C:\\Program Files", [&](const bela::fs::WalkEntry &e) { ... }, ec);
+//
+// Directories are read 64K at a time with GetFileInformationByHandleEx, entries come with their type and size. fn is
+// called concurrently from the pool threads, an exception thrown by fn cancels the walk and is rethrown by Walk.
+class Walker {
+public:
+  explicit Walker(WalkOptions opts_ = {}) : opts(std::move(opts_)) {}
+  bool Walk(std::wstring_view root, const std::function<void(const WalkEntry &)> &fn, bela::error_code &ec);
+  const WalkStats &Stats() const { return stats; }
+
+private:
+  WalkOptions opts;
+  WalkStats stats;
+};
 } // namespace bela::fs
 
 #endif
\ No newline at end of file
@@ -0,0 +1,233 @@
+// String interning: one copy of every distinct name, identified by a dense 32-bit id
+#ifndef BELA_INTERNER_HPP
+#define BELA_INTERNER_HPP
+#include <array>
+#include <bit>
+#include <limits>
+#include <memory>
+#include <optional>
+#include <shared_mutex>
+#include <stdexcept>
+#include <string_view>
+#include <vector>
+#include "phmap.hpp"
+
+namespace bela {
+namespace intern_internal {
+// arena copies strings into large blocks that are never moved or freed before the arena, every copy is NUL
+// terminated so views can be passed to C APIs
+template <typename CharT> class arena {
+public:
+  using string_view_t = std::basic_string_view<CharT>;
+  arena() = default;
+  arena(const arena &) = delete;
+  arena &operator=(const arena &) = delete;
+
+  string_view_t Copy(string_view_t s) {
+    auto n = s.size() + 1;
+    CharT *p = nullptr;
+    if (n > blockSize / 4) {
+      // large strings get a block of their own, the current block keeps filling
+      p = Allocate(n);
+    } else {
+      if (n > avail) {
+        current = Allocate(blockSize);
+        avail = blockSize;
+      }
+      p = current;
+      current += n;
+      avail -= n;
+    }
+    std::char_traits<CharT>::copy(p, s.data(), s.size());
+    p[s.size()] = CharT{0};
+    return string_view_t{p, s.size()};
+  }
+  size_t Bytes() const { return bytes; }
+
+private:
+  static constexpr size_t blockSize = 64 * 1024 / sizeof(CharT);
+  CharT *Allocate(size_t n) {
+    blocks.emplace_back(std::make_unique_for_overwrite<CharT[]>(n));
+    bytes += n * sizeof(CharT);
+    return blocks.back().get();
+  }
+  std::vector<std::unique_ptr<CharT[]>> blocks;
+  CharT *current{nullptr};
+  size_t avail{0};
+  size_t bytes{0};
+};
+
+// view_table is a vector of views that never relocates: segment s holds firstSegment << s entries, so a reader can
+// index it while a writer appends to a later segment
+template <typename CharT> class view_table {
+public:
+  using string_view_t = std::basic_string_view<CharT>;
+  string_view_t operator[](uint32_t i) const {
+    auto [s, offset] = Locate(i);
+    return segments[s][offset];
+  }
+  void Push(uint32_t i, string_view_t v) {
+    auto [s, offset] = Locate(i);
+    if (!segments[s]) {
+      segments[s] = std::make_unique<string_view_t[]>(firstSegment << s);
+    }
+    segments[s][offset] = v;
+  }
+
+private:
+  static constexpr size_t firstSegment = 256;
+  static constexpr std::pair<size_t, size_t> Locate(uint32_t i) {
+    auto s = std::bit_width(i / firstSegment + 1) - 1;
+    return {s, i - firstSegment * ((size_t{1} << s) - 1)};
+  }
+  std::array<std::unique_ptr<string_view_t[]>, 25> segments;
+};
+} // namespace intern_internal
+
+// BasicInterner keeps one copy of every distinct string in an arena and gives each a 32-bit id, ids are dense and
+// assigned in first-seen order. Storing ids (or the returned views) instead of std::string copies makes repeated names
+// cost 4 bytes each and turns their comparison into an integer compare. Views stay valid until the interner is
+// destroyed and are NUL terminated. Not thread-safe, see BasicConcurrentInterner.
+template <typename CharT> class BasicInterner {
+public:
+  using string_view_t = std::basic_string_view<CharT>;
+  BasicInterner() = default;
+  BasicInterner(const BasicInterner &) = delete;
+  BasicInterner &operator=(const BasicInterner &) = delete;
+
+  // Intern returns the id of s, copying s into the arena when it is new
+  uint32_t Intern(string_view_t s) {
+    auto hashval = ids.hash(s);
+    if (auto it = ids.find(s, hashval); it != ids.end()) {
+      return it->second;
+    }
+    if (views.size() == (std::numeric_limits<uint32_t>::max)()) {
+      throw std::length_error("bela::Interner: too many strings");
+    }
+    auto id = static_cast<uint32_t>(views.size());
+    auto v = strings.Copy(s);
+    views.emplace_back(v);
+    try {
+      ids.emplace_with_hash(hashval, v, id);
+    } catch (...) {
+      views.pop_back();
+      throw;
+    }
+    return id;
+  }
+  // InternView returns the interned copy of s
+  string_view_t InternView(string_view_t s) { return View(Intern(s)); }
+  std::optional<uint32_t> Find(string_view_t s) const {
+    if (auto it = ids.find(s); it != ids.end()) {
+      return it->second;
+    }
+    return std::nullopt;
+  }
+  string_view_t View(uint32_t id) const { return views[id]; }
+  size_t Size() const { return views.size(); }
+  // Bytes reports the memory held by strings, views and the lookup table
+  size_t Bytes() const {
+    return strings.Bytes() + views.capacity() * sizeof(string_view_t) +
+           ids.capacity() * (sizeof(typename map_t::value_type) + 1);
+  }
+
+private:
+  using map_t = bela::flat_hash_map<string_view_t, uint32_t>;
+  intern_internal::arena<CharT> strings;
+  std::vector<string_view_t> views;
+  map_t ids;
+};
+
+// BasicConcurrentInterner is a BasicInterner for many threads. Strings are spread over 2^N shards by hash, each with
+// its own arena and a reader/writer lock: interning a string that is already known takes the shared lock only, so
+// parsers that mostly see repeated names do not serialize. Ids encode the shard in their low N bits, they are unique
+// and stable but not dense. View does not lock, the id must come from Intern or Find on this interner.
+template <typename CharT, size_t N = 4> class BasicConcurrentInterner {
+public:
+  using string_view_t = std::basic_string_view<CharT>;
+  BasicConcurrentInterner() = default;
+  BasicConcurrentInterner(const BasicConcurrentInterner &) = delete;
+  BasicConcurrentInterner &operator=(const BasicConcurrentInterner &) = delete;
+
+  uint32_t Intern(string_view_t s) {
+    auto hashval = ids.hash(s);
+    auto idx = table_t::subidx(hashval);
+    if (auto id = Lookup(s, hashval, idx)) {
+      return *id;
+    }
+    uint32_t id = 0;
+    ids.with_submap_m(idx, [&](auto &set) {
+      // another thread may have interned s since the shared lookup
+      if (auto it = set.find(s, hashval); it != set.end()) {
+        id = it->second;
+        return;
+      }
+      auto &sh = shards[idx];
+      if (uint64_t{sh.size} >= maxShardSize) {
+        throw std::length_error("bela::ConcurrentInterner: too many strings");
+      }
+      auto v = sh.strings.Copy(s);
+      sh.views.Push(sh.size, v);
+      id = static_cast<uint32_t>((sh.size << N) | idx);
+      set.emplace_with_hash(hashval, v, id);
+      sh.size++;
+    });
+    return id;
+  }
+  string_view_t InternView(string_view_t s) { return View(Intern(s)); }
+  std::optional<uint32_t> Find(string_view_t s) const {
+    auto hashval = ids.hash(s);
+    return Lookup(s, hashval, table_t::subidx(hashval));
+  }
+  string_view_t View(uint32_t id) const { return shards[id & (shardCount - 1)].views[id >> N]; }
+  size_t Size() const { return ids.size(); }
+  size_t Bytes() const {
+    size_t bytes = ids.capacity() * (sizeof(typename map_t::value_type) + 1);
+    for (size_t i = 0; i < shardCount; i++) {
+      ids.with_submap(i, [&](const auto &) {
+        bytes += shards[i].strings.Bytes() + shards[i].size * sizeof(string_view_t);
+      });
+    }
+    return bytes;
+  }
+
+private:
+  // with N == 0 a shard could hold 2^32 strings, more than its 32-bit size can count
+  static_assert(N > 0 && N < 16, "N must be 1..15 for 32-bit ids");
+  static constexpr size_t shardCount = size_t{1} << N;
+  static constexpr uint64_t maxShardSize = uint64_t{1} << (32 - N);
+  using map_t = phmap::parallel_flat_hash_map<string_view_t, uint32_t, phmap::Hash<string_view_t>,
+                                              phmap::EqualTo<string_view_t>,
+                                              phmap::priv::Allocator<phmap::priv::Pair<const string_view_t, uint32_t>>,
+                                              N, std::shared_mutex>;
+  struct table_t : map_t {
+    using map_t::subidx;
+  };
+  // strings of one shard, written under the shard's exclusive lock
+  struct alignas(64) shard {
+    intern_internal::arena<CharT> strings;
+    intern_internal::view_table<CharT> views;
+    uint32_t size{0};
+  };
+
+  std::optional<uint32_t> Lookup(string_view_t s, size_t hashval, size_t idx) const {
+    std::optional<uint32_t> id;
+    ids.with_submap(idx, [&](const auto &set) {
+      if (auto it = set.find(s, hashval); it != set.end()) {
+        id = it->second;
+      }
+    });
+    return id;
+  }
+
+  table_t ids;
+  std::array<shard, shardCount> shards;
+};
+
+using Interner = BasicInterner<char>;
+using WInterner = BasicInterner<wchar_t>;
+using ConcurrentInterner = BasicConcurrentInterner<char>;
+using WConcurrentInterner = BasicConcurrentInterner<wchar_t>;
+} // namespace bela
+
+#endif
@@ -184,6 +184,32 @@ std::optional<FD> NewFile(std::wstring_view file, DWORD dwDesiredAccess, DWORD d
                           LPSECURITY_ATTRIBUTES lpSecurityAttributes, DWORD dwCreationDisposition,
                           DWORD dwFlagsAndAttributes, HANDLE hTemplateFile, bela::error_code &ec);
 
+// MappedFile maps a whole file read-only, the view stays valid until the MappedFile is closed or destroyed
+class MappedFile {
+private:
+  void Free();
+  void MoveFrom(MappedFile &&o);
+
+public:
+  MappedFile() = default;
+  MappedFile(const MappedFile &) = delete;
+  MappedFile &operator=(const MappedFile &) = delete;
+  MappedFile(MappedFile &&o) { MoveFrom(std::move(o)); }
+  MappedFile &operator=(MappedFile &&o) {
+    MoveFrom(std::move(o));
+    return *this;
+  }
+  ~MappedFile() { Free(); }
+  bool Open(std::wstring_view file, bela::error_code &ec);
+  void Close() { Free(); }
+  std::span<const uint8_t> Data() const { return {data, size}; }
+  size_t Size() const { return size; }
+
+private:
+  const uint8_t *data{nullptr};
+  size_t size{0};
+};
+
 inline bool ReadAt(HANDLE fd, void *buffer, size_t len, int64_t pos, size_t &outlen, bela::error_code &ec) {
   if (!bela::io::Seek(fd, pos, ec)) {
     return false;
@@ -0,0 +1,251 @@
+// Read-only flat_hash_map probed in place from a memory-mapped snapshot
+#ifndef BELA_MAPPED_HASH_MAP_HPP
+#define BELA_MAPPED_HASH_MAP_HPP
+#include "phmap.hpp"
+#include "__phmap/phmap_dump.h"
+#include "io.hpp"
+#include <utility>
+
+namespace bela {
+namespace mapped_internal {
+constexpr char snapshotMagic[8] = {'B', 'E', 'L', 'A', 'F', 'H', 'M', '1'};
+constexpr uint32_t snapshotVersion = 1;
+// ctrl bytes and slots start on a cache line
+constexpr uint64_t snapshotAlignment = 64;
+
+struct snapshot_header {
+  char magic[8];
+  uint32_t version;
+  uint32_t groupWidth;
+  // hashes of a few fixed keys: a snapshot written with another hash function (or mixer) is rejected
+  uint64_t fingerprint;
+  uint32_t keySize;
+  uint32_t valueSize;
+  uint64_t slotSize;
+  uint64_t size;
+  uint64_t capacity;
+  uint64_t ctrlOffset;
+  uint64_t ctrlSize;
+  uint64_t slotsOffset;
+  uint64_t slotsSize;
+};
+
+// blob_archive records the pieces phmap_dump writes: version, size, capacity, then ctrl bytes, slots and growth_left
+// for a non-empty table. They point into the table, which must outlive the archive.
+struct blob_archive {
+  std::vector<std::span<const uint8_t>> blobs;
+  bool saveBinary(const void *p, size_t n) {
+    blobs.emplace_back(static_cast<const uint8_t *>(p), n);
+    return true;
+  }
+};
+
+constexpr uint64_t AlignUp(uint64_t n) { return (n + snapshotAlignment - 1) & ~(snapshotAlignment - 1); }
+
+template <typename K, typename Table> uint64_t Fingerprint(const Table &table) {
+  uint64_t fingerprint = sizeof(K);
+  for (uint8_t pattern : {0x00, 0x01, 0x5A, 0xFF}) {
+    K key{};
+    std::memset(static_cast<void *>(&key), pattern, sizeof(K));
+    fingerprint = (fingerprint ^ table.hash(key)) * 0x9E3779B97F4A7C15ULL;
+  }
+  return fingerprint;
+}
+} // namespace mapped_internal
+
+// MappedFlatHashMap is a read-only bela::flat_hash_map backed by a file mapping. Save writes the control bytes and
+// slots of a table as they are in memory, Open maps the file and Find probes it in place, so opening a multi-GB table
+// costs no reads and no allocations. K and V must be trivially copyable (no pointers into the writing process); the
+// header rejects snapshots written with another Hash, another slot layout or another probe group width.
+template <typename K, typename V, typename Hash = phmap::Hash<K>, typename Eq = phmap::EqualTo<K>>
+class MappedFlatHashMap {
+public:
+  using table_t = bela::flat_hash_map<K, V, Hash, Eq>;
+  using value_type = typename table_t::value_type;
+  static_assert(std::is_trivially_copyable_v<K> && std::is_trivially_copyable_v<V>,
+                "MappedFlatHashMap requires trivially copyable keys and values");
+  static_assert(alignof(value_type) <= mapped_internal::snapshotAlignment, "slot alignment too large");
+
+  MappedFlatHashMap() = default;
+  MappedFlatHashMap(const MappedFlatHashMap &) = delete;
+  MappedFlatHashMap &operator=(const MappedFlatHashMap &) = delete;
+  // a moved-from map is empty: the mapping and the pointers into it belong to the destination
+  MappedFlatHashMap(MappedFlatHashMap &&o) noexcept
+      : mapped(std::move(o.mapped)), hasher(o.hasher), eq(o.eq), ctrl(std::exchange(o.ctrl, nullptr)), slots(std::exchange(o.slots, nullptr)),
+        capacity(std::exchange(o.capacity, 0)), count(std::exchange(o.count, 0)) {}
+  MappedFlatHashMap &operator=(MappedFlatHashMap &&o) noexcept {
+    if (this == &o) {
+      return *this;
+    }
+    mapped = std::move(o.mapped);
+    hasher = o.hasher;
+    eq = o.eq;
+    ctrl = std::exchange(o.ctrl, nullptr);
+    slots = std::exchange(o.slots, nullptr);
+    capacity = std::exchange(o.capacity, 0);
+    count = std::exchange(o.count, 0);
+    return *this;
+  }
+
+  // Save writes table to file as a snapshot Open can map
+  static bool Save(std::wstring_view file, const table_t &table, bela::error_code &ec) {
+    using namespace mapped_internal;
+    blob_archive ar;
+    table.phmap_dump(ar);
+    snapshot_header hdr{};
+    std::memcpy(hdr.magic, snapshotMagic, sizeof(hdr.magic));
+    hdr.version = snapshotVersion;
+    hdr.groupWidth = phmap::priv::Group::kWidth;
+    hdr.fingerprint = Fingerprint<K>(table);
+    hdr.keySize = sizeof(K);
+    hdr.valueSize = sizeof(V);
+    hdr.slotSize = sizeof(value_type);
+    hdr.size = table.size();
+    if (table.size() != 0) {
+      // version, size, capacity, ctrl, slots, growth_left
+      if (ar.blobs.size() != 6) {
+        ec = bela::make_error_code(L"unsupported flat_hash_map dump layout");
+        return false;
+      }
+      hdr.capacity = table.capacity();
+      hdr.ctrlOffset = AlignUp(sizeof(snapshot_header));
+      hdr.ctrlSize = ar.blobs[3].size();
+      hdr.slotsOffset = AlignUp(hdr.ctrlOffset + hdr.ctrlSize);
+      hdr.slotsSize = ar.blobs[4].size();
+    }
+    auto fd = bela::io::NewFile(file, GENERIC_WRITE, FILE_SHARE_READ, nullptr, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL,
+                                nullptr, ec);
+    if (!fd) {
+      return false;
+    }
+    const uint8_t zeros[snapshotAlignment] = {0};
+    auto written = uint64_t{0};
+    auto write = [&](std::span<const uint8_t> bytes) {
+      written += bytes.size();
+      return bela::io::WriteFull(fd->NativeFD(), bytes, ec);
+    };
+    auto pad = [&](uint64_t offset) { return write({zeros, static_cast<size_t>(offset - written)}); };
+    if (!write({reinterpret_cast<const uint8_t *>(&hdr), sizeof(hdr)})) {
+      return false;
+    }
+    if (hdr.size == 0) {
+      return true;
+    }
+    return pad(hdr.ctrlOffset) && write(ar.blobs[3]) && pad(hdr.slotsOffset) && write(ar.blobs[4]);
+  }
+
+  // Open maps a snapshot written by Save and validates its header
+  bool Open(std::wstring_view file, bela::error_code &ec) {
+    using namespace mapped_internal;
+    Close();
+    if (!mapped.Open(file, ec)) {
+      return false;
+    }
+    auto bytes = mapped.Data();
+    snapshot_header hdr;
+    if (bytes.size() < sizeof(hdr)) {
+      ec = bela::make_error_code(ErrGeneral, L"'", file, L"' is not a flat_hash_map snapshot");
+      mapped.Close();
+      return false;
+    }
+    std::memcpy(&hdr, bytes.data(), sizeof(hdr));
+    if (!Validate(hdr, bytes.size(), ec)) {
+      mapped.Close();
+      return false;
+    }
+    if (hdr.size != 0) {
+      ctrl = reinterpret_cast<const phmap::priv::ctrl_t *>(bytes.data() + hdr.ctrlOffset);
+      slots = reinterpret_cast<const value_type *>(bytes.data() + hdr.slotsOffset);
+      capacity = static_cast<size_t>(hdr.capacity);
+    }
+    count = static_cast<size_t>(hdr.size);
+    return true;
+  }
+
+  void Close() {
+    mapped.Close();
+    ctrl = nullptr;
+    slots = nullptr;
+    capacity = 0;
+    count = 0;
+  }
+
+  // Find returns the entry for key, nullptr when it is absent. Entries point into the mapping.
+  const value_type *Find(const K &key) const {
+    if (ctrl == nullptr) {
+      return nullptr;
+    }
+    using namespace phmap::priv;
+    auto hashval = hasher.hash(key);
+    // the probe sequence phmap used when it inserted the entries
+    probe_seq<Group::kWidth> seq(H1(hashval, ctrl), capacity);
+    for (;;) {
+      Group g{ctrl + seq.offset()};
+      for (uint32_t i : g.Match(static_cast<h2_t>(H2(hashval)))) {
+        auto &slot = slots[seq.offset(static_cast<size_t>(i))];
+        if (eq(slot.first, key)) {
+          return &slot;
+        }
+      }
+      if (g.MatchEmpty()) {
+        return nullptr;
+      }
+      seq.next();
+    }
+  }
+  bool Contains(const K &key) const { return Find(key) != nullptr; }
+  size_t Size() const { return count; }
+  bool Empty() const { return count == 0; }
+
+  // ForEach visits every entry in slot order
+  template <typename Fn> void ForEach(Fn fn) const {
+    for (size_t i = 0; i < capacity && ctrl != nullptr; i++) {
+      if (phmap::priv::IsFull(ctrl[i])) {
+        fn(slots[i]);
+      }
+    }
+  }
+
+private:
+  bool Validate(const mapped_internal::snapshot_header &hdr, size_t fileSize, bela::error_code &ec) const {
+    using namespace mapped_internal;
+    if (std::memcmp(hdr.magic, snapshotMagic, sizeof(hdr.magic)) != 0 || hdr.version != snapshotVersion) {
+      ec = bela::make_error_code(L"unsupported flat_hash_map snapshot version");
+      return false;
+    }
+    if (hdr.groupWidth != phmap::priv::Group::kWidth || hdr.keySize != sizeof(K) || hdr.valueSize != sizeof(V) ||
+        hdr.slotSize != sizeof(value_type)) {
+      ec = bela::make_error_code(L"flat_hash_map snapshot was written with another layout");
+      return false;
+    }
+    if (hdr.fingerprint != Fingerprint<K>(hasher)) {
+      ec = bela::make_error_code(L"flat_hash_map snapshot was written with another hash function");
+      return false;
+    }
+    if (hdr.size == 0) {
+      return true;
+    }
+    // capacity is 2^n-1, control bytes carry the sentinel and the cloned group
+    if (((hdr.capacity + 1) & hdr.capacity) != 0 || hdr.size > hdr.capacity ||
+        hdr.ctrlSize != hdr.capacity + phmap::priv::Group::kWidth + 1 ||
+        hdr.slotsSize != hdr.capacity * sizeof(value_type) || hdr.ctrlOffset % snapshotAlignment != 0 ||
+        hdr.slotsOffset % snapshotAlignment != 0 || hdr.ctrlOffset + hdr.ctrlSize > hdr.slotsOffset ||
+        hdr.slotsOffset + hdr.slotsSize > fileSize) {
+      ec = bela::make_error_code(L"flat_hash_map snapshot is truncated or corrupt");
+      return false;
+    }
+    return true;
+  }
+
+  bela::io::MappedFile mapped;
+  // an empty table never allocates, it provides the exact hash (including phmap's mixer) used by Save
+  table_t hasher;
+  Eq eq;
+  const phmap::priv::ctrl_t *ctrl{nullptr};
+  const value_type *slots{nullptr};
+  size_t capacity{0};
+  size_t count{0};
+};
+} // namespace bela
+
+#endif
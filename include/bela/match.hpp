@@ -58,6 +58,9 @@ inline bool StrContains(std::wstring_view haystack, wchar_t needle) noexcept {
 bool EqualsIgnoreCase(std::wstring_view piece1, std::wstring_view piece2) noexcept;
 bool StartsWithIgnoreCase(std::wstring_view text, std::wstring_view prefix) noexcept;
 bool EndsWithIgnoreCase(std::wstring_view text, std::wstring_view suffix) noexcept;
+// HashIgnoreCase hashes text with ASCII letters folded to lower case, consistent with EqualsIgnoreCase. It folds and
+// mixes 16 code units per step, for hash maps keyed by environment names or paths.
+size_t HashIgnoreCase(std::wstring_view text) noexcept;
 
 /// Narrow
 
@@ -75,6 +78,7 @@ inline bool StrContains(std::string_view haystack, char needle) noexcept {
 bool EqualsIgnoreCase(std::string_view piece1, std::string_view piece2) noexcept;
 bool StartsWithIgnoreCase(std::string_view text, std::string_view prefix) noexcept;
 bool EndsWithIgnoreCase(std::string_view text, std::string_view suffix) noexcept;
+size_t HashIgnoreCase(std::string_view text) noexcept;
 
 } // namespace bela
 
@@ -9,26 +9,7 @@
 namespace bela::env {
 struct StringCaseInsensitiveHash {
   using is_transparent = void;
-  std::size_t operator()(std::wstring_view wsv) const noexcept {
-    /// See Wikipedia
-    /// https://en.wikipedia.org/wiki/Fowler%E2%80%93Noll%E2%80%93Vo_hash_function
-#if defined(__x86_64) || defined(_WIN64)
-    static_assert(sizeof(size_t) == 8, "This code is for 64-bit size_t.");
-    constexpr size_t kFNVOffsetBasis = 14695981039346656037ULL;
-    constexpr size_t kFNVPrime = 1099511628211ULL;
-#else
-    static_assert(sizeof(size_t) == 4, "This code is for 32-bit size_t.");
-    constexpr size_t kFNVOffsetBasis = 2166136261U;
-    constexpr size_t kFNVPrime = 16777619U;
-#endif
-    size_t val = kFNVOffsetBasis;
-    std::string_view sv = {reinterpret_cast<const char *>(wsv.data()), wsv.size() * 2};
-    for (auto c : sv) {
-      val ^= static_cast<size_t>(bela::ascii_tolower(c));
-      val *= kFNVPrime;
-    }
-    return val;
-  }
+  std::size_t operator()(std::wstring_view wsv) const noexcept { return bela::HashIgnoreCase(wsv); }
 };
 
 struct StringCaseInsensitiveEq {
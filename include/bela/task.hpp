@@ -0,0 +1,312 @@
+// Coroutine tasks that run on the bela thread pool
+#ifndef BELA_TASK_HPP
+#define BELA_TASK_HPP
+#include <atomic>
+#include <condition_variable>
+#include <coroutine>
+#include <exception>
+#include <mutex>
+#include <optional>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "thread_pool.hpp"
+
+namespace bela {
+template <typename T = void> class Task;
+
+namespace task_internal {
+// outcome holds the value or the exception a task finished with
+template <typename T> struct outcome {
+  template <typename U> void Set(U &&v) { value.emplace(std::forward<U>(v)); }
+  T Get() {
+    if (error) {
+      std::rethrow_exception(error);
+    }
+    return std::move(*value);
+  }
+  std::optional<T> value;
+  std::exception_ptr error;
+};
+
+template <> struct outcome<void> {
+  void Get() {
+    if (error) {
+      std::rethrow_exception(error);
+    }
+  }
+  std::exception_ptr error;
+};
+
+// final_awaiter transfers to the coroutine awaiting the task without growing the stack
+struct final_awaiter {
+  bool await_ready() noexcept { return false; }
+  template <typename P> std::coroutine_handle<> await_suspend(std::coroutine_handle<P> h) noexcept {
+    if (auto c = h.promise().continuation; c) {
+      return c;
+    }
+    return std::noop_coroutine();
+  }
+  void await_resume() noexcept {}
+};
+
+struct promise_base {
+  std::suspend_always initial_suspend() noexcept { return {}; }
+  final_awaiter final_suspend() noexcept { return {}; }
+  std::coroutine_handle<> continuation;
+};
+
+template <typename T> struct promise : promise_base {
+  Task<T> get_return_object() noexcept;
+  template <typename U = T>
+    requires std::is_convertible_v<U &&, T>
+  void return_value(U &&v) {
+    result.Set(std::forward<U>(v));
+  }
+  void unhandled_exception() noexcept { result.error = std::current_exception(); }
+  outcome<T> result;
+};
+
+template <> struct promise<void> : promise_base {
+  Task<void> get_return_object() noexcept;
+  void return_void() noexcept {}
+  void unhandled_exception() noexcept { result.error = std::current_exception(); }
+  outcome<void> result;
+};
+
+} // namespace task_internal
+
+// Task is a lazily started coroutine producing a T. It runs when it is awaited, on the awaiting thread, and resumes its
+// awaiter by symmetric transfer when it finishes, so long chains of tasks neither block threads nor grow the stack.
+// Exceptions escaping the coroutine are rethrown by co_await. A Task is awaited once; destroying a Task that has not
+// started destroys its coroutine, destroying a running Task is undefined.
+template <typename T> class [[nodiscard]] Task {
+public:
+  static_assert(!std::is_reference_v<T>, "bela::Task does not support references");
+  using promise_type = task_internal::promise<T>;
+  using value_type = T;
+  Task() = default;
+  Task(const Task &) = delete;
+  Task &operator=(const Task &) = delete;
+  Task(Task &&o) noexcept : handle(std::exchange(o.handle, nullptr)) {}
+  Task &operator=(Task &&o) noexcept {
+    if (this != &o) {
+      Free();
+      handle = std::exchange(o.handle, nullptr);
+    }
+    return *this;
+  }
+  ~Task() { Free(); }
+  explicit operator bool() const { return static_cast<bool>(handle); }
+  bool Done() const { return handle && handle.done(); }
+
+  auto operator co_await() && noexcept {
+    struct awaiter {
+      bool await_ready() noexcept { return handle.done(); }
+      std::coroutine_handle<> await_suspend(std::coroutine_handle<> awaiting) noexcept {
+        handle.promise().continuation = awaiting;
+        return handle;
+      }
+      T await_resume() { return handle.promise().result.Get(); }
+      std::coroutine_handle<promise_type> handle;
+    };
+    return awaiter{handle};
+  }
+
+private:
+  friend struct task_internal::promise<T>;
+  explicit Task(std::coroutine_handle<promise_type> h) : handle(h) {}
+  void Free() {
+    if (handle) {
+      handle.destroy();
+      handle = nullptr;
+    }
+  }
+  std::coroutine_handle<promise_type> handle;
+};
+
+namespace task_internal {
+template <typename T> Task<T> promise<T>::get_return_object() noexcept {
+  return Task<T>{std::coroutine_handle<promise<T>>::from_promise(*this)};
+}
+inline Task<void> promise<void>::get_return_object() noexcept {
+  return Task<void>{std::coroutine_handle<promise<void>>::from_promise(*this)};
+}
+
+// Capture awaits task and stores its outcome instead of throwing, the drivers below start tasks from outside a
+// coroutine with it
+template <typename T> Task<void> Capture(Task<T> &task, outcome<T> &out) {
+  try {
+    if constexpr (std::is_void_v<T>) {
+      co_await std::move(task);
+    } else {
+      out.Set(co_await std::move(task));
+    }
+  } catch (...) {
+    out.error = std::current_exception();
+  }
+}
+
+// sync_driver runs eagerly and frees itself, SyncWait blocks on its event
+struct sync_driver {
+  struct promise_type {
+    sync_driver get_return_object() noexcept { return {}; }
+    std::suspend_never initial_suspend() noexcept { return {}; }
+    std::suspend_never final_suspend() noexcept { return {}; }
+    void return_void() noexcept {}
+    void unhandled_exception() noexcept { std::terminate(); }
+  };
+};
+
+class sync_event {
+public:
+  void Set() {
+    // notify under the lock: the waiter destroys the event as soon as it returns
+    std::lock_guard lock(mutex);
+    done = true;
+    cond.notify_one();
+  }
+  void Wait() {
+    std::unique_lock lock(mutex);
+    cond.wait(lock, [&] { return done; });
+  }
+
+private:
+  std::mutex mutex;
+  std::condition_variable cond;
+  bool done{false};
+};
+
+template <typename T> sync_driver SyncRun(Task<T> &task, outcome<T> &out, sync_event &event) {
+  co_await Capture(task, out);
+  event.Set();
+}
+
+// when_all_driver starts suspended, it is resumed on the pool and frees itself; the last one to finish resumes the
+// waiter of WhenAll
+struct when_all_state {
+  std::atomic_size_t remaining{0};
+  std::coroutine_handle<> continuation;
+};
+
+struct when_all_driver {
+  struct promise_type {
+    when_all_driver get_return_object() noexcept {
+      return {std::coroutine_handle<promise_type>::from_promise(*this)};
+    }
+    std::suspend_always initial_suspend() noexcept { return {}; }
+    auto final_suspend() noexcept {
+      struct awaiter {
+        bool await_ready() noexcept { return false; }
+        std::coroutine_handle<> await_suspend(std::coroutine_handle<promise_type> h) noexcept {
+          auto *state = h.promise().state;
+          h.destroy();
+          if (state->remaining.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            return state->continuation;
+          }
+          return std::noop_coroutine();
+        }
+        void await_resume() noexcept {}
+      };
+      return awaiter{};
+    }
+    void return_void() noexcept {}
+    void unhandled_exception() noexcept { std::terminate(); }
+    when_all_state *state{nullptr};
+  };
+  std::coroutine_handle<promise_type> handle;
+};
+
+template <typename T> when_all_driver WhenAllRun(Task<T> &task, outcome<T> &out) {
+  co_await Capture(task, out);
+}
+
+template <typename T> class when_all_awaiter {
+public:
+  when_all_awaiter(ThreadPool &pool_, std::vector<Task<T>> &tasks, std::vector<outcome<T>> &outcomes) : pool(pool_) {
+    drivers.reserve(tasks.size());
+    try {
+      for (size_t i = 0; i < tasks.size(); i++) {
+        drivers.emplace_back(WhenAllRun(tasks[i], outcomes[i]).handle);
+        drivers.back().promise().state = &state;
+      }
+    } catch (...) {
+      for (auto h : drivers) {
+        h.destroy();
+      }
+      throw;
+    }
+    // the waiter holds one count until every driver was submitted
+    state.remaining.store(drivers.size() + 1, std::memory_order_relaxed);
+  }
+  when_all_awaiter(const when_all_awaiter &) = delete;
+  when_all_awaiter &operator=(const when_all_awaiter &) = delete;
+  bool await_ready() noexcept { return drivers.empty(); }
+  bool await_suspend(std::coroutine_handle<> awaiting) {
+    state.continuation = awaiting;
+    for (auto h : drivers) {
+      pool.Submit([h] { h.resume(); });
+    }
+    return state.remaining.fetch_sub(1, std::memory_order_acq_rel) != 1;
+  }
+  void await_resume() noexcept {}
+
+private:
+  ThreadPool &pool;
+  std::vector<std::coroutine_handle<when_all_driver::promise_type>> drivers;
+  when_all_state state;
+};
+} // namespace task_internal
+
+// Schedule suspends the calling coroutine and resumes it on a worker of pool: co_await bela::Schedule() moves the rest
+// of a coroutine off the current thread, for example off an I/O completion onto the CPU pool before parsing
+inline auto Schedule(ThreadPool &pool = ThreadPool::Default()) {
+  struct awaiter {
+    bool await_ready() noexcept { return false; }
+    void await_suspend(std::coroutine_handle<> h) { pool.Submit([h] { h.resume(); }); }
+    void await_resume() noexcept {}
+    ThreadPool &pool;
+  };
+  return awaiter{pool};
+}
+
+// SyncWait runs task on the calling thread until it first suspends, then blocks until it finished and returns its
+// result or rethrows its exception. It must not be called from a worker the task depends on.
+template <typename T> T SyncWait(Task<T> task) {
+  task_internal::outcome<T> out;
+  task_internal::sync_event event;
+  task_internal::SyncRun(task, out, event);
+  event.Wait();
+  return out.Get();
+}
+
+// WhenAll starts every task on a worker of pool and completes when all of them finished. Results keep the order of
+// tasks; if any task threw, the exception of the first such task is rethrown after all have finished.
+template <typename T>
+Task<std::vector<T>> WhenAll(std::vector<Task<T>> tasks, ThreadPool &pool = ThreadPool::Default()) {
+  std::vector<task_internal::outcome<T>> outcomes(tasks.size());
+  co_await task_internal::when_all_awaiter<T>(pool, tasks, outcomes);
+  std::vector<T> results;
+  results.reserve(outcomes.size());
+  for (auto &o : outcomes) {
+    if (o.error) {
+      std::rethrow_exception(o.error);
+    }
+  }
+  for (auto &o : outcomes) {
+    results.emplace_back(o.Get());
+  }
+  co_return results;
+}
+
+inline Task<void> WhenAll(std::vector<Task<void>> tasks, ThreadPool &pool = ThreadPool::Default()) {
+  std::vector<task_internal::outcome<void>> outcomes(tasks.size());
+  co_await task_internal::when_all_awaiter<void>(pool, tasks, outcomes);
+  for (auto &o : outcomes) {
+    o.Get();
+  }
+}
+
+} // namespace bela
+
+#endif
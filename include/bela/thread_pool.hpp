@@ -0,0 +1,166 @@
+// Work-stealing thread pool and parallel loops
+#ifndef BELA_THREAD_POOL_HPP
+#define BELA_THREAD_POOL_HPP
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <ranges>
+#include <stop_token>
+#include <vector>
+
+namespace bela {
+using task_t = std::move_only_function<void()>;
+class TaskGroup;
+namespace pool_internal {
+struct task {
+  task_t fn;
+  TaskGroup *group{nullptr};
+};
+struct worker;
+} // namespace pool_internal
+
+// ThreadPool runs tasks on a fixed set of worker threads. Every worker owns a Chase-Lev deque: tasks spawned by a
+// worker go to the bottom of its own deque and are popped LIFO while they are still in cache, idle workers steal FIFO
+// from the top of other deques, which hands them the largest pieces of a recursively split loop. Tasks submitted from
+// other threads go through a shared queue. Idle workers spin briefly, then sleep until work is submitted.
+class ThreadPool {
+public:
+  // concurrency: number of workers, 0 means one per hardware thread
+  explicit ThreadPool(size_t concurrency = 0);
+  ThreadPool(const ThreadPool &) = delete;
+  ThreadPool &operator=(const ThreadPool &) = delete;
+  // ~ThreadPool runs the tasks already submitted, then joins the workers
+  ~ThreadPool();
+  // Default returns the process-wide pool, created on first use with one worker per hardware thread and never
+  // destroyed, so no worker is joined during static destruction
+  static ThreadPool &Default();
+  size_t Concurrency() const { return workers.size(); }
+  // Submit runs fn on a worker, fn must not throw
+  void Submit(task_t fn);
+
+private:
+  friend class TaskGroup;
+  void Push(pool_internal::task *t);
+  // RunOne runs one pending task on the calling thread, it returns false when no task was found
+  bool RunOne();
+  pool_internal::task *Find(pool_internal::worker *self);
+  void Execute(pool_internal::task *t);
+  void Work(pool_internal::worker *self);
+  std::vector<std::unique_ptr<pool_internal::worker>> workers;
+  std::mutex injectedMutex;
+  std::deque<pool_internal::task *> injected;
+  std::atomic_size_t injectedSize{0};
+  std::mutex sleepMutex;
+  std::condition_variable sleepCond;
+  std::atomic_int sleepers{0};
+  uint64_t epoch{0};
+  bool stopping{false};
+};
+
+// TaskGroup runs a set of tasks on a pool and waits for them. Wait runs pending tasks of the pool on the calling thread
+// until the group is done, so a task can wait for a nested group without blocking its worker. The first exception
+// thrown by a task cancels the group and is rethrown by Wait. Cancellation is cooperative: tasks that have not started
+// are skipped, running tasks poll Cancelled() or StopToken(). A cancelled group stays cancelled.
+class TaskGroup {
+public:
+  explicit TaskGroup(ThreadPool &pool_ = ThreadPool::Default()) : pool(pool_) {}
+  TaskGroup(const TaskGroup &) = delete;
+  TaskGroup &operator=(const TaskGroup &) = delete;
+  // ~TaskGroup waits for the tasks still running, exceptions are dropped
+  ~TaskGroup();
+  void Run(task_t fn);
+  void Wait();
+  void Cancel() { source.request_stop(); }
+  bool Cancelled() const { return source.stop_requested(); }
+  std::stop_token StopToken() const { return source.get_token(); }
+  ThreadPool &Pool() const { return pool; }
+
+private:
+  friend class ThreadPool;
+  void Finish(std::exception_ptr e);
+  ThreadPool &pool;
+  std::stop_source source;
+  std::atomic_size_t pending{0};
+  // idle is set by the task that finished last, Wait returns only after it released mutex
+  std::mutex mutex;
+  std::condition_variable cond;
+  bool idle{true};
+  std::exception_ptr error;
+};
+
+namespace pool_internal {
+// about 8 pieces per worker: enough slack for stealing to even out uneven iterations
+inline size_t DefaultGrain(size_t n, const ThreadPool &pool) {
+  return (std::max)(n / (pool.Concurrency() * 8), size_t{1});
+}
+
+// SplitFor halves [first, last) until at most grain indices are left, the upper halves become tasks of group
+template <typename Fn> void SplitFor(TaskGroup &group, size_t first, size_t last, size_t grain, Fn &fn) {
+  while (last - first > grain) {
+    if (group.Cancelled()) {
+      return;
+    }
+    auto mid = first + (last - first) / 2;
+    group.Run([&group, mid, last, grain, &fn] { SplitFor(group, mid, last, grain, fn); });
+    last = mid;
+  }
+  if (group.Cancelled()) {
+    return;
+  }
+  for (; first < last; first++) {
+    fn(first);
+  }
+}
+} // namespace pool_internal
+
+// ParallelFor calls fn(i) for every i in [first, last) on the tasks of group and waits for the group. Indices are
+// handed out in contiguous pieces of grain indices (0: derived from the pool size), cancelling the group stops pieces
+// that have not started.
+template <typename Fn> void ParallelFor(TaskGroup &group, size_t first, size_t last, Fn &&fn, size_t grain = 0) {
+  if (first < last) {
+    if (grain == 0) {
+      grain = pool_internal::DefaultGrain(last - first, group.Pool());
+    }
+    try {
+      pool_internal::SplitFor(group, first, last, grain, fn);
+    } catch (...) {
+      // like an exception thrown by a task, stop the pieces that have not started. The running pieces call fn, which
+      // may live in the frame being unwound: wait for them, the exception of the caller wins over theirs
+      group.Cancel();
+      try {
+        group.Wait();
+      } catch (...) {
+      }
+      throw;
+    }
+  }
+  group.Wait();
+}
+
+template <typename Fn> void ParallelFor(size_t first, size_t last, Fn &&fn, size_t grain = 0) {
+  TaskGroup group;
+  ParallelFor(group, first, last, fn, grain);
+}
+
+// ParallelForEach calls fn(element) for every element of a random access range, see ParallelFor
+template <std::ranges::random_access_range R, typename Fn>
+void ParallelForEach(TaskGroup &group, R &&range, Fn &&fn, size_t grain = 0) {
+  using difference_t = std::ranges::range_difference_t<R>;
+  auto it = std::ranges::begin(range);
+  ParallelFor(
+      group, 0, static_cast<size_t>(std::ranges::distance(range)),
+      [&](size_t i) { fn(it[static_cast<difference_t>(i)]); }, grain);
+}
+
+template <std::ranges::random_access_range R, typename Fn> void ParallelForEach(R &&range, Fn &&fn, size_t grain = 0) {
+  TaskGroup group;
+  ParallelForEach(group, range, fn, grain);
+}
+
+} // namespace bela
+
+#endif
@@ -34,6 +34,7 @@
 #include <cmath>
 #include <cstdint>
 #include <ctime>
+#include <span>
 #include <string>
 #include <type_traits>
 #include <utility>
@@ -472,7 +473,15 @@ std::chrono::minutes ToChronoMinutes(Duration d);
 std::chrono::hours ToChronoHours(Duration d);
 
 std::wstring FormatDuration(Duration d);
+// DurationMaxLength is the longest FormatDuration() output
+constexpr size_t DurationMaxLength = 40;
+// FormatDuration writes the FormatDuration(d) text to buffer without allocating, returns the number of characters
+// written or 0 when buffer is too small. Not NUL-terminated.
+size_t FormatDuration(Duration d, std::span<char> buffer);
+size_t FormatDuration(Duration d, std::span<wchar_t> buffer);
+// ParseDuration parses "300ms", "-1.5h", "2h45m"; integer-only forms take a single pass fast path
 bool ParseDuration(std::wstring_view dur_sv, Duration *d);
+bool ParseDuration(std::string_view dur_sv, Duration *d);
 
 class Time {
 public:
@@ -835,6 +844,25 @@ Time Now();
 // this function hundreds of thousands of times per second).
 int64_t GetCurrentTimeNanos();
 
+// MonotonicNow()
+//
+// Returns the time elapsed since an unspecified origin (system boot), read from
+// QueryPerformanceCounter. It never goes backwards when the wall clock is
+// adjusted, so use it rather than `bela::Now()` to measure intervals. On
+// hardware with an invariant TSC a read costs a few tens of nanoseconds.
+Duration MonotonicNow();
+
+// CoarseNow()
+// CoarseMonotonicNow()
+//
+// Timer-tick resolution (typically 1-16ms) variants of `bela::Now()` and
+// `bela::MonotonicNow()`. The kernel keeps both values in memory shared with
+// every process, so a read is a couple of loads and no counter access; prefer
+// them for timeouts, log throttling and statistics that tolerate millisecond
+// precision. See test/now/clocks.cc for a benchmark of every clock source.
+Time CoarseNow();
+Duration CoarseMonotonicNow();
+
 // SleepFor()
 //
 // Sleeps for the specified duration, expressed as an `absl::Duration`.
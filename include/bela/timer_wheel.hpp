@@ -0,0 +1,93 @@
+// Hierarchical hashed timer wheel
+#ifndef BELA_TIMER_WHEEL_HPP
+#define BELA_TIMER_WHEEL_HPP
+#include <array>
+#include <atomic>
+#include <functional>
+#include <vector>
+#include "time.hpp"
+
+namespace bela {
+// TimerWheel schedules callbacks on a monotonic timeline (bela::MonotonicNow() unless Advance() is driven with another
+// clock). Deadlines are rounded up to a tick and kept in Levels wheels of 64 slots, level N covering 64^(N+1) ticks;
+// Schedule() and Cancel() are O(1), a timer is moved down at most Levels times before it fires and empty stretches of
+// time are skipped with per-level occupancy bitmaps. A callback never runs before its deadline, and runs at most one
+// tick after the first Advance() that passes it.
+//
+// Everything except Post() must be called from the thread that owns the wheel; callbacks run on that thread and may
+// schedule or cancel timers. Post() may be called from any thread, it pushes onto a lock-free list that the owner
+// drains on its next Advance().
+class TimerWheel {
+public:
+  using timer_id = uint64_t;
+  using callback_t = std::function<void()>;
+  static constexpr timer_id InvalidTimer = 0;
+  static constexpr int LevelBits = 6;
+  static constexpr int Levels = 6;
+  static constexpr uint32_t Slots = 1U << LevelBits;
+
+  explicit TimerWheel(bela::Duration tick = bela::Milliseconds(1), bela::Duration start = bela::MonotonicNow());
+  TimerWheel(const TimerWheel &) = delete;
+  TimerWheel &operator=(const TimerWheel &) = delete;
+  ~TimerWheel();
+  // Schedule runs fn once delay has passed since Now()
+  timer_id Schedule(bela::Duration delay, callback_t fn) { return ScheduleAt(Now() + delay, std::move(fn)); }
+  // ScheduleAt runs fn once the wheel has advanced to deadline
+  timer_id ScheduleAt(bela::Duration deadline, callback_t fn);
+  // Cancel removes a pending timer, returns false when it already ran or was cancelled
+  bool Cancel(timer_id id);
+  // Post schedules fn delay after bela::MonotonicNow(); thread-safe and lock-free, the timer cannot be cancelled
+  void Post(bela::Duration delay, callback_t fn);
+  // Advance moves the wheel to now and runs every expired callback, returns the number of callbacks run
+  size_t Advance(bela::Duration now);
+  size_t Advance() { return Advance(bela::MonotonicNow()); }
+  // Run waits with bela::SleepFor (BelaInternalSleepFor) until the next deadline or at most maxWait, then advances.
+  // Timers posted from other threads while sleeping are picked up when the wait ends.
+  size_t Run(bela::Duration maxWait);
+  // NextDeadline returns a time no later than the earliest pending deadline, InfiniteDuration when idle
+  bela::Duration NextDeadline() const;
+  bela::Duration Now() const { return origin + tick * current; }
+  bela::Duration Tick() const { return tick; }
+  size_t Size() const { return size; }
+  bool Empty() const { return size == 0; }
+
+private:
+  static constexpr uint32_t npos = UINT32_MAX;
+  static constexpr uint32_t OverflowBucket = Levels * Slots;
+  static constexpr uint32_t ExpiringBucket = OverflowBucket + 1;
+  struct node {
+    callback_t fn;
+    int64_t expires{0};
+    uint32_t prev{npos};
+    uint32_t next{npos};
+    uint32_t bucket{npos};
+    uint32_t generation{1};
+  };
+  struct submission {
+    bela::Duration deadline;
+    callback_t fn;
+    submission *next{nullptr};
+  };
+  int64_t TicksCeil(bela::Duration d) const;
+  int64_t TicksFloor(bela::Duration d) const;
+  int64_t NextEventTick() const;
+  void Link(uint32_t index, uint32_t bucket);
+  void Unlink(uint32_t index);
+  void Place(uint32_t index);
+  void Release(uint32_t index);
+  void Cascade(uint32_t bucket);
+  size_t Expire();
+  void Drain();
+  bela::Duration tick;
+  bela::Duration origin;
+  int64_t current{0};
+  size_t size{0};
+  std::vector<node> nodes;
+  std::vector<uint32_t> freeNodes;
+  std::array<uint32_t, ExpiringBucket + 1> heads;
+  std::array<uint64_t, Levels> occupied{0};
+  std::atomic<submission *> submissions{nullptr};
+};
+} // namespace bela
+
+#endif
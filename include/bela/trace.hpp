@@ -0,0 +1,115 @@
+// Hot path tracing: scoped timers, counters and histograms with a Chrome trace export
+#ifndef BELA_TRACE_HPP
+#define BELA_TRACE_HPP
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "cycleclock.hpp"
+
+// Instrumentation is compiled in only when BELA_ENABLE_TRACE is defined (cmake -DBELA_ENABLE_TRACE=ON), otherwise the
+// macros expand to nothing and instrumented code is unchanged:
+//
+//  bool Reader::Initialize(bela::error_code &ec) {
+//    BELA_TRACE_SCOPE("zip.Reader.Initialize");
+//    ...
+//    BELA_TRACE_COUNT("zip.files", files.size());
+//    BELA_TRACE_HISTOGRAM("zip.directory_bytes", directorySize);
+//  }
+//
+// Names must be string literals, they are stored as pointers. Every thread records into its own buffer without locks:
+// a scope costs two timestamp counter reads and an append, a counter or histogram update one relaxed store. Collect and
+// ChromeTrace merge the buffers on demand and may run while other threads record.
+#define BELA_TRACE_CONCAT_INNER(a, b) a##b
+#define BELA_TRACE_CONCAT(a, b) BELA_TRACE_CONCAT_INNER(a, b)
+#if defined(BELA_ENABLE_TRACE)
+#define BELA_TRACE_SCOPE(name) ::bela::trace::Scope BELA_TRACE_CONCAT(bela_trace_scope_, __LINE__)(name)
+#define BELA_TRACE_COUNT(name, value)                                                                                  \
+  do {                                                                                                                 \
+    static constinit ::bela::trace::Site bela_trace_site{name};                                                        \
+    ::bela::trace::Count(bela_trace_site, static_cast<int64_t>(value));                                               \
+  } while (0)
+#define BELA_TRACE_HISTOGRAM(name, value)                                                                              \
+  do {                                                                                                                 \
+    static constinit ::bela::trace::Site bela_trace_site{name};                                                        \
+    ::bela::trace::Observe(bela_trace_site, static_cast<uint64_t>(value));                                            \
+  } while (0)
+#else
+#define BELA_TRACE_SCOPE(name) ((void)0)
+#define BELA_TRACE_COUNT(name, value) ((void)0)
+#define BELA_TRACE_HISTOGRAM(name, value) ((void)0)
+#endif
+
+namespace bela::trace {
+#if defined(BELA_ENABLE_TRACE)
+constexpr bool Enabled = true;
+#else
+constexpr bool Enabled = false;
+#endif
+// per buffer limits, events beyond the capacity are counted as dropped, sites beyond the limits are ignored
+constexpr size_t eventCapacity = 1 << 16;
+constexpr size_t maxCounters = 256;
+constexpr size_t maxHistograms = 64;
+// histogram bucket i counts values v with std::bit_width(v) == i: 0, 1, 2-3, 4-7 ... 2^63-(2^64-1)
+constexpr size_t histogramBuckets = 65;
+
+// Site is one counter or histogram call site, the id is assigned on first use
+struct Site {
+  constexpr Site(const char *name_) : name(name_) {}
+  Site(const Site &) = delete;
+  Site &operator=(const Site &) = delete;
+  const char *name;
+  std::atomic<uint32_t> id{0};
+};
+
+void Record(const char *name, int64_t start, int64_t end);
+void Count(Site &site, int64_t value);
+void Observe(Site &site, uint64_t value);
+
+// Scope records the time between its construction and destruction as one complete event
+class Scope {
+public:
+  explicit Scope(const char *name_) : name(name_), start(bela::CycleClock::Now()) {}
+  Scope(const Scope &) = delete;
+  Scope &operator=(const Scope &) = delete;
+  ~Scope() { Record(name, start, bela::CycleClock::Now()); }
+
+private:
+  const char *name;
+  int64_t start;
+};
+
+struct CounterValue {
+  std::string_view name;
+  int64_t value{0};
+};
+
+struct HistogramValue {
+  std::string_view name;
+  uint64_t count{0};
+  uint64_t sum{0};
+  std::array<uint64_t, histogramBuckets> buckets{};
+  // Percentile returns the upper bound of the bucket holding the p-th percentile, p in [0, 100]
+  uint64_t Percentile(double p) const;
+};
+
+// Report is the sum of every thread's counters and histograms, sorted by name
+struct Report {
+  std::vector<CounterValue> counters;
+  std::vector<HistogramValue> histograms;
+  uint64_t events{0};
+  uint64_t dropped{0};
+  uint32_t threads{0}; // thread buffers: a thread starting after another exited records into its buffer
+};
+
+Report Collect();
+// ChromeTrace encodes the recorded events and final counter values as Chrome trace JSON, load it in chrome://tracing
+// or https://ui.perfetto.dev
+std::string ChromeTrace();
+// Reset discards events, counters and histograms, no thread may record concurrently
+void Reset();
+} // namespace bela::trace
+
+#endif
@@ -1,13 +1,87 @@
 ///
 #ifndef BELA_UND_HPP
 #define BELA_UND_HPP
+#include <functional>
+#include <string>
 #include <string_view>
+#include <span>
+#include <vector>
 
 namespace llvm {
 std::string demangle(std::string_view MangledName);
 }
 namespace bela {
 using llvm::demangle;
-}
 
-#endif
\ No newline at end of file
+// DemangledNames stores demangled names back to back in one buffer, name i is buffer[offsets[i], offsets[i+1])
+struct DemangledNames {
+  std::string buffer;
+  std::vector<size_t> offsets{0};
+  size_t size() const { return offsets.size() - 1; }
+  bool empty() const { return offsets.size() == 1; }
+  std::string_view operator[](size_t i) const {
+    return std::string_view{buffer.data() + offsets[i], offsets[i + 1] - offsets[i]};
+  }
+  void clear() {
+    buffer.clear();
+    offsets.resize(1);
+  }
+};
+
+using text_sink_t = std::function<void(std::string_view)>;
+// DemangleText copies input to sink like c++filt, replacing every mangled name that starts at an identifier boundary
+// (_Z/__Z Itanium, _R Rust, _D D, ? Microsoft) with its demangled form. Candidates are located with a vectorized scan,
+// unchanged text larger than a few KB is handed to sink as slices of input, smaller pieces are batched. Returns the
+// number of names replaced.
+size_t DemangleText(std::string_view input, const text_sink_t &sink);
+
+// Demangler demangles Itanium, Microsoft, Rust and D names like bela::demangle, but keeps its parser, node arena and
+// output buffer between calls: an Itanium or Microsoft name is parsed into memory reused from the previous name and
+// printed without allocating once the buffers have grown. A Demangler is not thread-safe, use one per thread.
+class Demangler {
+public:
+  Demangler();
+  Demangler(const Demangler &) = delete;
+  Demangler &operator=(const Demangler &) = delete;
+  ~Demangler();
+  // Demangle returns the demangled name, or name itself when it cannot be demangled. The view is valid until the next
+  // call.
+  std::string_view Demangle(std::string_view name);
+  // Demangle appends the demangled form of every name to out
+  void Demangle(std::span<const std::string_view> names, DemangledNames &out);
+
+  // Parse parses an Itanium name into the arena without printing it, the queries below then walk the parsed tree.
+  // Returns false when name is not an Itanium name. The tree is valid until the next Parse or Demangle call.
+  bool Parse(std::string_view name);
+  bool IsFunction() const;
+  // IsData reports a variable, IsSpecialName a vtable, typeinfo, guard variable or thunk
+  bool IsData() const;
+  bool IsSpecialName() const;
+  bool IsCtorOrDtor() const;
+  size_t ParameterCount() const;
+  // InScope reports whether the entity is declared in scope ("std", "llvm::cl") or in a scope nested in it. Scopes
+  // are compared by identifier, template arguments of enclosing classes are ignored and nothing is printed.
+  bool InScope(std::string_view scope) const;
+  // BaseName returns the unqualified name without template arguments ("push_back", "~vector", "operator<<"), plain
+  // identifiers point into the mangled name, other names are printed into the output buffer.
+  std::string_view BaseName();
+  // Scope prints the enclosing scope with its template arguments, it is empty at global scope
+  std::string_view Scope();
+
+private:
+  friend size_t DemangleText(std::string_view input, const text_sink_t &sink);
+  struct Context;
+  bool NonMicrosoftDemangle(std::string_view name, bool canHaveLeadingDot);
+  bool MicrosoftDemangle(std::string_view name, size_t *consumed = nullptr);
+  Context *context{nullptr};
+  char *buffer{nullptr};
+  size_t capacity{0};
+  size_t length{0};
+};
+
+// DemangleAll demangles a whole symbol table. Repeated names are demangled once, unique names are spread over up to
+// concurrency threads (0: one per hardware thread) each with its own Demangler, results are in input order.
+DemangledNames DemangleAll(std::span<const std::string_view> names, size_t concurrency = 0);
+} // namespace bela
+
+#endif
@@ -0,0 +1,85 @@
+// TZif time zone database support
+#ifndef BELA_ZONEINFO_HPP
+#define BELA_ZONEINFO_HPP
+#include <atomic>
+#include <memory>
+#include <span>
+#include "datetime.hpp"
+#include "bytes_view.hpp"
+
+namespace bela {
+// https://www.rfc-editor.org/rfc/rfc8536
+// TimeZone holds the transitions of one zone loaded from a TZif (v1, v2 or v3) file. Offsets are in seconds east of
+// UTC (TZif convention); LocalDateTime() converts to the DateTime::TimeZoneOffset() convention. Leap second records
+// are ignored, bela::Time does not count leap seconds.
+class TimeZone {
+public:
+  struct zone_type {
+    std::int_least32_t offset{0};
+    bool dst{false};
+    std::string abbreviation;
+  };
+  // POSIX TZ footer rule (e.g. "CET-1CEST,M3.5.0,M10.5.0/3") used after the last transition
+  struct zone_rule {
+    struct boundary {
+      enum Kind : uint8_t { Julian, ZeroBasedDay, MonthWeekDay } kind{MonthWeekDay};
+      int16_t day{0};
+      uint8_t month{0};
+      uint8_t week{0};
+      std::int_least32_t time{7200};
+    };
+    std::string stdName;
+    std::string dstName;
+    std::int_least32_t stdOffset{0};
+    std::int_least32_t dstOffset{0};
+    uint8_t stdType{0};
+    uint8_t dstType{0};
+    bool hasDST{false};
+    boundary start;
+    boundary end;
+  };
+
+  TimeZone() = default;
+  TimeZone(const TimeZone &) = delete;
+  TimeZone &operator=(const TimeZone &) = delete;
+  // Parse parses a TZif image
+  static std::shared_ptr<TimeZone> Parse(std::wstring_view name, bela::bytes_view bv, bela::error_code &ec);
+  std::wstring_view Name() const { return name; }
+  // Offset returns the UTC offset in effect at unix second sec. Repeated or increasing lookups hit a cached position
+  // before falling back to binary search.
+  std::int_least32_t Offset(int64_t sec) const;
+  std::int_least32_t Offset(bela::Time t) const { return Offset(bela::Split(t).sec); }
+  // Lookup returns the local time type in effect at sec
+  const zone_type &Lookup(int64_t sec) const;
+  // Offsets resolves many timestamps; sorted input advances a cursor and costs a comparison per element
+  void Offsets(std::span<const int64_t> seconds, std::span<std::int_least32_t> out) const;
+  bela::DateTime LocalDateTime(bela::Time t) const {
+    auto offset = Offset(t);
+    return bela::DateTime(t + bela::Seconds(offset), -offset);
+  }
+  const auto &Transitions() const { return transitions; }
+  const auto &Types() const { return types; }
+
+private:
+  size_t Search(int64_t sec) const;
+  uint8_t RuleType(int64_t sec) const;
+  uint8_t TypeAt(size_t pos, int64_t sec) const;
+  bool ParseRule(std::string_view footer);
+  bool ExpandRule(int64_t untilYear, bela::error_code &ec);
+  std::wstring name;
+  std::vector<int64_t> transitions;
+  std::vector<uint8_t> indexes; // type index per transition
+  std::vector<zone_type> types;
+  std::optional<zone_rule> rule;
+  int64_t ruleStart{(std::numeric_limits<int64_t>::max)()}; // rule applies from here when table is exhausted
+  mutable std::atomic<size_t> hint{0};
+};
+
+// SetZoneInfoDirectory sets the directory holding TZif files (e.g. a tzdata 'zoneinfo' tree) and drops cached zones.
+// The default is the TZDIR environment variable.
+void SetZoneInfoDirectory(std::wstring_view dir);
+// LoadTimeZone loads name (e.g. "Asia/Shanghai") from the zoneinfo directory through a process-wide cache
+std::shared_ptr<const TimeZone> LoadTimeZone(std::wstring_view name, bela::error_code &ec);
+} // namespace bela
+
+#endif
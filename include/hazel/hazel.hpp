@@ -7,6 +7,7 @@
 #include <bela/buffer.hpp>
 #include <bela/time.hpp>
 #include <bela/io.hpp>
+#include <bela/batch_reader.hpp>
 #include "types.hpp"
 
 namespace hazel {
@@ -27,6 +28,11 @@ template <class... Ts> overloaded(Ts...) -> overloaded<Ts...>;
 class hazel_result;
 bool LookupFile(const bela::io::FD &fd, hazel_result &hr, bela::error_code &ec, int64_t offset = 0);
 bool LookupBytes(const bela::bytes_view &bv, hazel_result &hr, bela::error_code &ec);
+// LookupFiles classifies many files through bela::io::BatchReader; fn is called once per file in completion order with
+// the index of the file in files. Detection overlaps with the reads that are still in flight.
+using lookup_files_callback_t = std::function<void(size_t index, hazel_result &hr, const bela::error_code &ec)>;
+bool LookupFiles(std::span<const std::wstring> files, const lookup_files_callback_t &fn, bela::error_code &ec,
+                 int64_t offset = 0);
 using hazel_value_t = std::variant<std::string, std::wstring, std::vector<std::string>, std::vector<std::wstring>,
                                    int16_t, int32_t, int64_t, uint16_t, uint32_t, uint64_t, bela::Time>;
 class hazel_result {
@@ -109,6 +115,8 @@ public:
 private:
   friend bool LookupBytes(const bela::bytes_view &bv, hazel_result &hr, bela::error_code &ec);
   friend bool LookupFile(const bela::io::FD &fd, hazel_result &hr, bela::error_code &ec, int64_t offset);
+  friend bool LookupFiles(std::span<const std::wstring> files, const lookup_files_callback_t &fn, bela::error_code &ec,
+                          int64_t offset);
   std::wstring description_;
   bela::flat_hash_map<std::wstring, hazel_value_t> values_;
   int64_t size_{bela::SizeUnInitialized};
@@ -1,6 +1,8 @@
 //
 #ifndef HAZEL_ZIP_HPP
 #define HAZEL_ZIP_HPP
+#include <memory>
+#include <memory_resource>
 #include <span>
 #include <bela/base.hpp>
 #include <bela/buffer.hpp>
@@ -73,9 +75,11 @@ inline const char *AESStrength(uint8_t i) {
 using bela::os::FileMode;
 
 struct File {
-  std::string name;              /* filename */
-  std::string comment;           /* comment */
-  std::string linkname;          /* link name */
+  File() = default;
+  explicit File(std::pmr::memory_resource *mr) : name(mr), comment(mr), linkname(mr) {}
+  std::pmr::string name;         /* filename */
+  std::pmr::string comment;      /* comment */
+  std::pmr::string linkname;     /* link name */
   uint64_t compressed_size{0};   /* compressed size */
   uint64_t uncompressed_size{0}; /* uncompressed size */
   uint64_t position{0};          /* file position */
@@ -116,22 +120,32 @@ enum zip_conatiner_t : int {
 class Reader {
 private:
   void MoveFrom(Reader &&r) {
-    r.fd = std::move(fd);
+    baseOffset = r.baseOffset;
+    r.baseOffset = 0;
     size = r.size;
     r.size = 0;
     uncompressed_size = r.uncompressed_size;
     r.uncompressed_size = 0;
     compressed_size = r.compressed_size;
     r.compressed_size = 0;
-    comment = std::move(r.comment);
-    files = std::move(r.files);
   }
 
 public:
   Reader() = default;
-  Reader(Reader &&r) noexcept { MoveFrom(std::move(r)); }
-  Reader &operator=(Reader &&r) noexcept {
+  // Reader allocates the file table, names and comments from mr, bela::alloc_stats::CountingResource measures them
+  explicit Reader(std::pmr::memory_resource *mr) : resource(mr), comment(mr), files(mr) {}
+  // the containers are move constructed on the resource of r: they take its memory, nothing is copied
+  Reader(Reader &&r) noexcept
+      : fd(std::move(r.fd)), resource(r.resource), comment(std::move(r.comment)), files(std::move(r.files)) {
     MoveFrom(std::move(r));
+  }
+  // polymorphic_allocator does not propagate on assignment, which would copy element by element between resources:
+  // the reader is rebuilt on the resource of r instead
+  Reader &operator=(Reader &&r) noexcept {
+    if (this != &r) {
+      std::destroy_at(this);
+      std::construct_at(this, std::move(r));
+    }
     return *this;
   }
   ~Reader() = default;
@@ -158,8 +172,9 @@ public:
 private:
   bela::io::FD fd;
   int64_t baseOffset{0};
-  std::string comment;
-  std::vector<File> files;
+  std::pmr::memory_resource *resource{std::pmr::get_default_resource()};
+  std::pmr::string comment;
+  std::pmr::vector<File> files;
   int64_t size{bela::SizeUnInitialized};
   int64_t uncompressed_size{0};
   int64_t compressed_size{0};
@@ -0,0 +1,190 @@
+//
+#include <bela/alloc_stats.hpp>
+#include <algorithm>
+#include <memory>
+#include <mutex>
+
+namespace bela::alloc_stats {
+namespace {
+// thread_counts is written by its thread only, with relaxed load and store, and read by Collect at any time
+struct thread_counts {
+  std::atomic<uint64_t> allocations[maxTags]{};
+  std::atomic<uint64_t> deallocations[maxTags]{};
+  std::atomic<uint64_t> bytes[maxTags]{};
+  std::atomic<int64_t> live[maxTags]{};
+  std::atomic<int64_t> peak[maxTags]{};
+};
+
+template <typename T> void Add(std::atomic<T> &a, T v) {
+  a.store(a.load(std::memory_order_relaxed) + v, std::memory_order_relaxed);
+}
+
+void RaisePeak(std::atomic<int64_t> &peak, int64_t value) {
+  auto current = peak.load(std::memory_order_relaxed);
+  while (current < value && !peak.compare_exchange_weak(current, value, std::memory_order_relaxed)) {
+  }
+}
+
+// registry owns the counts of every thread that allocated through a tag. When a thread exits its counts are folded into
+// retired and the block is handed to the next new thread: memory is bounded by the threads allocating at the same time,
+// not by the threads created.
+class registry {
+public:
+  static registry &Instance() {
+    static auto *r = new registry(); // never destroyed: containers may free memory during static destruction
+    return *r;
+  }
+  thread_counts *NewCounts() {
+    std::scoped_lock lock(mu);
+    if (!unused.empty()) {
+      auto *c = unused.back();
+      unused.pop_back();
+      return c;
+    }
+    return threads.emplace_back(std::make_unique<thread_counts>()).get();
+  }
+  // ReleaseCounts retires the counts of an exiting thread, under mu so Report sees them either in c or in retired
+  void ReleaseCounts(thread_counts *c) {
+    std::scoped_lock lock(mu);
+    for (size_t i = 0; i < maxTags; i++) {
+      Add(retired.allocations[i], c->allocations[i].exchange(0, std::memory_order_relaxed));
+      Add(retired.deallocations[i], c->deallocations[i].exchange(0, std::memory_order_relaxed));
+      Add(retired.bytes[i], c->bytes[i].exchange(0, std::memory_order_relaxed));
+      c->live[i].store(0, std::memory_order_relaxed);
+      c->peak[i].store(0, std::memory_order_relaxed);
+    }
+    unused.emplace_back(c);
+  }
+  uint32_t Register(Tag &tag) {
+    std::scoped_lock lock(mu);
+    if (auto id = tag.id.load(std::memory_order_relaxed); id != 0) {
+      return id;
+    }
+    uint32_t id = static_cast<uint32_t>(maxTags + 1);
+    if (tags.size() < maxTags) {
+      tags.emplace_back(&tag);
+      id = static_cast<uint32_t>(tags.size());
+    }
+    tag.id.store(id, std::memory_order_release);
+    return id;
+  }
+  std::vector<Stats> Report(const thread_counts *only) {
+    std::scoped_lock lock(mu);
+    std::vector<Stats> stats;
+    for (size_t i = 0; i < tags.size(); i++) {
+      Stats s{.name = tags[i]->name};
+      auto add = [&](const thread_counts &c) {
+        s.allocations += c.allocations[i].load(std::memory_order_relaxed);
+        s.deallocations += c.deallocations[i].load(std::memory_order_relaxed);
+        s.bytes += c.bytes[i].load(std::memory_order_relaxed);
+      };
+      if (only != nullptr) {
+        add(*only);
+        s.live = only->live[i].load(std::memory_order_relaxed);
+        s.peak = only->peak[i].load(std::memory_order_relaxed);
+      } else {
+        add(retired);
+        for (const auto &c : threads) {
+          add(*c);
+        }
+        s.live = tags[i]->live.load(std::memory_order_relaxed);
+        s.peak = tags[i]->peak.load(std::memory_order_relaxed);
+      }
+      stats.emplace_back(s);
+    }
+    std::sort(stats.begin(), stats.end(), [](const auto &a, const auto &b) { return a.name < b.name; });
+    return stats;
+  }
+  void Reset() {
+    std::scoped_lock lock(mu);
+    for (size_t i = 0; i < maxTags; i++) {
+      retired.allocations[i].store(0, std::memory_order_relaxed);
+      retired.deallocations[i].store(0, std::memory_order_relaxed);
+      retired.bytes[i].store(0, std::memory_order_relaxed);
+    }
+    for (auto &c : threads) {
+      for (size_t i = 0; i < maxTags; i++) {
+        c->allocations[i].store(0, std::memory_order_relaxed);
+        c->deallocations[i].store(0, std::memory_order_relaxed);
+        c->bytes[i].store(0, std::memory_order_relaxed);
+        c->peak[i].store(c->live[i].load(std::memory_order_relaxed), std::memory_order_relaxed);
+      }
+    }
+    for (auto *t : tags) {
+      t->peak.store(t->live.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    }
+  }
+
+private:
+  registry() = default;
+  std::mutex mu;
+  std::vector<Tag *> tags;
+  std::vector<std::unique_ptr<thread_counts>> threads;
+  std::vector<thread_counts *> unused; // blocks of exited threads
+  thread_counts retired;               // allocations, deallocations and bytes of exited threads
+};
+
+constinit thread_local thread_counts *current = nullptr;
+
+// counts_releaser retires the counts of its thread when the thread exits, current stays trivially destructible
+struct counts_releaser {
+  ~counts_releaser() {
+    if (current != nullptr) {
+      registry::Instance().ReleaseCounts(current);
+      current = nullptr;
+    }
+  }
+};
+
+thread_counts *Counts() {
+  if (current == nullptr) {
+    current = registry::Instance().NewCounts();
+    // a thread allocating again after its releaser ran keeps the new block for good
+    static thread_local counts_releaser releaser;
+  }
+  return current;
+}
+
+uint32_t TagId(Tag &tag) {
+  if (auto id = tag.id.load(std::memory_order_acquire); id != 0) {
+    return id;
+  }
+  return registry::Instance().Register(tag);
+}
+} // namespace
+
+void RecordAllocate(Tag &tag, size_t bytes) {
+  auto n = static_cast<int64_t>(bytes);
+  RaisePeak(tag.peak, tag.live.fetch_add(n, std::memory_order_relaxed) + n);
+  auto id = TagId(tag);
+  if (id > maxTags) {
+    return;
+  }
+  auto *c = Counts();
+  auto i = id - 1;
+  Add<uint64_t>(c->allocations[i], 1);
+  Add<uint64_t>(c->bytes[i], bytes);
+  Add(c->live[i], n);
+  if (auto live = c->live[i].load(std::memory_order_relaxed); live > c->peak[i].load(std::memory_order_relaxed)) {
+    c->peak[i].store(live, std::memory_order_relaxed);
+  }
+}
+
+void RecordDeallocate(Tag &tag, size_t bytes) {
+  auto n = static_cast<int64_t>(bytes);
+  tag.live.fetch_sub(n, std::memory_order_relaxed);
+  auto id = TagId(tag);
+  if (id > maxTags) {
+    return;
+  }
+  auto *c = Counts();
+  Add<uint64_t>(c->deallocations[id - 1], 1);
+  Add(c->live[id - 1], -n);
+}
+
+std::vector<Stats> ThreadReport() { return registry::Instance().Report(Counts()); }
+
+std::vector<Stats> Collect() { return registry::Instance().Report(nullptr); }
+
+void Reset() { registry::Instance().Reset(); }
+} // namespace bela::alloc_stats
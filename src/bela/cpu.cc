@@ -0,0 +1,137 @@
+//
+#include <bela/cpu.hpp>
+#if defined(_M_X64) || defined(__x86_64__) || defined(_M_IX86) || defined(__i386__)
+#define BELA_CPU_X86 1
+#if defined(_MSC_VER)
+#include <intrin.h>
+#include <immintrin.h>
+#else
+#include <cpuid.h>
+#endif
+#elif defined(_M_ARM64) || defined(__aarch64__)
+#define BELA_CPU_ARM64 1
+#if defined(_WIN32)
+#include <windows.h>
+#endif
+#endif
+
+namespace bela::cpu {
+namespace {
+#if defined(BELA_CPU_X86)
+// XCR0 tells which register states the operating system saves on a context switch
+uint64_t XCR0() {
+#if defined(_MSC_VER)
+  return _xgetbv(0);
+#else
+  uint32_t eax = 0;
+  uint32_t edx = 0;
+  __asm__ __volatile__("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+  return (static_cast<uint64_t>(edx) << 32) | eax;
+#endif
+}
+
+constexpr bool Bit(uint32_t reg, int bit) { return (reg & (1U << bit)) != 0; }
+
+uint64_t Detect() {
+  uint64_t features = 0;
+  uint32_t regs[4] = {0};
+  CPUID(0, 0, regs);
+  const auto maxLeaf = regs[0];
+  if (maxLeaf < 1) {
+    return features;
+  }
+  CPUID(1, 0, regs);
+  const auto ecx1 = regs[2];
+  const auto edx1 = regs[3];
+  auto set = [&](bool present, Feature f) {
+    if (present) {
+      features |= f;
+    }
+  };
+  set(Bit(edx1, 26), SSE2);
+  set(Bit(ecx1, 9), SSSE3);
+  set(Bit(ecx1, 19), SSE41);
+  set(Bit(ecx1, 20), SSE42);
+  set(Bit(ecx1, 23), POPCNT);
+  set(Bit(ecx1, 1), PCLMUL);
+  set(Bit(ecx1, 25), AES);
+  // the CPU may support AVX while the OS does not save ymm/zmm registers, using them then corrupts other threads
+  const auto xcr0 = Bit(ecx1, 27) ? XCR0() : 0; // OSXSAVE
+  const bool ymm = (xcr0 & 0x6) == 0x6;         // xmm and ymm state
+  const bool zmm = (xcr0 & 0xE6) == 0xE6;       // and opmask, upper zmm and zmm16-31 state
+  set(ymm && Bit(ecx1, 28), AVX);
+  set(ymm && Bit(ecx1, 12), FMA);
+  if (maxLeaf < 7) {
+    return features;
+  }
+  CPUID(7, 0, regs);
+  const auto ebx7 = regs[1];
+  set(Bit(ebx7, 3), BMI1);
+  set(Bit(ebx7, 8), BMI2);
+  set(Bit(ebx7, 29), SHA);
+  set(ymm && (features & AVX) != 0 && Bit(ebx7, 5), AVX2);
+  set(zmm && Bit(ebx7, 16), AVX512F);
+  set(zmm && Bit(ebx7, 16) && Bit(ebx7, 30), AVX512BW);
+  set(zmm && Bit(ebx7, 16) && Bit(ebx7, 31), AVX512VL);
+  return features;
+}
+#elif defined(BELA_CPU_ARM64)
+uint64_t Detect() {
+  // Advanced SIMD is mandatory on AArch64
+  uint64_t features = NEON;
+#if defined(_WIN32)
+  if (IsProcessorFeaturePresent(PF_ARM_V8_CRYPTO_INSTRUCTIONS_AVAILABLE)) {
+    features |= SHA | AES | PCLMUL;
+  }
+  if (IsProcessorFeaturePresent(PF_ARM_V8_CRC32_INSTRUCTIONS_AVAILABLE)) {
+    features |= CRC32;
+  }
+#endif
+  return features;
+}
+#else
+uint64_t Detect() { return 0; }
+#endif
+
+struct feature_name {
+  Feature feature;
+  std::string_view name;
+};
+
+constexpr feature_name featureNames[] = {
+    {SSE2, "sse2"},         {SSSE3, "ssse3"},       {SSE41, "sse4.1"},      {SSE42, "sse4.2"}, {POPCNT, "popcnt"},
+    {AVX, "avx"},           {AVX2, "avx2"},         {FMA, "fma"},           {BMI1, "bmi1"},    {BMI2, "bmi2"},
+    {AVX512F, "avx512f"},   {AVX512BW, "avx512bw"}, {AVX512VL, "avx512vl"}, {SHA, "sha"},      {PCLMUL, "pclmul"},
+    {AES, "aes"},           {NEON, "neon"},         {CRC32, "crc32"},
+};
+} // namespace
+
+#if defined(BELA_CPU_X86)
+void CPUID(uint32_t leaf, uint32_t subleaf, uint32_t regs[4]) {
+#if defined(_MSC_VER)
+  __cpuidex(reinterpret_cast<int *>(regs), static_cast<int>(leaf), static_cast<int>(subleaf));
+#else
+  __cpuid_count(leaf, subleaf, regs[0], regs[1], regs[2], regs[3]);
+#endif
+}
+#endif
+
+uint64_t Features() {
+  static const uint64_t features = Detect();
+  return features;
+}
+
+std::string FeatureNames(uint64_t mask) {
+  std::string names;
+  for (const auto &f : featureNames) {
+    if ((mask & f.feature) == 0) {
+      continue;
+    }
+    if (!names.empty()) {
+      names += ' ';
+    }
+    names += f.name;
+  }
+  return names;
+}
+} // namespace bela::cpu
@@ -32,6 +32,7 @@
 // ---------------------------------------------------------------------------
 #include <bela/match.hpp>
 #include <bela/ascii.hpp>
+#include <bela/int128.hpp>
 
 namespace bela {
 namespace strings_internal {
@@ -54,6 +55,62 @@ constexpr int memcasecmp(const char *s1, const char *s2, size_t len) noexcept {
   }
   return 0;
 }
+
+// Fold16 and Fold8 lower-case the ASCII letters in every 16-bit (8-bit) lane of a word: masking the top bit keeps the
+// range checks from carrying into the next lane, lanes with the top bit set are never letters.
+constexpr uint64_t Fold16(uint64_t x) {
+  constexpr uint64_t lanes = 0x0001000100010001ULL;
+  const auto low = x & (0x7FFF * lanes);
+  const auto geA = low + (0x8000 - 'A') * lanes;
+  const auto gtZ = low + (0x8000 - 'Z' - 1) * lanes;
+  return x | (((geA & ~gtZ & ~x) & (0x8000 * lanes)) >> 10);
+}
+
+constexpr uint64_t Fold8(uint64_t x) {
+  constexpr uint64_t lanes = 0x0101010101010101ULL;
+  const auto low = x & (0x7F * lanes);
+  const auto geA = low + (0x80 - 'A') * lanes;
+  const auto gtZ = low + (0x80 - 'Z' - 1) * lanes;
+  return x | (((geA & ~gtZ & ~x) & (0x80 * lanes)) >> 2);
+}
+
+// Mix multiplies to 128 bits and folds the halves (the wyhash/abseil mixer)
+inline uint64_t Mix(uint64_t a, uint64_t b) {
+  const auto m = bela::uint128(a) * b;
+  return bela::Uint128Low64(m) ^ bela::Uint128High64(m);
+}
+
+inline uint64_t Load64(const uint8_t *p) {
+  uint64_t v;
+  std::memcpy(&v, p, sizeof(v));
+  return v;
+}
+
+constexpr uint64_t kHashSeed[] = {0xa0761d6478bd642fULL, 0xe7037ed1a0b428dbULL, 0x8ebc6af09c88c6e3ULL,
+                                  0x589965cc75374cc3ULL, 0x1d8e4e27c47d124fULL};
+
+// HashFolded hashes len bytes, fold is applied to every 8-byte word before it is mixed. Two independent lanes consume
+// 32 bytes per step, the tail is zero padded and the length goes into the finalizer.
+template <uint64_t (*fold)(uint64_t)> uint64_t HashFolded(const uint8_t *p, size_t len) {
+  auto s0 = kHashSeed[0];
+  auto s1 = kHashSeed[1];
+  const auto size = len;
+  for (; len >= 32; len -= 32, p += 32) {
+    s0 = Mix(fold(Load64(p)) ^ s0, fold(Load64(p + 8)) ^ kHashSeed[2]);
+    s1 = Mix(fold(Load64(p + 16)) ^ s1, fold(Load64(p + 24)) ^ kHashSeed[3]);
+  }
+  if (len >= 16) {
+    s0 = Mix(fold(Load64(p)) ^ s0, fold(Load64(p + 8)) ^ kHashSeed[2]);
+    len -= 16;
+    p += 16;
+  }
+  if (len != 0) {
+    uint8_t tail[16] = {0};
+    std::memcpy(tail, p, len);
+    s1 = Mix(fold(Load64(tail)) ^ s1, fold(Load64(tail + 8)) ^ kHashSeed[3]);
+  }
+  return Mix(s0 ^ kHashSeed[4], s1 ^ size);
+}
 } // namespace strings_internal
 
 bool EqualsIgnoreCase(std::wstring_view piece1, std::wstring_view piece2) noexcept {
@@ -67,6 +124,12 @@ bool EndsWithIgnoreCase(std::wstring_view text, std::wstring_view suffix) noexce
   return (text.size() >= suffix.size()) && EqualsIgnoreCase(text.substr(text.size() - suffix.size()), suffix);
 }
 
+size_t HashIgnoreCase(std::wstring_view text) noexcept {
+  static_assert(sizeof(wchar_t) == 2, "HashIgnoreCase folds UTF-16 code units");
+  return static_cast<size_t>(strings_internal::HashFolded<strings_internal::Fold16>(
+      reinterpret_cast<const uint8_t *>(text.data()), text.size() * sizeof(wchar_t)));
+}
+
 bool EqualsIgnoreCase(std::string_view piece1, std::string_view piece2) noexcept {
   return (piece1.size() == piece2.size() &&
           strings_internal::memcasecmp(piece1.data(), piece2.data(), piece1.size()) == 0);
@@ -78,4 +141,9 @@ bool EndsWithIgnoreCase(std::string_view text, std::string_view suffix) noexcept
   return (text.size() >= suffix.size()) && EqualsIgnoreCase(text.substr(text.size() - suffix.size()), suffix);
 }
 
+size_t HashIgnoreCase(std::string_view text) noexcept {
+  return static_cast<size_t>(strings_internal::HashFolded<strings_internal::Fold8>(
+      reinterpret_cast<const uint8_t *>(text.data()), text.size()));
+}
+
 } // namespace bela
@@ -0,0 +1,322 @@
+//
+#include <bela/thread_pool.hpp>
+#include <thread>
+#include <utility>
+
+namespace bela {
+namespace pool_internal {
+// work_deque is the Chase-Lev deque with the memory orderings of Le, Pop, Cohen and Zappa Nardelli, "Correct and
+// Efficient Work-Stealing for Weak Memory Models". The owner pushes and pops at the bottom, thieves take from the top.
+// A full ring is replaced by one twice as large, old rings are kept until the deque is destroyed because a thief may
+// still read from them.
+class work_deque {
+public:
+  work_deque() { array.store(Grow(nullptr, 0, 0), std::memory_order_relaxed); }
+  work_deque(const work_deque &) = delete;
+  work_deque &operator=(const work_deque &) = delete;
+
+  void Push(task *t) {
+    auto b = bottom.load(std::memory_order_relaxed);
+    auto tp = top.load(std::memory_order_acquire);
+    auto *a = array.load(std::memory_order_relaxed);
+    if (b - tp > a->mask) {
+      a = Grow(a, tp, b);
+      array.store(a, std::memory_order_release);
+    }
+    a->Put(b, t);
+    // publishes the slot to thieves, which read bottom with acquire
+    bottom.store(b + 1, std::memory_order_release);
+  }
+
+  task *Pop() {
+    auto b = bottom.load(std::memory_order_relaxed) - 1;
+    auto *a = array.load(std::memory_order_relaxed);
+    bottom.store(b, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    auto tp = top.load(std::memory_order_relaxed);
+    if (tp > b) {
+      bottom.store(b + 1, std::memory_order_relaxed);
+      return nullptr;
+    }
+    auto *t = a->Get(b);
+    if (tp == b) {
+      // the last task, race the thieves for it
+      if (!top.compare_exchange_strong(tp, tp + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+        t = nullptr;
+      }
+      bottom.store(b + 1, std::memory_order_relaxed);
+    }
+    return t;
+  }
+
+  task *Steal() {
+    auto tp = top.load(std::memory_order_acquire);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    auto b = bottom.load(std::memory_order_acquire);
+    if (tp >= b) {
+      return nullptr;
+    }
+    auto *t = array.load(std::memory_order_acquire)->Get(tp);
+    if (!top.compare_exchange_strong(tp, tp + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+      // another thief (or the owner) took it
+      return nullptr;
+    }
+    return t;
+  }
+
+private:
+  struct ring {
+    explicit ring(int64_t capacity) : mask(capacity - 1), slots(new std::atomic<task *>[capacity]) {}
+    task *Get(int64_t i) const { return slots[i & mask].load(std::memory_order_relaxed); }
+    void Put(int64_t i, task *t) { slots[i & mask].store(t, std::memory_order_relaxed); }
+    const int64_t mask;
+    std::unique_ptr<std::atomic<task *>[]> slots;
+  };
+  ring *Grow(const ring *old, int64_t tp, int64_t b) {
+    rings.emplace_back(std::make_unique<ring>(old == nullptr ? 256 : (old->mask + 1) * 2));
+    auto *a = rings.back().get();
+    for (auto i = tp; i < b; i++) {
+      a->Put(i, old->Get(i));
+    }
+    return a;
+  }
+  alignas(64) std::atomic<int64_t> top{0};
+  alignas(64) std::atomic<int64_t> bottom{0};
+  std::atomic<ring *> array;
+  // owned by the owner thread
+  std::vector<std::unique_ptr<ring>> rings;
+};
+
+struct alignas(64) worker {
+  work_deque deque;
+  std::thread thread;
+  // victim selection, only used by the worker itself
+  uint64_t seed{0};
+};
+
+// the pool and worker the calling thread belongs to, if any
+struct worker_context {
+  ThreadPool *pool{nullptr};
+  worker *self{nullptr};
+};
+thread_local worker_context current;
+
+// spin rounds of an idle worker before it sleeps
+constexpr int idleSpins = 64;
+
+inline void RunDetached(task_t &fn) noexcept { fn(); }
+} // namespace pool_internal
+
+ThreadPool::ThreadPool(size_t concurrency) {
+  if (concurrency == 0) {
+    concurrency = (std::max)(std::thread::hardware_concurrency(), 1U);
+  }
+  for (size_t i = 0; i < concurrency; i++) {
+    workers.emplace_back(std::make_unique<pool_internal::worker>());
+    workers.back()->seed = i * 0x9E3779B97F4A7C15ULL + 1;
+  }
+  // every deque exists before the first worker starts stealing
+  for (auto &w : workers) {
+    w->thread = std::thread([this, self = w.get()] { Work(self); });
+  }
+}
+
+ThreadPool::~ThreadPool() {
+  {
+    std::lock_guard lock(sleepMutex);
+    stopping = true;
+  }
+  sleepCond.notify_all();
+  for (auto &w : workers) {
+    w->thread.join();
+  }
+}
+
+ThreadPool &ThreadPool::Default() {
+  static auto *pool = new ThreadPool();
+  return *pool;
+}
+
+void ThreadPool::Submit(task_t fn) { Push(new pool_internal::task{std::move(fn), nullptr}); }
+
+void ThreadPool::Push(pool_internal::task *t) {
+  if (pool_internal::current.pool == this) {
+    pool_internal::current.self->deque.Push(t);
+  } else {
+    std::lock_guard lock(injectedMutex);
+    injected.emplace_back(t);
+    injectedSize.fetch_add(1, std::memory_order_relaxed);
+  }
+  // pairs with the fence of a worker going to sleep: either it sees the task or we see it sleeping
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  if (sleepers.load(std::memory_order_relaxed) != 0) {
+    {
+      std::lock_guard lock(sleepMutex);
+      epoch++;
+    }
+    sleepCond.notify_one();
+  }
+}
+
+pool_internal::task *ThreadPool::Find(pool_internal::worker *self) {
+  if (self != nullptr) {
+    if (auto *t = self->deque.Pop(); t != nullptr) {
+      return t;
+    }
+  }
+  if (injectedSize.load(std::memory_order_relaxed) != 0) {
+    std::lock_guard lock(injectedMutex);
+    if (!injected.empty()) {
+      auto *t = injected.front();
+      injected.pop_front();
+      injectedSize.fetch_sub(1, std::memory_order_relaxed);
+      return t;
+    }
+  }
+  auto n = workers.size();
+  size_t start = 0;
+  if (self != nullptr) {
+    // xorshift, a different first victim for every attempt
+    self->seed ^= self->seed << 13;
+    self->seed ^= self->seed >> 7;
+    self->seed ^= self->seed << 17;
+    start = static_cast<size_t>(self->seed % n);
+  }
+  for (size_t i = 0; i < n; i++) {
+    auto *victim = workers[(start + i) % n].get();
+    if (victim == self) {
+      continue;
+    }
+    if (auto *t = victim->deque.Steal(); t != nullptr) {
+      return t;
+    }
+  }
+  return nullptr;
+}
+
+void ThreadPool::Execute(pool_internal::task *t) {
+  std::unique_ptr<pool_internal::task> owned(t);
+  auto *group = t->group;
+  if (group == nullptr) {
+    pool_internal::RunDetached(t->fn);
+    return;
+  }
+  std::exception_ptr error;
+  if (!group->Cancelled()) {
+    try {
+      t->fn();
+    } catch (...) {
+      error = std::current_exception();
+    }
+  }
+  // captures may refer to the waiter's frame, release them before the group can complete
+  owned.reset();
+  group->Finish(error);
+}
+
+bool ThreadPool::RunOne() {
+  auto *self = pool_internal::current.pool == this ? pool_internal::current.self : nullptr;
+  auto *t = Find(self);
+  if (t == nullptr) {
+    return false;
+  }
+  Execute(t);
+  return true;
+}
+
+void ThreadPool::Work(pool_internal::worker *self) {
+  pool_internal::current = {this, self};
+  for (;;) {
+    pool_internal::task *t = nullptr;
+    for (int i = 0; i < pool_internal::idleSpins && t == nullptr; i++) {
+      if (t = Find(self); t == nullptr) {
+        std::this_thread::yield();
+      }
+    }
+    if (t != nullptr) {
+      Execute(t);
+      continue;
+    }
+    std::unique_lock lock(sleepMutex);
+    if (stopping) {
+      // every task reachable by this worker has run, the others drain their own deques
+      return;
+    }
+    auto e = epoch;
+    sleepers.fetch_add(1, std::memory_order_relaxed);
+    lock.unlock();
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (t = Find(self); t == nullptr) {
+      lock.lock();
+      sleepCond.wait(lock, [&] { return epoch != e || stopping; });
+      lock.unlock();
+    }
+    sleepers.fetch_sub(1, std::memory_order_relaxed);
+    if (t != nullptr) {
+      Execute(t);
+    }
+  }
+}
+
+TaskGroup::~TaskGroup() {
+  try {
+    Wait();
+  } catch (...) {
+  }
+}
+
+void TaskGroup::Run(task_t fn) {
+  // a task that failed to queue must not stay pending, Wait and ~TaskGroup would never see it finish
+  auto *t = new pool_internal::task{std::move(fn), this};
+  if (pending.fetch_add(1, std::memory_order_relaxed) == 0) {
+    std::lock_guard lock(mutex);
+    idle = false;
+  }
+  try {
+    pool.Push(t);
+  } catch (...) {
+    delete t;
+    Finish(nullptr);
+    throw;
+  }
+}
+
+void TaskGroup::Finish(std::exception_ptr e) {
+  if (e) {
+    {
+      std::lock_guard lock(mutex);
+      if (!error) {
+        error = e;
+      }
+    }
+    Cancel();
+  }
+  if (pending.fetch_sub(1, std::memory_order_acq_rel) != 1) {
+    return;
+  }
+  std::lock_guard lock(mutex);
+  // a task may have been added since pending dropped to zero, then that task completes the group
+  if (pending.load(std::memory_order_acquire) == 0) {
+    idle = true;
+    cond.notify_all();
+  }
+}
+
+void TaskGroup::Wait() {
+  // help while tasks of the pool are pending, then sleep until the last task of the group finished
+  for (int spins = 0; pending.load(std::memory_order_acquire) != 0 && spins < pool_internal::idleSpins;) {
+    if (pool.RunOne()) {
+      spins = 0;
+      continue;
+    }
+    spins++;
+    std::this_thread::yield();
+  }
+  std::unique_lock lock(mutex);
+  cond.wait(lock, [&] { return idle; });
+  if (auto e = std::exchange(error, nullptr); e) {
+    std::rethrow_exception(e);
+  }
+}
+
+} // namespace bela
@@ -0,0 +1,312 @@
+//
+#include <bela/trace.hpp>
+#include <bela/str_cat.hpp>
+#include <algorithm>
+#include <bit>
+#include <chrono>
+#include <memory>
+#include <mutex>
+
+namespace bela::trace {
+namespace {
+struct event {
+  const char *name;
+  int64_t start;
+  int64_t end;
+};
+
+// thread_buffer is written by its thread only. Events are published by the release store of size, counters and
+// histograms are single writer atomics updated with relaxed load and store, readers may run at any time.
+struct thread_buffer {
+  explicit thread_buffer(uint32_t tid_) : tid(tid_), events(std::make_unique<event[]>(eventCapacity)) {}
+  uint32_t tid;
+  std::atomic<size_t> size{0};
+  std::atomic<uint64_t> dropped{0};
+  std::unique_ptr<event[]> events;
+  std::atomic<int64_t> counters[maxCounters]{};
+  std::atomic<uint64_t> counts[maxHistograms]{};
+  std::atomic<uint64_t> sums[maxHistograms]{};
+  std::atomic<uint64_t> buckets[maxHistograms][histogramBuckets]{};
+};
+
+// Add is an increment by the only writer: a plain load and store, no locked instruction
+template <typename T> void Add(std::atomic<T> &a, T v) {
+  a.store(a.load(std::memory_order_relaxed) + v, std::memory_order_relaxed);
+}
+
+// registry owns the buffers of every thread that recorded, buffers outlive their threads so a trace can be exported
+// after a pool shut down. The buffer of an exited thread is handed to the next new thread, which appends to its events
+// and adds to its counters: memory is bounded by the threads recording at the same time, not by the threads created.
+class registry {
+public:
+  static registry &Instance() {
+    static auto *r = new registry(); // never destroyed: threads may record during static destruction
+    return *r;
+  }
+  thread_buffer *AcquireBuffer() {
+    std::scoped_lock lock(mu);
+    if (!unused.empty()) {
+      auto *b = unused.back();
+      unused.pop_back();
+      return b;
+    }
+    if (buffers.empty()) {
+      epochTicks = bela::CycleClock::Now();
+      epochTime = std::chrono::steady_clock::now();
+    }
+    return buffers.emplace_back(std::make_unique<thread_buffer>(static_cast<uint32_t>(buffers.size() + 1))).get();
+  }
+  void ReleaseBuffer(thread_buffer *b) {
+    std::scoped_lock lock(mu);
+    unused.emplace_back(b);
+  }
+  // Register assigns an id to a site, sites with the same name share it. Sites beyond the limit get an id past the end
+  // and are ignored.
+  uint32_t Register(Site &site, std::vector<const char *> &names, size_t limit) {
+    std::scoped_lock lock(mu);
+    if (auto id = site.id.load(std::memory_order_relaxed); id != 0) {
+      return id;
+    }
+    auto it = std::find_if(names.begin(), names.end(), [&](const char *n) { return std::string_view(n) == site.name; });
+    uint32_t id = static_cast<uint32_t>(limit + 1);
+    if (it != names.end()) {
+      id = static_cast<uint32_t>(it - names.begin() + 1);
+    } else if (names.size() < limit) {
+      names.emplace_back(site.name);
+      id = static_cast<uint32_t>(names.size());
+    }
+    site.id.store(id, std::memory_order_release);
+    return id;
+  }
+  template <typename Fn> void Visit(Fn &&fn) {
+    std::scoped_lock lock(mu);
+    for (const auto &b : buffers) {
+      fn(*b);
+    }
+  }
+  // TicksPerMicrosecond measures the timestamp counter against the steady clock over the whole trace
+  double TicksPerMicrosecond() {
+    std::scoped_lock lock(mu);
+    auto ticks = bela::CycleClock::Now() - epochTicks;
+    auto us = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - epochTime).count();
+    return ticks > 0 && us > 0 ? static_cast<double>(ticks) / us : 1000.0;
+  }
+  int64_t EpochTicks() {
+    std::scoped_lock lock(mu);
+    return epochTicks;
+  }
+  void Reset() {
+    std::scoped_lock lock(mu);
+    for (auto &b : buffers) {
+      b->size.store(0, std::memory_order_relaxed);
+      b->dropped.store(0, std::memory_order_relaxed);
+      for (auto &c : b->counters) {
+        c.store(0, std::memory_order_relaxed);
+      }
+      for (size_t i = 0; i < maxHistograms; i++) {
+        b->counts[i].store(0, std::memory_order_relaxed);
+        b->sums[i].store(0, std::memory_order_relaxed);
+        for (auto &k : b->buckets[i]) {
+          k.store(0, std::memory_order_relaxed);
+        }
+      }
+    }
+    epochTicks = bela::CycleClock::Now();
+    epochTime = std::chrono::steady_clock::now();
+  }
+  std::vector<const char *> counterNames;
+  std::vector<const char *> histogramNames;
+  std::mutex mu;
+
+private:
+  registry() = default;
+  std::vector<std::unique_ptr<thread_buffer>> buffers;
+  std::vector<thread_buffer *> unused; // buffers of exited threads
+  int64_t epochTicks{0};
+  std::chrono::steady_clock::time_point epochTime;
+};
+
+constinit thread_local thread_buffer *current = nullptr;
+
+// buffer_releaser returns the buffer of its thread to the registry when the thread exits. It is separate from current,
+// which stays trivially destructible and cheap to reach on the recording path.
+struct buffer_releaser {
+  ~buffer_releaser() {
+    if (current != nullptr) {
+      registry::Instance().ReleaseBuffer(current);
+      current = nullptr;
+    }
+  }
+};
+
+thread_buffer *Buffer() {
+  if (current == nullptr) {
+    current = registry::Instance().AcquireBuffer();
+    // a thread recording again after its releaser ran keeps the new buffer for good
+    static thread_local buffer_releaser releaser;
+  }
+  return current;
+}
+
+uint32_t SiteId(Site &site, std::vector<const char *> &names, size_t limit) {
+  if (auto id = site.id.load(std::memory_order_acquire); id != 0) {
+    return id;
+  }
+  auto &r = registry::Instance();
+  return r.Register(site, names, limit);
+}
+
+// JSON helpers, names are literals from the instrumented code but are escaped anyway
+void AppendName(std::string &out, std::string_view s) {
+  out += '"';
+  for (auto c : s) {
+    if (c == '"' || c == '\\') {
+      out += '\\';
+    } else if (static_cast<unsigned char>(c) < 0x20) {
+      continue;
+    }
+    out += c;
+  }
+  out += '"';
+}
+
+// AppendMicroseconds writes a tick count as microseconds with nanosecond precision
+void AppendMicroseconds(std::string &out, int64_t ticks, double ticksPerMicrosecond) {
+  auto ns = static_cast<int64_t>(static_cast<double>(ticks) * 1000 / ticksPerMicrosecond);
+  if (ns < 0) {
+    out += '-';
+    ns = -ns;
+  }
+  auto frac = ns % 1000;
+  bela::StrAppend(&out, ns / 1000, frac < 10 ? ".00" : frac < 100 ? ".0" : ".", frac);
+}
+} // namespace
+
+void Record(const char *name, int64_t start, int64_t end) {
+  auto *b = Buffer();
+  auto n = b->size.load(std::memory_order_relaxed);
+  if (n >= eventCapacity) {
+    Add<uint64_t>(b->dropped, 1);
+    return;
+  }
+  b->events[n] = event{name, start, end};
+  b->size.store(n + 1, std::memory_order_release);
+}
+
+void Count(Site &site, int64_t value) {
+  auto id = SiteId(site, registry::Instance().counterNames, maxCounters);
+  if (id > maxCounters) {
+    return;
+  }
+  Add(Buffer()->counters[id - 1], value);
+}
+
+void Observe(Site &site, uint64_t value) {
+  auto id = SiteId(site, registry::Instance().histogramNames, maxHistograms);
+  if (id > maxHistograms) {
+    return;
+  }
+  auto *b = Buffer();
+  Add<uint64_t>(b->counts[id - 1], 1);
+  Add(b->sums[id - 1], value);
+  Add<uint64_t>(b->buckets[id - 1][std::bit_width(value)], 1);
+}
+
+uint64_t HistogramValue::Percentile(double p) const {
+  if (count == 0) {
+    return 0;
+  }
+  auto rank = static_cast<uint64_t>(std::clamp(p, 0.0, 100.0) / 100 * static_cast<double>(count));
+  uint64_t seen = 0;
+  for (size_t i = 0; i < buckets.size(); i++) {
+    seen += buckets[i];
+    if (seen > rank || seen == count) {
+      return i == 0 ? 0 : i == 64 ? UINT64_MAX : (1ULL << i) - 1;
+    }
+  }
+  return UINT64_MAX;
+}
+
+Report Collect() {
+  auto &r = registry::Instance();
+  Report report;
+  std::vector<const char *> counterNames;
+  std::vector<const char *> histogramNames;
+  {
+    std::scoped_lock lock(r.mu);
+    counterNames = r.counterNames;
+    histogramNames = r.histogramNames;
+  }
+  for (auto name : counterNames) {
+    report.counters.emplace_back(CounterValue{.name = name});
+  }
+  for (auto name : histogramNames) {
+    report.histograms.emplace_back(HistogramValue{.name = name});
+  }
+  r.Visit([&](thread_buffer &b) {
+    report.threads++;
+    report.events += b.size.load(std::memory_order_acquire);
+    report.dropped += b.dropped.load(std::memory_order_relaxed);
+    for (size_t i = 0; i < report.counters.size(); i++) {
+      report.counters[i].value += b.counters[i].load(std::memory_order_relaxed);
+    }
+    for (size_t i = 0; i < report.histograms.size(); i++) {
+      auto &h = report.histograms[i];
+      h.count += b.counts[i].load(std::memory_order_relaxed);
+      h.sum += b.sums[i].load(std::memory_order_relaxed);
+      for (size_t k = 0; k < histogramBuckets; k++) {
+        h.buckets[k] += b.buckets[i][k].load(std::memory_order_relaxed);
+      }
+    }
+  });
+  std::sort(report.counters.begin(), report.counters.end(),
+            [](const auto &a, const auto &b) { return a.name < b.name; });
+  std::sort(report.histograms.begin(), report.histograms.end(),
+            [](const auto &a, const auto &b) { return a.name < b.name; });
+  return report;
+}
+
+std::string ChromeTrace() {
+  auto &r = registry::Instance();
+  auto ticksPerMicrosecond = r.TicksPerMicrosecond();
+  auto epoch = r.EpochTicks();
+  std::string out;
+  out += "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+  bool first = true;
+  auto separator = [&] {
+    out += first ? "\n" : ",\n";
+    first = false;
+  };
+  int64_t last = 0;
+  r.Visit([&](thread_buffer &b) {
+    auto n = b.size.load(std::memory_order_acquire);
+    for (size_t i = 0; i < n; i++) {
+      const auto &e = b.events[i];
+      separator();
+      out += "{\"name\":";
+      AppendName(out, e.name);
+      out += ",\"cat\":\"bela\",\"ph\":\"X\",\"pid\":1,\"tid\":";
+      bela::StrAppend(&out, b.tid, ",\"ts\":");
+      AppendMicroseconds(out, e.start - epoch, ticksPerMicrosecond);
+      out += ",\"dur\":";
+      AppendMicroseconds(out, e.end - e.start, ticksPerMicrosecond);
+      out += '}';
+      last = (std::max)(last, e.end - epoch);
+    }
+  });
+  // counters have no timeline, their final values appear as one sample at the end of the trace
+  auto report = Collect();
+  for (const auto &c : report.counters) {
+    separator();
+    out += "{\"name\":";
+    AppendName(out, c.name);
+    out += ",\"ph\":\"C\",\"pid\":1,\"tid\":0,\"ts\":";
+    AppendMicroseconds(out, last, ticksPerMicrosecond);
+    bela::StrAppend(&out, ",\"args\":{\"value\":", c.value, "}}");
+  }
+  out += "\n]}\n";
+  return out;
+}
+
+void Reset() { registry::Instance().Reset(); }
+} // namespace bela::trace
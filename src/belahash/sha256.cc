@@ -17,6 +17,7 @@
  * or FITNESS FOR A PARTICULAR PURPOSE.  Use this program  at  your own risk!
  */
 #include <bela/hash.hpp>
+#include <bela/cpu.hpp>
 #include "hashinternal.hpp"
 
 namespace bela::hash::sha256 {
@@ -82,7 +83,7 @@ void Hasher::Initialize(HashBits hb_) {
  * @param hash algorithm state
  * @param block the message block to process
  */
-static void sha256_process_block(unsigned hash[8], unsigned block[16]) {
+static void sha256_process_block_portable(unsigned hash[8], const unsigned block[16]) {
   unsigned A;
   unsigned B;
   unsigned C;
@@ -139,6 +140,18 @@ static void sha256_process_block(unsigned hash[8], unsigned block[16]) {
   hash[4] += E, hash[5] += F, hash[6] += G, hash[7] += H;
 }
 
+#if defined(_M_X64) || defined(__x86_64__) || defined(_M_IX86) || defined(__i386__)
+// sha256-intel.cc
+void sha256_process_block_shani(unsigned hash[8], const unsigned block[16]);
+#endif
+
+static constinit bela::cpu::Dispatcher<void(unsigned *, const unsigned *)> sha256_process_block{
+#if defined(_M_X64) || defined(__x86_64__) || defined(_M_IX86) || defined(__i386__)
+    {bela::cpu::SHA | bela::cpu::SSE41 | bela::cpu::SSSE3, sha256_process_block_shani, "sha"},
+#endif
+    {0, sha256_process_block_portable, "portable"},
+};
+
 void Hasher::Update(const void *input, size_t input_len) {
   auto msg = reinterpret_cast<const uint8_t *>(input);
   size_t index = (size_t)length & 63;
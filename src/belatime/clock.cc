@@ -1,9 +1,125 @@
 ///
 #include <bela/time.hpp>
+#include <bela/cycleclock.hpp>
+#include <bela/cpu.hpp>
 #include <bela/macros.hpp>
 #include <mutex>
 
 namespace bela {
+namespace time_internal {
+// counter_scale converts a raw counter of a fixed frequency to Duration without dividing by the frequency twice
+struct counter_scale {
+  explicit counter_scale(int64_t frequency_) : frequency((std::max)(frequency_, int64_t{1})) {
+    if (kTicksPerSecond % frequency == 0) {
+      exactTicks = kTicksPerSecond / frequency; // QPC usually runs at 10MHz: 400 ticks per count
+    }
+    ticksPerCount = static_cast<double>(kTicksPerSecond) / static_cast<double>(frequency);
+  }
+  Duration operator()(int64_t counter) const {
+    if (counter < 0) {
+      return -(*this)(-(counter + 1)) - (*this)(1);
+    }
+    const auto sec = counter / frequency;
+    const auto rem = counter % frequency;
+    const auto ticks = exactTicks != 0 ? rem * exactTicks
+                                       : (std::min)(static_cast<int64_t>(static_cast<double>(rem) * ticksPerCount),
+                                                    kTicksPerSecond - 1);
+    return MakeDuration(sec, static_cast<uint32_t>(ticks));
+  }
+  int64_t frequency{1};
+  int64_t exactTicks{0};
+  double ticksPerCount{0};
+};
+
+inline int64_t QueryCounter() {
+  LARGE_INTEGER li;
+  QueryPerformanceCounter(&li);
+  return li.QuadPart;
+}
+
+const counter_scale &PerformanceCounterScale() {
+  static const counter_scale scale([] {
+    LARGE_INTEGER li;
+    QueryPerformanceFrequency(&li); // fixed at boot, cannot fail since Windows XP
+    return li.QuadPart;
+  }());
+  return scale;
+}
+
+#if defined(_M_X64) || defined(__x86_64__) || defined(_M_IX86) || defined(__i386__)
+bool InvariantTSC() {
+  uint32_t regs[4] = {0};
+  bela::cpu::CPUID(0x80000000, 0, regs);
+  if (regs[0] < 0x80000007) {
+    return false;
+  }
+  bela::cpu::CPUID(0x80000007, 0, regs);
+  return (regs[3] & (1U << 8)) != 0; // EDX.InvariantTSC
+}
+
+int64_t CalibrateTSC() {
+  const auto qpcFrequency = PerformanceCounterScale().frequency;
+  // bracket each QPC read with two TSC reads and take the midpoint
+  auto sample = [](int64_t &qpc) {
+    auto c0 = CycleClock::Now();
+    qpc = QueryCounter();
+    auto c1 = CycleClock::Now();
+    return c0 + (c1 - c0) / 2;
+  };
+  int64_t q0 = 0;
+  int64_t q1 = 0;
+  const auto c0 = sample(q0);
+  Sleep(10);
+  int64_t c1 = 0;
+  do {
+    c1 = sample(q1);
+  } while (q1 - q0 < qpcFrequency / 100);
+  return static_cast<int64_t>(static_cast<double>(c1 - c0) * static_cast<double>(qpcFrequency) /
+                              static_cast<double>(q1 - q0));
+}
+#endif
+
+struct cycleclock_state {
+  bool invariant{false};
+  counter_scale scale;
+};
+
+const cycleclock_state &CycleClockState() {
+  static const cycleclock_state state = [] {
+#if defined(_M_X64) || defined(__x86_64__) || defined(_M_IX86) || defined(__i386__)
+    return cycleclock_state{InvariantTSC(), counter_scale(CalibrateTSC())};
+#elif defined(_M_ARM64) || defined(_M_ARM64EC)
+    // the generic timer is architecturally invariant and reports its frequency
+    return cycleclock_state{true, counter_scale(static_cast<int64_t>(_ReadStatusReg(ARM64_SYSREG(3, 3, 14, 0, 0))))};
+#elif defined(__aarch64__)
+    int64_t frequency;
+    asm volatile("mrs %0, cntfrq_el0" : "=r"(frequency));
+    return cycleclock_state{true, counter_scale(frequency)};
+#else
+    return cycleclock_state{true, PerformanceCounterScale()};
+#endif
+  }();
+  return state;
+}
+} // namespace time_internal
+
+int64_t CycleClock::Frequency() { return time_internal::CycleClockState().scale.frequency; }
+
+bool CycleClock::Invariant() { return time_internal::CycleClockState().invariant; }
+
+bela::Duration CycleClock::ToDuration(int64_t cycles) { return time_internal::CycleClockState().scale(cycles); }
+
+int64_t CycleClock::MonotonicCycles() { return time_internal::QueryCounter(); }
+
+Duration MonotonicNow() { return time_internal::PerformanceCounterScale()(time_internal::QueryCounter()); }
+
+Time CoarseNow() {
+  FILETIME ft;
+  GetSystemTimeAsFileTime(&ft);
+  return bela::FromFileTime(ft);
+}
+
+Duration CoarseMonotonicNow() { return bela::Milliseconds(static_cast<int64_t>(GetTickCount64())); }
 
 // GetCurrentTimeNanos
 int64_t GetCurrentTimeNanos() {
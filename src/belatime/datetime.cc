@@ -50,82 +50,61 @@ std::wstring_view MonthName(Month mon, bool shortname) noexcept {
 
 namespace time_internal {
 
-/* 2000-03-01 (mod 400 year, immediately after feb29 */
-constexpr auto LeapEpoch = (946684800LL + 86400 * (31 + 29));
 // https://en.cppreference.com/w/c/chrono/tm
 bool MakeDateTime(int64_t second, DateTime &dt) {
-  static constexpr const uint8_t days_in_month[] = {31, 30, 31, 30, 31, 31, 30, 31, 30, 31, 31, 29};
-  second -= LeapEpoch;
   auto days = second / secondsPerDay;
   auto remsecs = second % secondsPerDay;
   if (remsecs < 0) {
-    remsecs += 86400;
+    remsecs += secondsPerDay;
     days--;
   }
-
-  // 2000-03-01 Wednesday
-  auto wday = (3 + days) % 7;
-  if (wday < 0) {
-    wday += 7;
-  }
-  // days since Sunday – [0, 6]
-  dt.wday = static_cast<Weekday>(wday);
-
-  auto qccycles = days / daysPer400Years;
-  auto remdays = days % daysPer400Years;
-  if (remdays < 0) {
-    remdays += daysPer400Years;
-    qccycles--;
-  }
-
-  auto ccycles = remdays / daysPer100Years;
-  if (ccycles == 4) {
-    ccycles--;
-  }
-  remdays -= ccycles * daysPer100Years;
-
-  auto qcycles = remdays / daysPer4Years;
-  if (qcycles == 25) {
-    qcycles--;
+  if (days < civilMinDays) {
+    return false;
   }
-  remdays -= qcycles * daysPer4Years;
-
-  auto remyears = remdays / 365;
-  if (remyears == 4) {
-    remyears--;
+  const auto cd = CivilFromDays(days);
+  if (cd.year - 1900 > INT_MAX || cd.year - 1900 < INT_MIN) {
+    return false;
   }
-  remdays -= remyears * 365;
+  // days since Sunday – [0, 6]
+  dt.wday = static_cast<Weekday>(WeekdayFromDays(days));
+  dt.year = cd.year;
+  dt.month = static_cast<Month>(cd.month);
+  dt.day = static_cast<std::int_least8_t>(cd.day);
+  dt.hour = static_cast<std::int_least8_t>(remsecs / secondsPerHour);
+  dt.minute = static_cast<std::int_least8_t>((remsecs % secondsPerHour) / secondsPerMinute);
+  dt.second = static_cast<std::int_least8_t>(remsecs % secondsPerMinute);
+  return true;
+}
 
-  auto leap = (remyears == 0) && (qcycles != 0 || ccycles == 0);
-  auto yday = remdays + 31 + 28 + (leap ? 1 : 0);
-  if (yday >= 365 + (leap ? 1 : 0)) {
-    yday -= 365 + (leap ? 1 : 0);
-  }
-  auto years = remyears + 4 * qcycles + 100 * ccycles + 400LL * qccycles;
-  int months = 0;
-  for (; days_in_month[months] <= remdays; months++) {
-    remdays -= days_in_month[months];
+// The loops below have no data dependent branches so they can be auto-vectorized; inputs outside the range
+// accepted by MakeDateTime produce unspecified fields.
+template <typename F> void MakeDateTimeColumns(size_t n, F &&secondAt, const DateTimeColumns &out) {
+  for (size_t i = 0; i < n; i++) {
+    const auto second = secondAt(i);
+    const auto neg = static_cast<int64_t>(second % secondsPerDay < 0);
+    const auto days = second / secondsPerDay - neg;
+    const auto remsecs = static_cast<int32_t>(second - days * secondsPerDay);
+    const auto cd = CivilFromDays(days);
+    out.year[i] = cd.year;
+    out.month[i] = static_cast<std::int_least8_t>(cd.month);
+    out.day[i] = static_cast<std::int_least8_t>(cd.day);
+    out.hour[i] = static_cast<std::int_least8_t>(remsecs / 3600);
+    out.minute[i] = static_cast<std::int_least8_t>(remsecs % 3600 / 60);
+    out.second[i] = static_cast<std::int_least8_t>(remsecs % 60);
   }
-
-  if (months >= 10) {
-    months -= 12;
-    years++;
-  }
-
-  if (years + 100 > INT_MAX || years + 100 < INT_MIN) {
-    return false;
+  if (!out.weekday.empty()) {
+    for (size_t i = 0; i < n; i++) {
+      const auto second = secondAt(i);
+      const auto days = second / secondsPerDay - static_cast<int64_t>(second % secondsPerDay < 0);
+      out.weekday[i] = static_cast<std::int_least8_t>(WeekdayFromDays(days));
+    }
   }
+}
 
-  // Port from musl.
-  // years since 1900
-  dt.year = years + 100 + 1900;
-  // months since January – [0, 11]
-  dt.month = static_cast<Month>(months + 2 + 1);
-  dt.day = static_cast<std::int_least8_t>(remdays + 1);
-  dt.hour = static_cast<std::int_least8_t>(remsecs / secondsPerHour);                        // 28937
-  dt.minute = static_cast<std::int_least8_t>((remsecs % secondsPerHour) / secondsPerMinute); // 137
-  dt.second = static_cast<std::int_least8_t>(remsecs % secondsPerMinute);
-  return true;
+bool ColumnsFit(size_t n, const DateTimeColumns &out) {
+  return out.year.size() >= n && out.month.size() >= n && out.day.size() >= n && out.hour.size() >= n &&
+         out.minute.size() >= n && out.second.size() >= n && (out.weekday.empty() || out.weekday.size() >= n) &&
+         (out.nsec.empty() || out.nsec.size() >= n);
 }
 }; // namespace time_internal
 
@@ -150,4 +129,27 @@ bela::Time DateTime::Time() const noexcept {
   return time_internal::FromUnixDuration(d);
 }
 
+bool MakeDateTimes(std::span<const int64_t> seconds, const DateTimeColumns &out) {
+  if (!time_internal::ColumnsFit(seconds.size(), out)) {
+    return false;
+  }
+  time_internal::MakeDateTimeColumns(seconds.size(), [&](size_t i) { return seconds[i]; }, out);
+  for (size_t i = 0; i < out.nsec.size() && i < seconds.size(); i++) {
+    out.nsec[i] = 0;
+  }
+  return true;
+}
+
+bool MakeDateTimes(std::span<const bela::Time> times, const DateTimeColumns &out) {
+  if (!time_internal::ColumnsFit(times.size(), out)) {
+    return false;
+  }
+  time_internal::MakeDateTimeColumns(
+      times.size(), [&](size_t i) { return time_internal::GetRepHi(time_internal::ToUnixDuration(times[i])); }, out);
+  for (size_t i = 0; i < out.nsec.size() && i < times.size(); i++) {
+    out.nsec[i] = static_cast<std::int_least32_t>(bela::Split(times[i]).nsec);
+  }
+  return true;
+}
+
 } // namespace bela
\ No newline at end of file
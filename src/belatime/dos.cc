@@ -4,17 +4,9 @@
 
 namespace bela {
 
-constexpr int WindowsEpochDays = (1601 - 1) * 365 + (1601 - 1) / 4 - (1601 - 1) / 100 + (1601 - 1) / 400;
-constexpr int64_t UnixEpochStart = 11644473600LL;
-
 constexpr uint64_t Win_ticks_per_second = 10000000ULL;
 constexpr uint64_t Win_ticks_from_epoch = ((1970 - 1601) * 365 + 3 * 24 + 17) * 86400ULL * Win_ticks_per_second;
 
-constexpr bool IsLeapYear(int Y) { return Y % 4 == 0 && (Y % 100 != 0 || Y % 400 == 0); }
-constexpr int sinceWindowsEpochDays(int Y) {
-  Y--;
-  return Y * 365 + Y / 4 - Y / 100 + Y / 400 - WindowsEpochDays;
-}
 // FromDosDateTime dos time to bela::Time
 // https://msdn.microsoft.com/en-us/library/ms724247(v=VS.85).aspx
 // Windows Epoch start 1601
@@ -28,19 +20,11 @@ bela::Time FromDosDateTime(uint16_t dosDate, uint16_t dosTime) {
   if (sec < 0 || sec > 59 || minute > 59 || minute < 0 || hour < 0 || hour > 23 || mon < 1 || mon > 12 || year < 1601) {
     return bela::UnixEpoch();
   }
-  auto leapYear = IsLeapYear(year);
-  auto mondays = leapYear ? time_internal::LeapMonths[mon - 1] : time_internal::Months[mon - 1];
+  auto mondays = IsLeapYear(year) ? time_internal::LeapMonths[mon - 1] : time_internal::Months[mon - 1];
   if (day < 1 || day > mondays) {
     return bela::UnixEpoch();
   }
-  auto days = sinceWindowsEpochDays(year);
-  for (auto i = 1; i < mon; i++) {
-    days += time_internal::Months[i - 1];
-  }
-  if (mon > 2 && leapYear) {
-    days++;
-  }
-  days += day - 1;
-  return bela::FromUnixSeconds(days * secondsPerDay + hour * 3600 + minute * 60 + sec - UnixEpochStart);
+  auto days = time_internal::DaysFromCivil(year, mon, day);
+  return bela::FromUnixSeconds(days * secondsPerDay + hour * 3600 + minute * 60 + sec);
 }
 } // namespace bela
\ No newline at end of file
@@ -646,80 +646,85 @@ namespace {
 // Formats a positive 64-bit integer in the given field width.  Note that
 // it is up to the caller of Format64() to ensure that there is sufficient
 // space before ep to hold the conversion.
-wchar_t *Format64(wchar_t *ep, int width, int64_t v) {
+template <typename CharT> CharT *Format64(CharT *ep, int width, int64_t v) {
   do {
     --width;
-    *--ep = L'0' + (v % 10); // contiguous digits
+    *--ep = static_cast<CharT>('0' + (v % 10)); // contiguous digits
   } while ((v /= 10) != 0);
   while (--width >= 0) {
-    *--ep = L'0'; // zero pad
+    *--ep = '0'; // zero pad
   }
   return ep;
 }
 
-// Helpers for FormatDuration() that format 'n' and append it to 'out'
+// Helpers for FormatDuration() that format 'n' and write it to 'out'
 // followed by the given 'unit'.  If 'n' formats to "0", nothing is
-// appended (not even the unit).
+// written (not even the unit). They return the new end of 'out'.
 
 // A type that encapsulates how to display a value of a particular unit. For
 // values that are displayed with fractional parts, the precision indicates
-// where to round the value. The precision varies with the display unit because
-// a Duration can hold only quarters of a nanosecond, so displaying information
-// beyond that is just noise.
-//
-// For example, a microsecond value of 42.00025xxxxx should not display beyond 5
-// fractional digits, because it is in the noise of what a Duration can
-// represent.
+// how many fractional digits are kept. A Duration holds quarters of a
+// nanosecond, so every fraction is an exact multiple of 25 in units of
+// 10^-prec: the value is split from the tick representation with integer
+// arithmetic and never rounded.
 struct DisplayUnit {
-  std::wstring_view abbr;
+  std::string_view abbr;
   int prec;
-  double pow10;
+  int64_t ticks; // ticks per unit
 };
-BELA_CONST_INIT const DisplayUnit kDisplayNano = {L"ns", 2, 1e2};
-BELA_CONST_INIT const DisplayUnit kDisplayMicro = {L"us", 5, 1e5};
-BELA_CONST_INIT const DisplayUnit kDisplayMilli = {L"ms", 8, 1e8};
-BELA_CONST_INIT const DisplayUnit kDisplaySec = {L"s", 11, 1e11};
-BELA_CONST_INIT const DisplayUnit kDisplayMin = {L"m", -1, 0.0};  // prec ignored
-BELA_CONST_INIT const DisplayUnit kDisplayHour = {L"h", -1, 0.0}; // prec ignored
-
-void AppendNumberUnit(std::wstring *out, int64_t n, DisplayUnit unit) {
+BELA_CONST_INIT const DisplayUnit kDisplayNano = {"ns", 2, time_internal::kTicksPerNanosecond};
+BELA_CONST_INIT const DisplayUnit kDisplayMicro = {"us", 5, 1000 * time_internal::kTicksPerNanosecond};
+BELA_CONST_INIT const DisplayUnit kDisplayMilli = {"ms", 8, 1000 * 1000 * time_internal::kTicksPerNanosecond};
+BELA_CONST_INIT const DisplayUnit kDisplaySec = {"s", 11, time_internal::kTicksPerSecond};
+BELA_CONST_INIT const DisplayUnit kDisplayMin = {"m", -1, 0};  // prec ignored
+BELA_CONST_INIT const DisplayUnit kDisplayHour = {"h", -1, 0}; // prec ignored
+
+template <typename CharT> CharT *AppendChars(CharT *out, const CharT *bp, const CharT *ep) {
+  return std::copy(bp, ep, out);
+}
+
+template <typename CharT> CharT *AppendUnit(CharT *out, std::string_view abbr) {
+  for (auto c : abbr) {
+    *out++ = static_cast<CharT>(c);
+  }
+  return out;
+}
+
+template <typename CharT> CharT *AppendNumberUnit(CharT *out, int64_t n, DisplayUnit unit) {
   constexpr auto kBufferSize = sizeof("2562047788015216");
-  wchar_t buf[kBufferSize]; // hours in max duration
-  wchar_t *const ep = buf + kBufferSize;
-  wchar_t *bp = Format64(ep, 0, n);
-  if (*bp != L'0' || bp + 1 != ep) {
-    out->append(bp, ep - bp);
-    out->append(unit.abbr);
+  CharT buf[kBufferSize]; // hours in max duration
+  CharT *const ep = buf + kBufferSize;
+  CharT *bp = Format64(ep, 0, n);
+  if (*bp != '0' || bp + 1 != ep) {
+    out = AppendChars(out, bp, ep);
+    out = AppendUnit(out, unit.abbr);
   }
+  return out;
 }
 
-// Note: unit.prec is limited to double's digits10 value (typically 15) so it
-// always fits in buf[].
-void AppendNumberUnit(std::wstring *out, double n, DisplayUnit unit) {
+// ticks < 1000 * unit.ticks, the integer part is always < 1000 (or < 60 for seconds)
+template <typename CharT> CharT *AppendFractionUnit(CharT *out, uint64_t ticks, DisplayUnit unit) {
   constexpr int kBufferSize = std::numeric_limits<double>::digits10;
-  const int prec = (std::min)(kBufferSize, unit.prec);
-  wchar_t buf[kBufferSize]; // also large enough to hold integer part
-  wchar_t *ep = buf + kBufferSize;
-  double d = 0;
-  auto frac_part = static_cast<int64_t>(std::round(std::modf(n, &d) * unit.pow10));
-  auto int_part = static_cast<int64_t>(d);
+  CharT buf[kBufferSize]; // also large enough to hold integer part
+  CharT *ep = buf + kBufferSize;
+  auto int_part = static_cast<int64_t>(ticks / static_cast<uint64_t>(unit.ticks));
+  auto frac_part = static_cast<int64_t>(ticks % static_cast<uint64_t>(unit.ticks)) * 25; // 10^prec / unit.ticks == 25
   if (int_part != 0 || frac_part != 0) {
-    wchar_t *bp = Format64(ep, 0, int_part); // always < 1000
-    out->append(bp, ep - bp);
+    CharT *bp = Format64(ep, 0, int_part);
+    out = AppendChars(out, bp, ep);
     if (frac_part != 0) {
-      out->push_back('.');
-      bp = Format64(ep, prec, frac_part);
+      *out++ = '.';
+      bp = Format64(ep, unit.prec, frac_part);
       while (ep[-1] == '0') {
         --ep;
       }
-      out->append(bp, ep - bp);
+      out = AppendChars(out, bp, ep);
     }
-    out->append(unit.abbr);
+    out = AppendUnit(out, unit.abbr);
   }
+  return out;
 }
 
-} // namespace
-
 // From Go's doc at https://golang.org/pkg/time/#Duration.String
 //   [FormatDuration] returns a string representing the duration in the
 //   form "72h3m0.5s". Leading zero units are omitted.  As a special
@@ -727,52 +732,81 @@ void AppendNumberUnit(std::wstring *out, double n, DisplayUnit unit) {
 //   (milli-, micro-, or nanoseconds) to ensure that the leading digit
 //   is non-zero.
 // Unlike Go, we format the zero duration as 0, with no unit.
-std::wstring FormatDuration(Duration d) {
+// buf must hold DurationMaxLength characters.
+template <typename CharT> size_t FormatDurationInternal(Duration d, CharT *buf) {
   constexpr Duration kMinDuration = Seconds(kint64min);
   if (d == kMinDuration) {
     // Avoid needing to negate kint64min by directly returning what the
     // following code should produce in that case.
-    return L"-2562047788015215h30m8s";
+    return static_cast<size_t>(AppendUnit(buf, "-2562047788015215h30m8s") - buf);
   }
-  std::wstring s;
+  CharT *out = buf;
   if (d < ZeroDuration()) {
-    s.append(L"-");
+    *out++ = '-';
     d = -d;
   }
+  const auto sec = time_internal::GetRepHi(d);
+  const auto ticks = time_internal::GetRepLo(d);
   if (d == InfiniteDuration()) {
-    s.append(L"inf");
-  } else if (d < Seconds(1)) {
+    out = AppendUnit(out, "inf");
+  } else if (sec == 0) {
     // Special case for durations with a magnitude < 1 second.  The duration
     // is printed as a fraction of a single unit, e.g., "1.2ms".
-    if (d < Microseconds(1)) {
-      AppendNumberUnit(&s, FDivDuration(d, Nanoseconds(1)), kDisplayNano);
-    } else if (d < Milliseconds(1)) {
-      AppendNumberUnit(&s, FDivDuration(d, Microseconds(1)), kDisplayMicro);
+    if (ticks < kDisplayMicro.ticks) {
+      out = AppendFractionUnit(out, ticks, kDisplayNano);
+    } else if (ticks < kDisplayMilli.ticks) {
+      out = AppendFractionUnit(out, ticks, kDisplayMicro);
     } else {
-      AppendNumberUnit(&s, FDivDuration(d, Milliseconds(1)), kDisplayMilli);
+      out = AppendFractionUnit(out, ticks, kDisplayMilli);
     }
   } else {
-    AppendNumberUnit(&s, IDivDuration(d, Hours(1), &d), kDisplayHour);
-    AppendNumberUnit(&s, IDivDuration(d, Minutes(1), &d), kDisplayMin);
-    AppendNumberUnit(&s, FDivDuration(d, Seconds(1)), kDisplaySec);
+    out = AppendNumberUnit(out, sec / 3600, kDisplayHour);
+    out = AppendNumberUnit(out, sec % 3600 / 60, kDisplayMin);
+    out = AppendFractionUnit(out, static_cast<uint64_t>(sec % 60 * kDisplaySec.ticks) + ticks, kDisplaySec);
+  }
+  if (out == buf || (out == buf + 1 && buf[0] == '-')) {
+    buf[0] = '0';
+    return 1;
+  }
+  return static_cast<size_t>(out - buf);
+}
+
+template <typename CharT> size_t FormatDurationTo(Duration d, std::span<CharT> buffer) {
+  if (buffer.size() >= DurationMaxLength) {
+    return FormatDurationInternal(d, buffer.data());
   }
-  if (s.empty() || s == L"-") {
-    s = L"0";
+  CharT buf[DurationMaxLength];
+  auto n = FormatDurationInternal(d, buf);
+  if (n > buffer.size()) {
+    return 0;
   }
-  return s;
+  std::copy_n(buf, n, buffer.data());
+  return n;
+}
+
+} // namespace
+
+std::wstring FormatDuration(Duration d) {
+  wchar_t buf[DurationMaxLength];
+  return std::wstring(buf, FormatDurationInternal(d, buf));
 }
 
+size_t FormatDuration(Duration d, std::span<char> buffer) { return FormatDurationTo(d, buffer); }
+
+size_t FormatDuration(Duration d, std::span<wchar_t> buffer) { return FormatDurationTo(d, buffer); }
+
 namespace {
 
 // A helper for ParseDuration() that parses a leading number from the given
 // string and stores the result in *int_part/*frac_part/*frac_scale.  The
 // given string pointer is modified to point to the first unconsumed char.
-bool ConsumeDurationNumber(const wchar_t **dpp, const wchar_t *ep, int64_t *int_part, int64_t *frac_part,
+template <typename CharT>
+bool ConsumeDurationNumber(const CharT **dpp, const CharT *ep, int64_t *int_part, int64_t *frac_part,
                            int64_t *frac_scale) {
   *int_part = 0;
   *frac_part = 0;
   *frac_scale = 1; // invariant: *frac_part < *frac_scale
-  const wchar_t *start = *dpp;
+  const CharT *start = *dpp;
   for (; *dpp != ep; *dpp += 1) {
     const int d = **dpp - '0'; // contiguous digits
     if (d < 0 || 10 <= d) {
@@ -811,29 +845,29 @@ bool ConsumeDurationNumber(const wchar_t **dpp, const wchar_t *ep, int64_t *int_
 // ns, us, ms, s, m, h) from the given string and stores the resulting unit
 // in "*unit".  The given string pointer is modified to point to the first
 // unconsumed char.
-bool ConsumeDurationUnit(const wchar_t **start, const wchar_t *end, Duration *unit) {
+template <typename CharT> bool ConsumeDurationUnit(const CharT **start, const CharT *end, Duration *unit) {
   size_t size = end - *start;
   switch (size) {
   case 0:
     return false;
   default:
     switch (**start) {
-    case L'n':
-      if (*(*start + 1) == L's') {
+    case 'n':
+      if (*(*start + 1) == 's') {
         *start += 2;
         *unit = Nanoseconds(1);
         return true;
       }
       break;
-    case L'u':
-      if (*(*start + 1) == L's') {
+    case 'u':
+      if (*(*start + 1) == 's') {
         *start += 2;
         *unit = Microseconds(1);
         return true;
       }
       break;
-    case L'm':
-      if (*(*start + 1) == L's') {
+    case 'm':
+      if (*(*start + 1) == 's') {
         *start += 2;
         *unit = Milliseconds(1);
         return true;
@@ -845,15 +879,15 @@ bool ConsumeDurationUnit(const wchar_t **start, const wchar_t *end, Duration *un
     [[fallthrough]];
   case 1:
     switch (**start) {
-    case L's':
+    case 's':
       *unit = Seconds(1);
       *start += 1;
       return true;
-    case L'm':
+    case 'm':
       *unit = Minutes(1);
       *start += 1;
       return true;
-    case L'h':
+    case 'h':
       *unit = Hours(1);
       *start += 1;
       return true;
@@ -863,37 +897,89 @@ bool ConsumeDurationUnit(const wchar_t **start, const wchar_t *end, Duration *un
   }
 }
 
-} // namespace
+// ParseIntegerDuration handles the common "300ms", "2h45m", "10s" forms: integer numbers with unit suffixes whose sum
+// fits in int64 nanoseconds. Digits and units are folded in one pass with no Duration arithmetic; anything else
+// (fractions, overflow, malformed input) returns false and is left to the general parser.
+template <typename CharT> bool ParseIntegerDuration(const CharT *it, const CharT *end, bool negative, Duration *d) {
+  constexpr int64_t nanosPerHour = int64_t{3600} * 1000 * 1000 * 1000;
+  int64_t total = 0;
+  while (it != end) {
+    // at most 18 digits never overflow int64
+    const CharT *digits = it;
+    uint64_t v = 0;
+    for (; it != end && static_cast<unsigned>(*it - '0') < 10 && it - digits < 18; it++) {
+      v = v * 10 + static_cast<unsigned>(*it - '0');
+    }
+    if (it == digits || it == end) {
+      return false;
+    }
+    int64_t scale = 0;
+    switch (*it++) {
+    case 'h':
+      scale = nanosPerHour;
+      break;
+    case 's':
+      scale = 1000 * 1000 * 1000;
+      break;
+    case 'm':
+      if (it != end && *it == 's') {
+        it++;
+        scale = 1000 * 1000;
+        break;
+      }
+      scale = int64_t{60} * 1000 * 1000 * 1000;
+      break;
+    case 'u':
+    case 'n':
+      if (it == end || *it != 's') {
+        return false;
+      }
+      scale = it[-1] == 'u' ? 1000 : 1;
+      it++;
+      break;
+    default:
+      return false;
+    }
+    if (v > static_cast<uint64_t>((kint64max - total) / scale)) {
+      return false;
+    }
+    total += static_cast<int64_t>(v) * scale;
+  }
+  *d = Nanoseconds(negative ? -total : total);
+  return true;
+}
 
 // From Go's doc at https://golang.org/pkg/time/#ParseDuration
 //   [ParseDuration] parses a duration string. A duration string is
 //   a possibly signed sequence of decimal numbers, each with optional
 //   fraction and a unit suffix, such as "300ms", "-1.5h" or "2h45m".
 //   Valid time units are "ns", "us" "ms", "s", "m", "h".
-bool ParseDuration(std::wstring_view dur_sv, Duration *d) {
+template <typename CharT> bool ParseDurationInternal(std::basic_string_view<CharT> dur_sv, Duration *d) {
   int sign = 1;
-  if (bela::ConsumePrefix(&dur_sv, L"-")) {
-    sign = -1;
-  } else {
-    bela::ConsumePrefix(&dur_sv, L"+");
+  if (!dur_sv.empty() && (dur_sv.front() == '-' || dur_sv.front() == '+')) {
+    sign = dur_sv.front() == '-' ? -1 : 1;
+    dur_sv.remove_prefix(1);
   }
   if (dur_sv.empty()) {
     return false;
   }
 
   // Special case for a string of "0".
-  if (dur_sv == L"0") {
+  if (dur_sv.size() == 1 && dur_sv.front() == '0') {
     *d = ZeroDuration();
     return true;
   }
 
-  if (dur_sv == L"inf") {
+  if (dur_sv.size() == 3 && dur_sv[0] == 'i' && dur_sv[1] == 'n' && dur_sv[2] == 'f') {
     *d = sign * InfiniteDuration();
     return true;
   }
 
-  const wchar_t *start = dur_sv.data();
-  const wchar_t *end = start + dur_sv.size();
+  const CharT *start = dur_sv.data();
+  const CharT *end = start + dur_sv.size();
+  if (ParseIntegerDuration(start, end, sign < 0, d)) {
+    return true;
+  }
 
   Duration dur;
   while (start != end) {
@@ -915,4 +1001,11 @@ bool ParseDuration(std::wstring_view dur_sv, Duration *d) {
   *d = dur;
   return true;
 }
-} // namespace bela
\ No newline at end of file
+
+} // namespace
+
+bool ParseDuration(std::wstring_view dur_sv, Duration *d) { return ParseDurationInternal(dur_sv, d); }
+
+bool ParseDuration(std::string_view dur_sv, Duration *d) { return ParseDurationInternal(dur_sv, d); }
+
+} // namespace bela
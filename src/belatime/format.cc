@@ -1,4 +1,5 @@
 /// DateTime format
+#include <algorithm>
 #include <bela/datetime.hpp>
 #include <bela/terminal.hpp>
 
@@ -47,14 +48,12 @@ template <typename CharT> constexpr CharT *Format02d(CharT *ep, int v) {
   return ep;
 }
 
+// Fractional digits keep their leading zeros, only trailing zeros are dropped
 template <typename T> std::basic_string_view<T> trimZero(std::basic_string_view<T> sv) {
-  if (auto pos = sv.find_first_not_of('0'); pos != std::basic_string_view<T>::npos) {
-    sv.remove_prefix(pos);
-  }
   if (auto pos = sv.find_last_not_of('0'); pos != std::basic_string_view<T>::npos) {
     return sv.substr(0, pos + 1);
   }
-  return sv;
+  return {};
 }
 
 template <typename CharT = wchar_t, typename Allocator = std::allocator<CharT>>
@@ -84,7 +83,7 @@ FormatDateTimeInternal(std::int_fast64_t year, bela::Month month, std::int_least
   bp = Format02d(ep, second);
   stime.append(bp, static_cast<std::size_t>(ep - bp));
   if (nano) {
-    bp = Format64(ep, 10, nsec);
+    bp = Format64(ep, 9, nsec);
     auto sv = trimZero(std::basic_string_view<CharT>(bp, static_cast<size_t>(ep - bp)));
     if (!sv.empty()) {
       stime.push_back('.');
@@ -116,4 +115,78 @@ std::string FormatDateTimeA(const DateTime &dt, bool nano) {
   return FormatDateTimeInternal<char>(dt.year, dt.month, dt.day, dt.hour, dt.minute, dt.second, dt.nsec, dt.tzoffset,
                                       nano);
 }
-} // namespace bela::time_internal
\ No newline at end of file
+} // namespace bela::time_internal
+namespace bela {
+TimestampFormatter::TimestampFormatter(std::int_least32_t tz, int digits_) noexcept
+    : tzoffset(tz), digits(std::clamp(digits_, 0, 9)) {
+  for (auto i = digits; i < 9; i++) {
+    divisor *= 10;
+  }
+  if (tzoffset == 0) {
+    suffix[0] = 'Z';
+    suffixLength = 1;
+    return;
+  }
+  auto h = std::abs(tzoffset) / 3600;
+  auto m = std::abs(tzoffset) % 3600 / 60;
+  suffix[0] = (tzoffset > 0) ? '-' : '+';
+  time_internal::Format02d(suffix + 3, h);
+  suffix[3] = ':';
+  time_internal::Format02d(suffix + 6, m);
+  suffixLength = 6;
+}
+
+void TimestampFormatter::Refresh(int64_t sec) noexcept {
+  bela::DateTime dt(bela::FromUnixSeconds(sec) - bela::Seconds(tzoffset), tzoffset);
+  char buf[3 + time_internal::kDigits10_64];
+  char *const ep = buf + std::size(buf);
+  auto bp = time_internal::Format64(ep, 4, dt.Year());
+  auto p = std::copy(bp, ep, prefix);
+  // "-MM-DDTHH:MM:SS"
+  *p++ = '-';
+  p = time_internal::Format02d(p + 2, static_cast<int>(dt.Month())) + 2;
+  *p++ = '-';
+  p = time_internal::Format02d(p + 2, dt.Day()) + 2;
+  *p++ = 'T';
+  p = time_internal::Format02d(p + 2, dt.Hour()) + 2;
+  *p++ = ':';
+  p = time_internal::Format02d(p + 2, dt.Minute()) + 2;
+  *p++ = ':';
+  p = time_internal::Format02d(p + 2, dt.Second()) + 2;
+  prefixLength = static_cast<uint8_t>(p - prefix);
+  cached = sec;
+}
+
+template <typename CharT> size_t TimestampFormatter::FormatInternal(bela::Time t, std::span<CharT> buffer) noexcept {
+  auto parts = bela::Split(t);
+  if (parts.sec != cached) {
+    Refresh(parts.sec);
+  }
+  const size_t n = prefixLength + (digits > 0 ? digits + 1 : 0) + suffixLength;
+  if (buffer.size() < n) {
+    return 0;
+  }
+  auto p = std::copy_n(prefix, prefixLength, buffer.data());
+  if (digits > 0) {
+    *p++ = '.';
+    auto v = parts.nsec / divisor;
+    for (auto i = digits; i > 0; i--) {
+      p[i - 1] = static_cast<CharT>(time_internal::kDigits[v % 10]);
+      v /= 10;
+    }
+    p += digits;
+  }
+  std::copy_n(suffix, suffixLength, p);
+  return n;
+}
+
+size_t TimestampFormatter::Format(bela::Time t, std::span<char> buffer) noexcept { return FormatInternal(t, buffer); }
+size_t TimestampFormatter::Format(bela::Time t, std::span<wchar_t> buffer) noexcept { return FormatInternal(t, buffer); }
+
+static thread_local TimestampFormatter universalFormatter;
+
+size_t FormatTimestamp(bela::Time t, std::span<char> buffer) noexcept { return universalFormatter.Format(t, buffer); }
+size_t FormatTimestamp(bela::Time t, std::span<wchar_t> buffer) noexcept {
+  return universalFormatter.Format(t, buffer);
+}
+} // namespace bela
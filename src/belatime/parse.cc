@@ -0,0 +1,171 @@
+/// RFC3339 parser
+#include <bela/datetime.hpp>
+#include <bela/endian.hpp>
+
+namespace bela {
+namespace {
+// "YYYY-MM-DDTHH:MM:SS" is validated and converted as three overlapping little-endian 64-bit words:
+//   A = p[0..8)   "YYYY-MM-"
+//   B = p[8..16)  "DDTHH:MM" (the 'T' is checked separately, RFC3339 also allows 't' and ' ')
+//   C = p[11..19) "HH:MM:SS"
+constexpr size_t fixedLength = sizeof("2006-01-02T15:04:05") - 1;
+constexpr uint64_t digitMaskA = 0x00FFFF00FFFFFFFFULL;
+constexpr uint64_t separatorsA = 0x2D00002D00000000ULL; // '-' at 4 and 7
+constexpr uint64_t digitMaskB = 0xFFFF00FFFF00FFFFULL;
+constexpr uint64_t separatorsB = 0x00003A0000000000ULL; // ':' at 5
+constexpr uint64_t ignoreMaskB = 0x0000000000FF0000ULL; // date/time separator at 2
+constexpr uint64_t digitMaskC = 0xFFFF00FFFF00FFFFULL;
+constexpr uint64_t separatorsC = 0x00003A00003A0000ULL; // ':' at 2 and 5
+
+// Checks every byte selected by mask is an ASCII digit and every other byte (outside ignore) equals separators, then
+// stores the digit values with separators zeroed in d.
+inline bool swar_digits(uint64_t w, uint64_t mask, uint64_t separators, uint64_t ignore, uint64_t &d) {
+  constexpr uint64_t ascii0 = 0x3030303030303030ULL;
+  const auto x = (w & mask) | (ascii0 & ~mask);
+  const auto hi = (x & 0xF0F0F0F0F0F0F0F0ULL) | (((x + 0x0606060606060606ULL) & 0xF0F0F0F0F0F0F0F0ULL) >> 4);
+  d = x - ascii0;
+  return (hi == 0x3333333333333333ULL) & ((w & ~(mask | ignore)) == separators);
+}
+
+// Two digits per 16-bit lane: lane value = tens * 10 + ones
+constexpr uint64_t swar_pairs(uint64_t d) {
+  return (d & 0x000F000F000F000FULL) * 10 + ((d >> 8) & 0x000F000F000F000FULL);
+}
+
+constexpr uint32_t lane(uint64_t v, int i) { return static_cast<uint32_t>(v >> (i * 16)) & 0xFFFF; }
+
+struct rfc3339_fields {
+  uint32_t year;
+  uint32_t month;
+  uint32_t day;
+  uint32_t hour;
+  uint32_t minute;
+  uint32_t second;
+};
+
+inline bool parse_fixed(const char *p, rfc3339_fields &f) {
+  uint64_t a;
+  uint64_t b;
+  uint64_t c;
+  const auto ok = swar_digits(bela::cast_fromle<uint64_t>(p), digitMaskA, separatorsA, 0, a) &
+                  swar_digits(bela::cast_fromle<uint64_t>(p + 8), digitMaskB, separatorsB, ignoreMaskB, b) &
+                  swar_digits(bela::cast_fromle<uint64_t>(p + 11), digitMaskC, separatorsC, 0, c);
+  if (!ok || (p[10] != 'T' && p[10] != 't' && p[10] != ' ')) {
+    return false;
+  }
+  const auto pa = swar_pairs(a);
+  const auto pb = swar_pairs(b);
+  const auto pc = swar_pairs(c);
+  f.year = lane(pa, 0) * 100 + lane(pa, 1);
+  f.month = lane(swar_pairs(a >> 8), 2);
+  f.day = lane(pb, 0);
+  f.minute = lane(pb, 3);
+  f.hour = lane(pc, 0);
+  f.second = lane(pc, 3);
+  if (f.month - 1 > 11 || f.hour > 23 || f.minute > 59 || f.second > 59 || f.day == 0) {
+    return false;
+  }
+  const auto mondays =
+      IsLeapYear(f.year) ? time_internal::LeapMonths[f.month - 1] : time_internal::Months[f.month - 1];
+  return f.day <= static_cast<uint32_t>(mondays);
+}
+
+template <typename CharT> constexpr int digit_value(CharT c) {
+  const auto d = static_cast<int>(c) - '0';
+  return (d >= 0 && d <= 9) ? d : -1;
+}
+
+template <typename CharT> bool ParseRFC3339Internal(std::basic_string_view<CharT> sv, Time *t) {
+  // shortest: "2006-01-02T15:04:05Z"
+  if (sv.size() < fixedLength + 1) {
+    return false;
+  }
+  rfc3339_fields f;
+  if constexpr (sizeof(CharT) == 1) {
+    if (!parse_fixed(reinterpret_cast<const char *>(sv.data()), f)) {
+      return false;
+    }
+  } else {
+    char buffer[fixedLength];
+    for (size_t i = 0; i < fixedLength; i++) {
+      if (static_cast<uint32_t>(sv[i]) > 0x7F) {
+        return false;
+      }
+      buffer[i] = static_cast<char>(sv[i]);
+    }
+    if (!parse_fixed(buffer, f)) {
+      return false;
+    }
+  }
+  auto p = sv.data() + fixedLength;
+  const auto end = sv.data() + sv.size();
+  uint32_t nsec = 0;
+  if (*p == '.') {
+    p++;
+    int scale = 9;
+    const auto begin = p;
+    for (; p != end; p++) {
+      const auto d = digit_value(*p);
+      if (d < 0) {
+        break;
+      }
+      if (scale > 0) {
+        nsec = nsec * 10 + static_cast<uint32_t>(d);
+        scale--;
+      }
+    }
+    if (p == begin) {
+      return false;
+    }
+    for (; scale > 0; scale--) {
+      nsec *= 10;
+    }
+  }
+  if (p == end) {
+    return false;
+  }
+  int64_t offset = 0;
+  switch (*p) {
+  case 'Z':
+  case 'z':
+    p++;
+    break;
+  case '+':
+  case '-': {
+    if (end - p != 6 || p[3] != ':') {
+      return false;
+    }
+    const auto h1 = digit_value(p[1]);
+    const auto h2 = digit_value(p[2]);
+    const auto m1 = digit_value(p[4]);
+    const auto m2 = digit_value(p[5]);
+    if ((h1 | h2 | m1 | m2) < 0) {
+      return false;
+    }
+    const auto hours = h1 * 10 + h2;
+    const auto minutes = m1 * 10 + m2;
+    if (hours > 23 || minutes > 59) {
+      return false;
+    }
+    offset = (hours * 3600 + minutes * 60) * (*p == '-' ? -1 : 1);
+    p += 6;
+  } break;
+  default:
+    return false;
+  }
+  if (p != end) {
+    return false;
+  }
+  const auto seconds = time_internal::DaysFromCivil(f.year, static_cast<int>(f.month), static_cast<int>(f.day)) *
+                           secondsPerDay +
+                       f.hour * 3600 + f.minute * 60 + f.second - offset;
+  *t = time_internal::FromUnixDuration(time_internal::MakeDuration(seconds, nsec * time_internal::kTicksPerNanosecond));
+  return true;
+}
+
+} // namespace
+
+bool ParseRFC3339(std::string_view sv, Time *t) { return ParseRFC3339Internal(sv, t); }
+bool ParseRFC3339(std::wstring_view sv, Time *t) { return ParseRFC3339Internal(sv, t); }
+
+} // namespace bela
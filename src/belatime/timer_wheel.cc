@@ -0,0 +1,245 @@
+//
+#include <bela/timer_wheel.hpp>
+#include <bit>
+
+namespace bela {
+constexpr int64_t overflowSpan = int64_t{1} << (TimerWheel::LevelBits * TimerWheel::Levels);
+
+TimerWheel::TimerWheel(bela::Duration tick_, bela::Duration start)
+    : tick(tick_ > bela::ZeroDuration() ? tick_ : bela::Milliseconds(1)), origin(start) {
+  heads.fill(npos);
+}
+
+TimerWheel::~TimerWheel() {
+  auto s = submissions.exchange(nullptr, std::memory_order_acquire);
+  while (s != nullptr) {
+    auto next = s->next;
+    delete s;
+    s = next;
+  }
+}
+
+int64_t TimerWheel::TicksFloor(bela::Duration d) const {
+  bela::Duration rem;
+  auto q = bela::IDivDuration(d - origin, tick, &rem);
+  return rem < bela::ZeroDuration() ? q - 1 : q;
+}
+
+int64_t TimerWheel::TicksCeil(bela::Duration d) const {
+  bela::Duration rem;
+  auto q = bela::IDivDuration(d - origin, tick, &rem);
+  return rem > bela::ZeroDuration() && q != (std::numeric_limits<int64_t>::max)() ? q + 1 : q;
+}
+
+void TimerWheel::Link(uint32_t index, uint32_t bucket) {
+  auto &n = nodes[index];
+  n.bucket = bucket;
+  n.prev = npos;
+  n.next = heads[bucket];
+  if (n.next != npos) {
+    nodes[n.next].prev = index;
+  }
+  heads[bucket] = index;
+  if (bucket < OverflowBucket) {
+    occupied[bucket / Slots] |= uint64_t{1} << (bucket % Slots);
+  }
+}
+
+void TimerWheel::Unlink(uint32_t index) {
+  auto &n = nodes[index];
+  if (n.prev != npos) {
+    nodes[n.prev].next = n.next;
+  } else {
+    heads[n.bucket] = n.next;
+  }
+  if (n.next != npos) {
+    nodes[n.next].prev = n.prev;
+  }
+  if (n.bucket < OverflowBucket && heads[n.bucket] == npos) {
+    occupied[n.bucket / Slots] &= ~(uint64_t{1} << (n.bucket % Slots));
+  }
+  n.bucket = npos;
+}
+
+// Place files a timer under the highest base-64 digit in which its expiry differs from the current tick: the slot is
+// reached (and cascaded) exactly when the current tick has caught up on every digit above it.
+void TimerWheel::Place(uint32_t index) {
+  auto expires = nodes[index].expires;
+  auto diff = static_cast<uint64_t>(expires ^ current);
+  auto level = diff == 0 ? 0 : static_cast<int>((std::bit_width(diff) - 1) / LevelBits);
+  if (level >= Levels) {
+    Link(index, OverflowBucket);
+    return;
+  }
+  auto slot = static_cast<uint32_t>(expires >> (level * LevelBits)) & (Slots - 1);
+  Link(index, static_cast<uint32_t>(level) * Slots + slot);
+}
+
+void TimerWheel::Release(uint32_t index) {
+  auto &n = nodes[index];
+  n.fn = nullptr;
+  n.bucket = npos;
+  if (++n.generation == 0) {
+    n.generation = 1;
+  }
+  freeNodes.emplace_back(index);
+  size--;
+}
+
+TimerWheel::timer_id TimerWheel::ScheduleAt(bela::Duration deadline, callback_t fn) {
+  uint32_t index = 0;
+  if (!freeNodes.empty()) {
+    index = freeNodes.back();
+    freeNodes.pop_back();
+  } else {
+    index = static_cast<uint32_t>(nodes.size());
+    nodes.emplace_back();
+  }
+  auto &n = nodes[index];
+  n.fn = std::move(fn);
+  // a timer due now (or in the past) runs on the next tick, so a callback rescheduling itself cannot spin Advance()
+  n.expires = (std::max)(TicksCeil(deadline), current + 1);
+  size++;
+  Place(index);
+  return (static_cast<uint64_t>(n.generation) << 32) | index;
+}
+
+bool TimerWheel::Cancel(timer_id id) {
+  auto index = static_cast<uint32_t>(id);
+  auto generation = static_cast<uint32_t>(id >> 32);
+  if (index >= nodes.size() || nodes[index].generation != generation || nodes[index].bucket == npos) {
+    return false;
+  }
+  Unlink(index);
+  Release(index);
+  return true;
+}
+
+void TimerWheel::Post(bela::Duration delay, callback_t fn) {
+  auto s = new submission{bela::MonotonicNow() + delay, std::move(fn), nullptr};
+  auto head = submissions.load(std::memory_order_relaxed);
+  do {
+    s->next = head;
+  } while (!submissions.compare_exchange_weak(head, s, std::memory_order_release, std::memory_order_relaxed));
+}
+
+void TimerWheel::Drain() {
+  auto head = submissions.exchange(nullptr, std::memory_order_acquire);
+  // the list is LIFO, reverse it so posts from one thread keep their order
+  submission *s = nullptr;
+  while (head != nullptr) {
+    auto next = head->next;
+    head->next = s;
+    s = head;
+    head = next;
+  }
+  while (s != nullptr) {
+    auto next = s->next;
+    ScheduleAt(s->deadline, std::move(s->fn));
+    delete s;
+    s = next;
+  }
+}
+
+// NextEventTick returns the first tick at which a slot has to be cascaded or expired
+int64_t TimerWheel::NextEventTick() const {
+  auto next = (std::numeric_limits<int64_t>::max)();
+  for (int level = 0; level < Levels; level++) {
+    if (occupied[level] == 0) {
+      continue;
+    }
+    auto shift = level * LevelBits;
+    auto digit = static_cast<uint32_t>(current >> shift) & (Slots - 1);
+    // pending slots of upper levels are always ahead of the current digit
+    auto pending = level == 0 ? occupied[0] >> digit << digit : occupied[level] >> digit >> 1 << 1 << digit;
+    if (pending == 0) {
+      continue;
+    }
+    auto base = current >> (shift + LevelBits) << (shift + LevelBits);
+    next = (std::min)(next, base | (static_cast<int64_t>(std::countr_zero(pending)) << shift));
+  }
+  if (heads[OverflowBucket] != npos) {
+    next = (std::min)(next, (current / overflowSpan + 1) * overflowSpan);
+  }
+  return next;
+}
+
+void TimerWheel::Cascade(uint32_t bucket) {
+  auto index = heads[bucket];
+  while (index != npos) {
+    auto next = nodes[index].next;
+    Unlink(index);
+    Place(index);
+    index = next;
+  }
+}
+
+// Expire runs the callbacks filed under the current tick. The batch is moved to its own list first so callbacks can
+// cancel each other and schedule new timers, which always land on later ticks.
+size_t TimerWheel::Expire() {
+  auto bucket = static_cast<uint32_t>(current) & (Slots - 1);
+  for (auto index = heads[bucket]; index != npos;) {
+    auto next = nodes[index].next;
+    Unlink(index);
+    Link(index, ExpiringBucket);
+    index = next;
+  }
+  size_t n = 0;
+  while (heads[ExpiringBucket] != npos) {
+    auto index = heads[ExpiringBucket];
+    Unlink(index);
+    auto fn = std::move(nodes[index].fn);
+    Release(index);
+    if (fn) {
+      fn();
+    }
+    n++;
+  }
+  return n;
+}
+
+size_t TimerWheel::Advance(bela::Duration now) {
+  Drain();
+  auto target = TicksFloor(now);
+  size_t n = 0;
+  while (size != 0) {
+    auto next = NextEventTick();
+    if (next > target) {
+      break;
+    }
+    current = next;
+    if (current % overflowSpan == 0) {
+      Cascade(OverflowBucket);
+    }
+    for (int level = Levels - 1; level > 0; level--) {
+      auto shift = level * LevelBits;
+      if ((current & ((int64_t{1} << shift) - 1)) == 0) {
+        Cascade(static_cast<uint32_t>(level) * Slots + (static_cast<uint32_t>(current >> shift) & (Slots - 1)));
+      }
+    }
+    n += Expire();
+  }
+  current = (std::max)(current, target);
+  return n;
+}
+
+bela::Duration TimerWheel::NextDeadline() const {
+  if (submissions.load(std::memory_order_relaxed) != nullptr) {
+    return Now();
+  }
+  if (size == 0) {
+    return bela::InfiniteDuration();
+  }
+  return origin + tick * NextEventTick();
+}
+
+size_t TimerWheel::Run(bela::Duration maxWait) {
+  auto n = Advance();
+  auto wait = (std::min)(NextDeadline() - bela::MonotonicNow(), maxWait);
+  if (wait > bela::ZeroDuration()) {
+    bela::SleepFor(wait);
+  }
+  return n + Advance();
+}
+
+} // namespace bela
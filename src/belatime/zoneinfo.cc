@@ -0,0 +1,527 @@
+/// TZif time zone loader
+#include <algorithm>
+#include <mutex>
+#include <bela/zoneinfo.hpp>
+#include <bela/endian.hpp>
+#include <bela/phmap.hpp>
+#include <bela/str_cat.hpp>
+#include <bela/codecvt.hpp>
+
+namespace bela {
+namespace {
+constexpr size_t npos = static_cast<size_t>(-1);
+// transitions generated from the POSIX TZ footer are materialized up to this year, later times evaluate the rule
+constexpr int64_t expandUntilYear = 2200;
+constexpr size_t tzifHeaderSize = 44;
+
+struct tzif_header {
+  uint8_t version{0};
+  uint32_t isutcnt{0};
+  uint32_t isstdcnt{0};
+  uint32_t leapcnt{0};
+  uint32_t timecnt{0};
+  uint32_t typecnt{0};
+  uint32_t charcnt{0};
+  // size of the data block that follows the header, timeSize is 4 (v1) or 8 (v2+)
+  size_t DataSize(size_t timeSize) const {
+    return timecnt * timeSize + timecnt + typecnt * 6 + charcnt + leapcnt * (timeSize + 4) + isstdcnt + isutcnt;
+  }
+};
+
+bool parse_header(bela::bytes_view bv, tzif_header &h) {
+  if (bv.size() < tzifHeaderSize || !bv.starts_with("TZif")) {
+    return false;
+  }
+  auto p = bv.data();
+  h.version = p[4];
+  h.isutcnt = bela::cast_frombe<uint32_t>(p + 20);
+  h.isstdcnt = bela::cast_frombe<uint32_t>(p + 24);
+  h.leapcnt = bela::cast_frombe<uint32_t>(p + 28);
+  h.timecnt = bela::cast_frombe<uint32_t>(p + 32);
+  h.typecnt = bela::cast_frombe<uint32_t>(p + 36);
+  h.charcnt = bela::cast_frombe<uint32_t>(p + 40);
+  // RFC 8536 limits: typecnt in [1, 256], isutcnt/isstdcnt are 0 or typecnt
+  return h.typecnt != 0 && h.typecnt <= 256 && (h.isutcnt == 0 || h.isutcnt == h.typecnt) &&
+         (h.isstdcnt == 0 || h.isstdcnt == h.typecnt) && h.timecnt <= (1U << 24) && h.charcnt <= (1U << 16) &&
+         h.leapcnt <= (1U << 16);
+}
+
+// POSIX TZ string parser: std offset [dst [offset] [,start[/time],end[/time]]]
+class posix_parser {
+public:
+  posix_parser(std::string_view s) : sv(s) {}
+  bool Name(std::string &name) {
+    if (!sv.empty() && sv.front() == '<') {
+      auto pos = sv.find('>');
+      if (pos == std::string_view::npos) {
+        return false;
+      }
+      name.assign(sv.substr(1, pos - 1));
+      sv.remove_prefix(pos + 1);
+      return !name.empty();
+    }
+    size_t i = 0;
+    while (i < sv.size() && ((sv[i] | 0x20) >= 'a' && (sv[i] | 0x20) <= 'z')) {
+      i++;
+    }
+    if (i < 3) {
+      return false;
+    }
+    name.assign(sv.substr(0, i));
+    sv.remove_prefix(i);
+    return true;
+  }
+  // [+-]hh[:mm[:ss]], returns seconds
+  bool Time(std::int_least32_t &value, int maxHours) {
+    int sign = 1;
+    if (!sv.empty() && (sv.front() == '+' || sv.front() == '-')) {
+      sign = sv.front() == '-' ? -1 : 1;
+      sv.remove_prefix(1);
+    }
+    int hours = 0;
+    int minutes = 0;
+    int seconds = 0;
+    if (!Number(hours, 0, maxHours)) {
+      return false;
+    }
+    if (Consume(':')) {
+      if (!Number(minutes, 0, 59)) {
+        return false;
+      }
+      if (Consume(':') && !Number(seconds, 0, 59)) {
+        return false;
+      }
+    }
+    value = sign * (hours * 3600 + minutes * 60 + seconds);
+    return true;
+  }
+  bool Boundary(TimeZone::zone_rule::boundary &b) {
+    using boundary = TimeZone::zone_rule::boundary;
+    int v = 0;
+    if (Consume('M')) {
+      int month = 0;
+      int week = 0;
+      int day = 0;
+      if (!Number(month, 1, 12) || !Consume('.') || !Number(week, 1, 5) || !Consume('.') || !Number(day, 0, 6)) {
+        return false;
+      }
+      b.kind = boundary::MonthWeekDay;
+      b.month = static_cast<uint8_t>(month);
+      b.week = static_cast<uint8_t>(week);
+      b.day = static_cast<int16_t>(day);
+    } else if (Consume('J')) {
+      if (!Number(v, 1, 365)) {
+        return false;
+      }
+      b.kind = boundary::Julian;
+      b.day = static_cast<int16_t>(v);
+    } else {
+      if (!Number(v, 0, 365)) {
+        return false;
+      }
+      b.kind = boundary::ZeroBasedDay;
+      b.day = static_cast<int16_t>(v);
+    }
+    b.time = 7200;
+    if (Consume('/')) {
+      // RFC 8536 (v3) extends the hours to [-167, 167]
+      return Time(b.time, 167);
+    }
+    return true;
+  }
+  bool Consume(char c) {
+    if (!sv.empty() && sv.front() == c) {
+      sv.remove_prefix(1);
+      return true;
+    }
+    return false;
+  }
+  bool Empty() const { return sv.empty(); }
+  bool Peek(char c) const { return !sv.empty() && sv.front() == c; }
+
+private:
+  bool Number(int &v, int minValue, int maxValue) {
+    size_t i = 0;
+    v = 0;
+    for (; i < sv.size() && sv[i] >= '0' && sv[i] <= '9' && i < 4; i++) {
+      v = v * 10 + (sv[i] - '0');
+    }
+    if (i == 0) {
+      return false;
+    }
+    sv.remove_prefix(i);
+    return v >= minValue && v <= maxValue;
+  }
+  std::string_view sv;
+};
+
+// days since epoch of a rule boundary in year
+int64_t boundary_days(const TimeZone::zone_rule::boundary &b, int64_t year) {
+  using boundary = TimeZone::zone_rule::boundary;
+  const auto jan1 = time_internal::DaysFromCivil(year, 1, 1);
+  switch (b.kind) {
+  case boundary::Julian:
+    // 1-based, February 29 is never counted
+    return jan1 + b.day - 1 + ((IsLeapYear(year) && b.day >= 60) ? 1 : 0);
+  case boundary::ZeroBasedDay:
+    return jan1 + b.day;
+  default:
+    break;
+  }
+  const auto first = time_internal::DaysFromCivil(year, b.month, 1);
+  const auto mondays =
+      IsLeapYear(year) ? time_internal::LeapMonths[b.month - 1] : time_internal::Months[b.month - 1];
+  auto day = first + (b.day - time_internal::WeekdayFromDays(first) + 7) % 7 + (b.week - 1) * 7;
+  // week 5 means the last such weekday of the month
+  while (day - first >= mondays) {
+    day -= 7;
+  }
+  return day;
+}
+
+int64_t floor_div(int64_t a, int64_t b) { return a / b - ((a % b) < 0 ? 1 : 0); }
+
+// UTC instants of the DST start and end of year
+std::pair<int64_t, int64_t> rule_transitions(const TimeZone::zone_rule &r, int64_t year) {
+  const auto start = boundary_days(r.start, year) * secondsPerDay + r.start.time - r.stdOffset;
+  const auto end = boundary_days(r.end, year) * secondsPerDay + r.end.time - r.dstOffset;
+  return {start, end};
+}
+
+} // namespace
+
+bool TimeZone::ParseRule(std::string_view footer) {
+  posix_parser pp(footer);
+  zone_rule r;
+  std::int_least32_t v = 0;
+  // POSIX offsets are positive west of Greenwich
+  if (!pp.Name(r.stdName) || !pp.Time(v, 24)) {
+    return false;
+  }
+  r.stdOffset = -v;
+  if (!pp.Empty()) {
+    if (!pp.Name(r.dstName)) {
+      return false;
+    }
+    r.hasDST = true;
+    r.dstOffset = r.stdOffset + 3600;
+    if (!pp.Empty() && !pp.Peek(',')) {
+      if (!pp.Time(v, 24)) {
+        return false;
+      }
+      r.dstOffset = -v;
+    }
+    if (pp.Empty()) {
+      // no rule given, POSIX leaves it implementation defined: use the US rules like most implementations
+      r.start = {.kind = zone_rule::boundary::MonthWeekDay, .day = 0, .month = 3, .week = 2};
+      r.end = {.kind = zone_rule::boundary::MonthWeekDay, .day = 0, .month = 11, .week = 1};
+    } else if (!pp.Consume(',') || !pp.Boundary(r.start) || !pp.Consume(',') || !pp.Boundary(r.end)) {
+      return false;
+    }
+  }
+  if (!pp.Empty()) {
+    return false;
+  }
+  rule = std::move(r);
+  return true;
+}
+
+uint8_t TimeZone::RuleType(int64_t sec) const {
+  const auto &r = *rule;
+  if (!r.hasDST) {
+    return r.stdType;
+  }
+  const auto year = time_internal::CivilFromDays(floor_div(sec + r.stdOffset, secondsPerDay)).year;
+  const auto [start, end] = rule_transitions(r, year);
+  const auto dst = start < end ? (sec >= start && sec < end) : !(sec >= end && sec < start);
+  return dst ? r.dstType : r.stdType;
+}
+
+size_t TimeZone::Search(int64_t sec) const {
+  auto it = std::upper_bound(transitions.begin(), transitions.end(), sec);
+  if (it == transitions.begin()) {
+    return npos;
+  }
+  return static_cast<size_t>(it - transitions.begin()) - 1;
+}
+
+uint8_t TimeZone::TypeAt(size_t pos, int64_t sec) const {
+  if (pos == npos) {
+    // before the first transition (or no transitions at all)
+    if (transitions.empty() && rule) {
+      return RuleType(sec);
+    }
+    return 0;
+  }
+  if (pos + 1 == transitions.size() && rule && sec >= ruleStart) {
+    return RuleType(sec);
+  }
+  return indexes[pos];
+}
+
+const TimeZone::zone_type &TimeZone::Lookup(int64_t sec) const {
+  const auto n = transitions.size();
+  auto pos = hint.load(std::memory_order_relaxed);
+  if (pos < n && transitions[pos] <= sec) {
+    // monotonically increasing timestamps: current or next interval
+    if (pos + 1 < n && transitions[pos + 1] <= sec) {
+      pos++;
+      if (pos + 1 < n && transitions[pos + 1] <= sec) {
+        pos = Search(sec);
+      }
+      hint.store(pos, std::memory_order_relaxed);
+    }
+  } else {
+    pos = Search(sec);
+    if (pos != npos) {
+      hint.store(pos, std::memory_order_relaxed);
+    }
+  }
+  return types[TypeAt(pos, sec)];
+}
+
+std::int_least32_t TimeZone::Offset(int64_t sec) const { return Lookup(sec).offset; }
+
+void TimeZone::Offsets(std::span<const int64_t> seconds, std::span<std::int_least32_t> out) const {
+  const auto n = transitions.size();
+  const auto count = (std::min)(seconds.size(), out.size());
+  size_t pos = npos;
+  int64_t lower = (std::numeric_limits<int64_t>::max)(); // [lower, upper) is the interval of pos
+  int64_t upper = (std::numeric_limits<int64_t>::min)();
+  std::int_least32_t offset = 0;
+  for (size_t i = 0; i < count; i++) {
+    const auto sec = seconds[i];
+    if (sec >= lower && sec < upper) {
+      out[i] = offset;
+      continue;
+    }
+    if (pos != npos && sec >= upper && pos + 1 < n && (pos + 2 == n || sec < transitions[pos + 2])) {
+      pos++;
+    } else {
+      pos = Search(sec);
+    }
+    out[i] = types[TypeAt(pos, sec)].offset;
+    // only cache intervals whose type does not depend on the POSIX rule
+    if ((pos == npos && !transitions.empty()) || (pos != npos && pos + 1 < n)) {
+      lower = pos == npos ? (std::numeric_limits<int64_t>::min)() : transitions[pos];
+      upper = transitions[pos == npos ? 0 : pos + 1];
+      offset = out[i];
+    } else {
+      lower = (std::numeric_limits<int64_t>::max)();
+      upper = (std::numeric_limits<int64_t>::min)();
+    }
+  }
+}
+
+bool TimeZone::ExpandRule(int64_t untilYear, bela::error_code &ec) {
+  auto &r = *rule;
+  auto typeOf = [&](std::int_least32_t offset, bool dst, std::string_view abbr, uint8_t &index) {
+    for (size_t i = 0; i < types.size(); i++) {
+      if (types[i].offset == offset && types[i].dst == dst && types[i].abbreviation == abbr) {
+        index = static_cast<uint8_t>(i);
+        return true;
+      }
+    }
+    if (types.size() >= 256) {
+      return false;
+    }
+    index = static_cast<uint8_t>(types.size());
+    types.emplace_back(zone_type{.offset = offset, .dst = dst, .abbreviation = std::string(abbr)});
+    return true;
+  };
+  if (!typeOf(r.stdOffset, false, r.stdName, r.stdType) ||
+      (r.hasDST && !typeOf(r.dstOffset, true, r.dstName, r.dstType))) {
+    ec = bela::make_error_code(ErrGeneral, L"tzif: too many local time types");
+    return false;
+  }
+  if (!r.hasDST) {
+    ruleStart = transitions.empty() ? (std::numeric_limits<int64_t>::min)() : transitions.back();
+    return true;
+  }
+  const auto last = transitions.empty() ? (std::numeric_limits<int64_t>::min)() : transitions.back();
+  const auto firstYear = transitions.empty() ? 1970 : time_internal::CivilFromDays(floor_div(last, secondsPerDay)).year;
+  for (auto year = firstYear; year <= untilYear; year++) {
+    auto [start, end] = rule_transitions(r, year);
+    std::pair<int64_t, uint8_t> items[] = {{start, r.dstType}, {end, r.stdType}};
+    if (end < start) {
+      std::swap(items[0], items[1]);
+    }
+    for (const auto &[at, index] : items) {
+      if (at > last && (transitions.empty() || at > transitions.back())) {
+        transitions.emplace_back(at);
+        indexes.emplace_back(index);
+      }
+    }
+  }
+  ruleStart = transitions.empty() ? (std::numeric_limits<int64_t>::min)() : transitions.back();
+  return true;
+}
+
+std::shared_ptr<TimeZone> TimeZone::Parse(std::wstring_view name, bela::bytes_view bv, bela::error_code &ec) {
+  tzif_header h;
+  if (!parse_header(bv, h)) {
+    ec = bela::make_error_code(ErrGeneral, L"tzif: bad header");
+    return nullptr;
+  }
+  size_t timeSize = 4;
+  size_t offset = tzifHeaderSize;
+  if (h.version >= '2') {
+    // skip the v1 block, use the 64-bit data
+    offset += h.DataSize(4);
+    if (!parse_header(bv.subview(offset), h)) {
+      ec = bela::make_error_code(ErrGeneral, L"tzif: bad v2 header");
+      return nullptr;
+    }
+    offset += tzifHeaderSize;
+    timeSize = 8;
+  }
+  if (bv.size() < offset + h.DataSize(timeSize)) {
+    ec = bela::make_error_code(ErrFileTooSmall, L"tzif: truncated data");
+    return nullptr;
+  }
+  auto tz = std::make_shared<TimeZone>();
+  tz->name = name;
+  auto p = bv.data() + offset;
+  tz->transitions.resize(h.timecnt);
+  for (uint32_t i = 0; i < h.timecnt; i++, p += timeSize) {
+    tz->transitions[i] = timeSize == 8 ? bela::cast_frombe<int64_t>(p) : bela::cast_frombe<int32_t>(p);
+  }
+  tz->indexes.assign(p, p + h.timecnt);
+  p += h.timecnt;
+  if (std::any_of(tz->indexes.begin(), tz->indexes.end(), [&](uint8_t i) { return i >= h.typecnt; }) ||
+      !std::is_sorted(tz->transitions.begin(), tz->transitions.end())) {
+    ec = bela::make_error_code(ErrGeneral, L"tzif: bad transitions");
+    return nullptr;
+  }
+  const auto designations = reinterpret_cast<const char *>(p + h.typecnt * 6);
+  tz->types.resize(h.typecnt);
+  for (uint32_t i = 0; i < h.typecnt; i++, p += 6) {
+    auto &t = tz->types[i];
+    t.offset = bela::cast_frombe<int32_t>(p);
+    t.dst = p[4] != 0;
+    if (p[5] >= h.charcnt) {
+      ec = bela::make_error_code(ErrGeneral, L"tzif: bad designation index");
+      return nullptr;
+    }
+    std::string_view abbr(designations + p[5], h.charcnt - p[5]);
+    t.abbreviation.assign(abbr.substr(0, abbr.find('\0')));
+  }
+  offset += h.DataSize(timeSize);
+  if (timeSize == 8) {
+    // footer: "\n" TZ-string "\n"
+    auto footer = bv.make_string_view<char>(offset);
+    if (footer.size() >= 2 && footer.front() == '\n') {
+      footer.remove_prefix(1);
+      if (auto pos = footer.find('\n'); pos != std::string_view::npos && pos != 0) {
+        if (!tz->ParseRule(footer.substr(0, pos))) {
+          ec = bela::make_error_code(ErrGeneral, L"tzif: bad footer '",
+                                     bela::encode_into<char, wchar_t>(footer.substr(0, pos)), L"'");
+          return nullptr;
+        }
+        if (!tz->ExpandRule(expandUntilYear, ec)) {
+          return nullptr;
+        }
+      }
+    }
+  }
+  return tz;
+}
+
+namespace {
+struct zone_cache {
+  std::mutex mu;
+  std::wstring dir;
+  bool initialized{false};
+  bela::flat_hash_map<std::wstring, std::shared_ptr<const TimeZone>> zones;
+};
+
+zone_cache &global_zone_cache() {
+  static zone_cache cache;
+  return cache;
+}
+
+// valid_zone_name accepts relative names inside the zoneinfo directory only: no absolute or drive qualified path, no
+// '..' and no ':' (drives and alternate data streams)
+bool valid_zone_name(std::wstring_view name) {
+  if (name.empty() || name.front() == L'\\' || name.front() == L'/' || name.find(L':') != std::wstring_view::npos) {
+    return false;
+  }
+  return name.find(L"..") == std::wstring_view::npos;
+}
+
+bool read_zone_file(const std::wstring &path, std::vector<uint8_t> &data, bela::error_code &ec) {
+  auto fd = CreateFileW(path.data(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL,
+                        nullptr);
+  if (fd == INVALID_HANDLE_VALUE) {
+    ec = bela::make_system_error_code(L"CreateFileW() ");
+    return false;
+  }
+  auto closer = bela::finally([&] { CloseHandle(fd); });
+  LARGE_INTEGER li;
+  if (GetFileSizeEx(fd, &li) != TRUE) {
+    ec = bela::make_system_error_code(L"GetFileSizeEx() ");
+    return false;
+  }
+  // zoneinfo files are a few KB, refuse anything unreasonable
+  if (li.QuadPart > 16 * 1024 * 1024) {
+    ec = bela::make_error_code(ErrGeneral, L"tzif: file too large");
+    return false;
+  }
+  data.resize(static_cast<size_t>(li.QuadPart));
+  DWORD n = 0;
+  if (::ReadFile(fd, data.data(), static_cast<DWORD>(data.size()), &n, nullptr) != TRUE) {
+    ec = bela::make_system_error_code(L"ReadFile() ");
+    return false;
+  }
+  data.resize(n);
+  return true;
+}
+} // namespace
+
+void SetZoneInfoDirectory(std::wstring_view dir) {
+  auto &cache = global_zone_cache();
+  std::scoped_lock lock(cache.mu);
+  cache.dir = dir;
+  cache.initialized = true;
+  cache.zones.clear();
+}
+
+std::shared_ptr<const TimeZone> LoadTimeZone(std::wstring_view name, bela::error_code &ec) {
+  if (!valid_zone_name(name)) {
+    ec = bela::make_error_code(ErrGeneral, L"invalid time zone name '", name, L"'");
+    return nullptr;
+  }
+  auto &cache = global_zone_cache();
+  std::wstring dir;
+  {
+    std::scoped_lock lock(cache.mu);
+    if (auto it = cache.zones.find(name); it != cache.zones.end()) {
+      return it->second;
+    }
+    if (!cache.initialized) {
+      cache.dir.resize(MAX_PATH);
+      auto n = GetEnvironmentVariableW(L"TZDIR", cache.dir.data(), MAX_PATH);
+      cache.dir.resize(n < MAX_PATH ? n : 0);
+      cache.initialized = true;
+    }
+    dir = cache.dir;
+  }
+  if (dir.empty()) {
+    ec = bela::make_error_code(ErrGeneral, L"zoneinfo directory not configured");
+    return nullptr;
+  }
+  std::vector<uint8_t> data;
+  if (!read_zone_file(bela::StringCat(dir, L"\\", name), data, ec)) {
+    return nullptr;
+  }
+  auto tz = TimeZone::Parse(name, bela::bytes_view(data.data(), data.size()), ec);
+  if (!tz) {
+    return nullptr;
+  }
+  std::scoped_lock lock(cache.mu);
+  // another thread may have loaded the zone meanwhile, keep the first one
+  auto [it, _] = cache.zones.try_emplace(std::wstring(name), std::move(tz));
+  return it->second;
+}
+
+} // namespace bela
@@ -0,0 +1,488 @@
+//
+#include <bela/und.hpp>
+#include <bela/phmap.hpp>
+#include <array>
+#include <atomic>
+#include <cstdlib>
+#include <thread>
+#include "llvm/Demangle/Demangle.h"
+#include "llvm/Demangle/ItaniumDemangle.h"
+#include "llvm/Demangle/MicrosoftDemangle.h"
+#include "llvm/Demangle/MicrosoftDemangleNodes.h"
+
+namespace bela {
+namespace und_internal {
+// arena_allocator is a bump allocator whose blocks survive reset(): after a few names it stops allocating
+class arena_allocator {
+public:
+  static constexpr size_t BlockSize = 32 * 1024;
+  arena_allocator() = default;
+  arena_allocator(const arena_allocator &) = delete;
+  arena_allocator &operator=(const arena_allocator &) = delete;
+  ~arena_allocator() {
+    release_large();
+    for (auto b : blocks) {
+      std::free(b);
+    }
+  }
+  void reset() {
+    release_large();
+    current = 0;
+    used = 0;
+  }
+  void *allocate(size_t n) {
+    n = (n + 15) & ~static_cast<size_t>(15);
+    if (n > BlockSize / 4) {
+      return large.emplace_back(checked_malloc(n));
+    }
+    if (used + n > BlockSize) {
+      current++;
+      used = 0;
+    }
+    if (current == blocks.size()) {
+      blocks.emplace_back(checked_malloc(BlockSize));
+    }
+    auto p = static_cast<char *>(blocks[current]) + used;
+    used += n;
+    return p;
+  }
+  template <typename T, typename... Args> T *makeNode(Args &&...args) {
+    return new (allocate(sizeof(T))) T(std::forward<Args>(args)...);
+  }
+  void *allocateNodeArray(size_t n) { return allocate(sizeof(llvm::itanium_demangle::Node *) * n); }
+
+private:
+  static void *checked_malloc(size_t n) {
+    auto p = std::malloc(n);
+    if (p == nullptr) {
+      std::terminate();
+    }
+    return p;
+  }
+  void release_large() {
+    for (auto p : large) {
+      std::free(p);
+    }
+    large.clear();
+  }
+  std::vector<void *> blocks;
+  std::vector<void *> large;
+  size_t current{0};
+  size_t used{0};
+};
+
+inline bool IsItaniumEncoding(std::string_view s) {
+  // Itanium demangler supports prefixes with 1-4 underscores.
+  const size_t pos = s.find_first_not_of('_');
+  return pos > 0 && pos <= 4 && pos < s.size() && s[pos] == 'Z';
+}
+
+inline void Commit(llvm::itanium_demangle::OutputBuffer &ob, char *&buffer, size_t &capacity, size_t &length) {
+  buffer = ob.getBuffer();
+  capacity = ob.getBufferCapacity();
+  length = ob.getCurrentPosition();
+}
+
+using llvm::itanium_demangle::Node;
+
+// scope_path collects the identifiers of nested scopes, outermost first. Scopes without an identifier (lambdas,
+// constructors of a local entity) are kept as empty parts that match nothing, scopes deeper than parts are dropped.
+struct scope_path {
+  std::array<std::string_view, 64> parts;
+  size_t size{0};
+  void push(std::string_view part) {
+    if (size < parts.size()) {
+      parts[size++] = part;
+    }
+  }
+};
+
+// AppendScopes appends the scopes named by a qualifier
+void AppendScopes(const Node *n, scope_path &path) {
+  using namespace llvm::itanium_demangle;
+  switch (n->getKind()) {
+  case Node::KNestedName: {
+    auto nn = static_cast<const NestedName *>(n);
+    AppendScopes(nn->Qual, path);
+    AppendScopes(nn->Name, path);
+    return;
+  }
+  case Node::KNameWithTemplateArgs:
+    AppendScopes(static_cast<const NameWithTemplateArgs *>(n)->Name, path);
+    return;
+  case Node::KAbiTagAttr:
+    AppendScopes(static_cast<const AbiTagAttr *>(n)->Base, path);
+    return;
+  case Node::KModuleEntity:
+    AppendScopes(static_cast<const ModuleEntity *>(n)->Name, path);
+    return;
+  case Node::KGlobalQualifiedName:
+    static_cast<const GlobalQualifiedName *>(n)->match([&](const Node *child) { AppendScopes(child, path); });
+    return;
+  case Node::KSpecialSubstitution:
+  case Node::KExpandedSpecialSubstitution:
+    // St, Sa, Ss ... name std:: members
+    path.push("std");
+    path.push(n->getBaseName());
+    return;
+  default:
+    break;
+  }
+  path.push(n->getBaseName());
+}
+
+// EntityName returns the name of the function or variable, nullptr for special names
+inline const Node *EntityName(const Node *root) {
+  using namespace llvm::itanium_demangle;
+  if (root == nullptr) {
+    return nullptr;
+  }
+  switch (root->getKind()) {
+  case Node::KFunctionEncoding:
+    return static_cast<const FunctionEncoding *>(root)->getName();
+  case Node::KSpecialName:
+  case Node::KCtorVtableSpecialName:
+    return nullptr;
+  default:
+    break;
+  }
+  return root;
+}
+
+// EntityScopes appends the scopes enclosing an entity, a local entity is enclosed by its function
+void EntityScopes(const Node *name, scope_path &path) {
+  using namespace llvm::itanium_demangle;
+  for (;;) {
+    switch (name->getKind()) {
+    case Node::KAbiTagAttr:
+      name = static_cast<const AbiTagAttr *>(name)->Base;
+      continue;
+    case Node::KNameWithTemplateArgs:
+      name = static_cast<const NameWithTemplateArgs *>(name)->Name;
+      continue;
+    case Node::KModuleEntity:
+      name = static_cast<const ModuleEntity *>(name)->Name;
+      continue;
+    case Node::KNestedName:
+      AppendScopes(static_cast<const NestedName *>(name)->Qual, path);
+      return;
+    case Node::KLocalName: {
+      auto ln = static_cast<const LocalName *>(name);
+      if (auto fn = EntityName(ln->Encoding); fn != nullptr) {
+        AppendScopes(fn, path);
+      } else {
+        path.push({});
+      }
+      name = ln->Entity;
+      continue;
+    }
+    default:
+      break;
+    }
+    return;
+  }
+}
+} // namespace und_internal
+
+struct Demangler::Context {
+  llvm::itanium_demangle::ManglingParser<und_internal::arena_allocator> itanium{nullptr, nullptr};
+  llvm::ms_demangle::Demangler microsoft;
+  // root of the tree built by Parse
+  const llvm::itanium_demangle::Node *root{nullptr};
+};
+
+Demangler::Demangler() : context(new Context) {}
+
+Demangler::~Demangler() {
+  delete context;
+  std::free(buffer);
+}
+
+bool Demangler::NonMicrosoftDemangle(std::string_view name, bool canHaveLeadingDot) {
+  using llvm::itanium_demangle::OutputBuffer;
+  // Do not consider the dot prefix as part of the demangled symbol name.
+  std::string_view dot;
+  if (canHaveLeadingDot && !name.empty() && name.front() == '.') {
+    name.remove_prefix(1);
+    dot = ".";
+  }
+  if (und_internal::IsItaniumEncoding(name)) {
+    auto &parser = context->itanium;
+    context->root = nullptr;
+    parser.reset(name.data(), name.data() + name.size());
+    auto ast = parser.parse(true);
+    if (ast == nullptr) {
+      return false;
+    }
+    OutputBuffer ob(buffer, capacity);
+    ob += dot;
+    ast->print(ob);
+    und_internal::Commit(ob, buffer, capacity, length);
+    return true;
+  }
+  char *demangled = nullptr;
+  if (name.starts_with("_R")) {
+    demangled = llvm::rustDemangle(name);
+  } else if (name.starts_with("_D")) {
+    demangled = llvm::dlangDemangle(name);
+  }
+  if (demangled == nullptr) {
+    return false;
+  }
+  OutputBuffer ob(buffer, capacity);
+  ob += dot;
+  ob += std::string_view(demangled);
+  std::free(demangled);
+  und_internal::Commit(ob, buffer, capacity, length);
+  return true;
+}
+
+bool Demangler::MicrosoftDemangle(std::string_view name, size_t *consumed) {
+  auto &d = context->microsoft;
+  d.reset();
+  auto rest = name;
+  auto ast = d.parse(rest);
+  if (d.Error) {
+    return false;
+  }
+  if (consumed != nullptr) {
+    *consumed = name.size() - rest.size();
+  }
+  llvm::itanium_demangle::OutputBuffer ob(buffer, capacity);
+  ast->output(ob, llvm::ms_demangle::OF_Default);
+  und_internal::Commit(ob, buffer, capacity, length);
+  return true;
+}
+
+// same order of attempts as llvm::demangle
+std::string_view Demangler::Demangle(std::string_view name) {
+  if (NonMicrosoftDemangle(name, true) || (name.starts_with('_') && NonMicrosoftDemangle(name.substr(1), false)) ||
+      MicrosoftDemangle(name)) {
+    return std::string_view{buffer, length};
+  }
+  return name;
+}
+
+void Demangler::Demangle(std::span<const std::string_view> names, DemangledNames &out) {
+  out.offsets.reserve(out.offsets.size() + names.size());
+  for (auto name : names) {
+    out.buffer.append(Demangle(name));
+    out.offsets.emplace_back(out.buffer.size());
+  }
+}
+
+bool Demangler::Parse(std::string_view name) {
+  context->root = nullptr;
+  if (!und_internal::IsItaniumEncoding(name)) {
+    return false;
+  }
+  auto &parser = context->itanium;
+  parser.reset(name.data(), name.data() + name.size());
+  context->root = parser.parse(true);
+  return context->root != nullptr;
+}
+
+bool Demangler::IsFunction() const {
+  return context->root != nullptr && context->root->getKind() == und_internal::Node::KFunctionEncoding;
+}
+
+bool Demangler::IsSpecialName() const {
+  if (context->root == nullptr) {
+    return false;
+  }
+  auto k = context->root->getKind();
+  return k == und_internal::Node::KSpecialName || k == und_internal::Node::KCtorVtableSpecialName;
+}
+
+bool Demangler::IsData() const { return context->root != nullptr && !IsFunction() && !IsSpecialName(); }
+
+bool Demangler::IsCtorOrDtor() const {
+  using namespace llvm::itanium_demangle;
+  auto n = und_internal::EntityName(context->root);
+  while (n != nullptr) {
+    switch (n->getKind()) {
+    case Node::KCtorDtorName:
+      return true;
+    case Node::KAbiTagAttr:
+      n = static_cast<const AbiTagAttr *>(n)->Base;
+      break;
+    case Node::KLocalName:
+      n = static_cast<const LocalName *>(n)->Entity;
+      break;
+    case Node::KNameWithTemplateArgs:
+      n = static_cast<const NameWithTemplateArgs *>(n)->Name;
+      break;
+    case Node::KNestedName:
+      n = static_cast<const NestedName *>(n)->Name;
+      break;
+    case Node::KModuleEntity:
+      n = static_cast<const ModuleEntity *>(n)->Name;
+      break;
+    default:
+      return false;
+    }
+  }
+  return false;
+}
+
+size_t Demangler::ParameterCount() const {
+  if (!IsFunction()) {
+    return 0;
+  }
+  return static_cast<const llvm::itanium_demangle::FunctionEncoding *>(context->root)->getParams().size();
+}
+
+bool Demangler::InScope(std::string_view scope) const {
+  auto name = und_internal::EntityName(context->root);
+  if (name == nullptr) {
+    return false;
+  }
+  und_internal::scope_path path;
+  und_internal::EntityScopes(name, path);
+  if (scope.starts_with("::")) {
+    scope.remove_prefix(2);
+  }
+  for (size_t i = 0; !scope.empty(); i++) {
+    auto pos = scope.find("::");
+    if (i == path.size || path.parts[i] != scope.substr(0, pos)) {
+      return false;
+    }
+    scope = pos == std::string_view::npos ? std::string_view{} : scope.substr(pos + 2);
+  }
+  return true;
+}
+
+std::string_view Demangler::BaseName() {
+  using namespace llvm::itanium_demangle;
+  auto n = und_internal::EntityName(context->root);
+  while (n != nullptr) {
+    switch (n->getKind()) {
+    case Node::KAbiTagAttr:
+      n = static_cast<const AbiTagAttr *>(n)->Base;
+      continue;
+    case Node::KModuleEntity:
+      n = static_cast<const ModuleEntity *>(n)->Name;
+      continue;
+    case Node::KNestedName:
+      n = static_cast<const NestedName *>(n)->Name;
+      continue;
+    case Node::KLocalName:
+      n = static_cast<const LocalName *>(n)->Entity;
+      continue;
+    case Node::KNameWithTemplateArgs:
+      n = static_cast<const NameWithTemplateArgs *>(n)->Name;
+      continue;
+    case Node::KNameType:
+      return static_cast<const NameType *>(n)->getName();
+    default:
+      break;
+    }
+    OutputBuffer ob(buffer, capacity);
+    n->print(ob);
+    und_internal::Commit(ob, buffer, capacity, length);
+    return std::string_view{buffer, length};
+  }
+  return {};
+}
+
+std::string_view Demangler::Scope() {
+  using namespace llvm::itanium_demangle;
+  auto n = und_internal::EntityName(context->root);
+  if (n == nullptr) {
+    return {};
+  }
+  OutputBuffer ob(buffer, capacity);
+  // the separator after the function of a local entity is only written when the entity adds a qualifier
+  bool qualified = false;
+  for (;;) {
+    switch (n->getKind()) {
+    case Node::KAbiTagAttr:
+      n = static_cast<const AbiTagAttr *>(n)->Base;
+      continue;
+    case Node::KNameWithTemplateArgs:
+      n = static_cast<const NameWithTemplateArgs *>(n)->Name;
+      continue;
+    case Node::KModuleEntity:
+      n = static_cast<const ModuleEntity *>(n)->Name;
+      continue;
+    case Node::KNestedName:
+      if (qualified) {
+        ob += "::";
+      }
+      static_cast<const NestedName *>(n)->Qual->print(ob);
+      break;
+    case Node::KLocalName: {
+      auto ln = static_cast<const LocalName *>(n);
+      if (qualified) {
+        ob += "::";
+      }
+      ln->Encoding->print(ob);
+      qualified = true;
+      n = ln->Entity;
+      continue;
+    }
+    default:
+      break;
+    }
+    break;
+  }
+  und_internal::Commit(ob, buffer, capacity, length);
+  return std::string_view{buffer, length};
+}
+
+DemangledNames DemangleAll(std::span<const std::string_view> names, size_t concurrency) {
+  constexpr size_t chunkSize = 1024;
+  std::vector<uint32_t> indexes(names.size());
+  std::vector<std::string_view> uniques;
+  {
+    bela::flat_hash_map<std::string_view, uint32_t> seen;
+    seen.reserve(names.size());
+    for (size_t i = 0; i < names.size(); i++) {
+      auto [it, inserted] = seen.try_emplace(names[i], static_cast<uint32_t>(uniques.size()));
+      if (inserted) {
+        uniques.emplace_back(names[i]);
+      }
+      indexes[i] = it->second;
+    }
+  }
+  // chunk c holds the results of uniques [c * chunkSize, (c + 1) * chunkSize)
+  std::vector<DemangledNames> chunks((uniques.size() + chunkSize - 1) / chunkSize);
+  std::atomic_size_t next{0};
+  auto worker = [&] {
+    Demangler demangler;
+    for (;;) {
+      auto c = next.fetch_add(1, std::memory_order_relaxed);
+      if (c >= chunks.size()) {
+        return;
+      }
+      auto first = c * chunkSize;
+      demangler.Demangle(std::span{uniques}.subspan(first, (std::min)(chunkSize, uniques.size() - first)), chunks[c]);
+    }
+  };
+  if (concurrency == 0) {
+    concurrency = (std::max)(std::thread::hardware_concurrency(), 1U);
+  }
+  concurrency = (std::min)(concurrency, chunks.size());
+  {
+    // the calling thread is one of the workers
+    std::vector<std::jthread> workers;
+    for (size_t i = 1; i < concurrency; i++) {
+      workers.emplace_back(worker);
+    }
+    worker();
+  }
+  DemangledNames out;
+  size_t total = 0;
+  for (auto i : indexes) {
+    total += chunks[i / chunkSize][i % chunkSize].size();
+  }
+  out.buffer.reserve(total);
+  out.offsets.reserve(names.size() + 1);
+  for (auto i : indexes) {
+    out.buffer.append(chunks[i / chunkSize][i % chunkSize]);
+    out.offsets.emplace_back(out.buffer.size());
+  }
+  return out;
+}
+
+} // namespace bela
@@ -59,6 +59,17 @@ public:
   ArenaAllocator(const ArenaAllocator &) = delete;
   ArenaAllocator &operator=(const ArenaAllocator &) = delete;
 
+  // bela: release every node but the first one so the allocator can be reused
+  void reset() {
+    while (Head->Next) {
+      AllocatorNode *Next = Head->Next;
+      delete[] Head->Buf;
+      delete Head;
+      Head = Next;
+    }
+    Head->Used = 0;
+  }
+
   char *allocUnalignedBuffer(size_t Size) {
     assert(Head && Head->Buf);
 
@@ -158,6 +169,13 @@ public:
   // True if an error occurred.
   bool Error = false;
 
+  // bela: forget the previous symbol, keeping the arena's first node
+  void reset() {
+    Arena.reset();
+    Backrefs = BackrefContext();
+    Error = false;
+  }
+
   void dumpBackReferences();
 
 private:
@@ -0,0 +1,165 @@
+//
+#include <bela/und.hpp>
+#include <bela/macros.hpp>
+#include <array>
+#include <bit>
+#if defined(BELA_INTERNAL_HAVE_SSE2)
+#include <emmintrin.h>
+#endif
+
+namespace bela {
+namespace und_internal {
+// characters that continue an identifier: a mangled name must not be preceded by one of them
+constexpr auto identifierTable = [] {
+  std::array<bool, 256> t{};
+  for (int c = 'a'; c <= 'z'; c++) {
+    t[c] = true;
+    t[c - 'a' + 'A'] = true;
+  }
+  for (int c = '0'; c <= '9'; c++) {
+    t[c] = true;
+  }
+  t['_'] = true;
+  t['$'] = true;
+  return t;
+}();
+
+constexpr bool IsIdentifier(char c) { return identifierTable[static_cast<uint8_t>(c)]; }
+
+// Itanium, Rust and D names also carry '.' suffixes such as ".cold" or ".llvm.1234"
+constexpr bool IsSymbolChar(char c) { return IsIdentifier(c) || c == '.'; }
+
+// Microsoft names stop at whitespace, quotes and list punctuation; the parser reports how much it consumed
+constexpr bool IsMicrosoftStop(char c) {
+  switch (c) {
+  case ' ':
+  case '\t':
+  case '\r':
+  case '\n':
+  case '"':
+  case '\'':
+  case '(':
+  case ')':
+  case ',':
+  case ';':
+    return true;
+  default:
+    break;
+  }
+  return false;
+}
+
+#if defined(BELA_INTERNAL_HAVE_SSE2)
+// bytes in [lo, hi], signed compares keep bytes >= 0x80 out of every range
+inline __m128i InRange(__m128i v, char lo, char hi) {
+  return _mm_and_si128(_mm_cmpgt_epi8(v, _mm_set1_epi8(static_cast<char>(lo - 1))),
+                       _mm_cmplt_epi8(v, _mm_set1_epi8(static_cast<char>(hi + 1))));
+}
+
+inline __m128i IdentifierMask(__m128i v) {
+  auto alpha = InRange(_mm_or_si128(v, _mm_set1_epi8(0x20)), 'a', 'z');
+  auto digit = InRange(v, '0', '9');
+  auto other = _mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8('_')), _mm_cmpeq_epi8(v, _mm_set1_epi8('$')));
+  return _mm_or_si128(_mm_or_si128(alpha, digit), other);
+}
+#endif
+
+// FindCandidate returns the position of the next '_' or '?' at or after pos that is not preceded by an identifier
+// character, 16 bytes per step when SSE2 is available.
+size_t FindCandidate(std::string_view text, size_t pos) {
+  const auto size = text.size();
+  const auto *p = text.data();
+#if defined(BELA_INTERNAL_HAVE_SSE2)
+  const auto underscore = _mm_set1_epi8('_');
+  const auto question = _mm_set1_epi8('?');
+  for (; pos + 16 <= size; pos += 16) {
+    auto v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p + pos));
+    auto prev = pos == 0 ? _mm_slli_si128(v, 1) : _mm_loadu_si128(reinterpret_cast<const __m128i *>(p + pos - 1));
+    auto candidate = _mm_or_si128(_mm_cmpeq_epi8(v, underscore), _mm_cmpeq_epi8(v, question));
+    if (auto mask = static_cast<unsigned>(_mm_movemask_epi8(_mm_andnot_si128(IdentifierMask(prev), candidate)));
+        mask != 0) {
+      return pos + std::countr_zero(mask);
+    }
+  }
+#endif
+  for (; pos < size; pos++) {
+    if ((p[pos] == '_' || p[pos] == '?') && (pos == 0 || !IsIdentifier(p[pos - 1]))) {
+      return pos;
+    }
+  }
+  return std::string_view::npos;
+}
+
+// text_writer batches small pieces into one buffer and forwards large unchanged spans without copying
+class text_writer {
+public:
+  static constexpr size_t DirectSize = 4096;
+  static constexpr size_t BufferSize = 64 * 1024;
+  text_writer(const text_sink_t &sink_) : sink(sink_) { buffer.reserve(BufferSize); }
+  text_writer(const text_writer &) = delete;
+  text_writer &operator=(const text_writer &) = delete;
+  void Write(std::string_view sv) {
+    if (sv.size() >= DirectSize) {
+      Flush();
+      sink(sv);
+      return;
+    }
+    buffer.append(sv);
+    if (buffer.size() >= BufferSize) {
+      Flush();
+    }
+  }
+  void Flush() {
+    if (!buffer.empty()) {
+      sink(buffer);
+      buffer.clear();
+    }
+  }
+
+private:
+  const text_sink_t &sink;
+  std::string buffer;
+};
+} // namespace und_internal
+
+size_t DemangleText(std::string_view input, const text_sink_t &sink) {
+  Demangler demangler;
+  und_internal::text_writer writer(sink);
+  size_t replaced = 0;
+  size_t written = 0; // input[0, written) has been passed to writer
+  size_t pos = 0;
+  while ((pos = und_internal::FindCandidate(input, pos)) != std::string_view::npos) {
+    size_t end = pos + 1;
+    bool demangled = false;
+    if (input[pos] == '?') {
+      while (end < input.size() && !und_internal::IsMicrosoftStop(input[end])) {
+        end++;
+      }
+      // a failed candidate resumes after the scanned run: restarting at each '?' of a long run is quadratic
+      size_t consumed = 0;
+      if (demangler.MicrosoftDemangle(input.substr(pos, end - pos), &consumed) && consumed != 0) {
+        end = pos + consumed;
+        demangled = true;
+      }
+    } else {
+      while (end < input.size() && und_internal::IsSymbolChar(input[end])) {
+        end++;
+      }
+      auto token = input.substr(pos, end - pos);
+      demangled = token.size() > 2 && (demangler.NonMicrosoftDemangle(token, false) ||
+                                       (token[1] == '_' && demangler.NonMicrosoftDemangle(token.substr(1), false)));
+    }
+    if (demangled) {
+      writer.Write(input.substr(written, pos - written));
+      writer.Write(std::string_view{demangler.buffer, demangler.length});
+      written = end;
+      replaced++;
+    }
+    pos = end;
+  }
+  writer.Write(input.substr(written));
+  writer.Flush();
+  return replaced;
+}
+
+} // namespace bela
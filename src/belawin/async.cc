@@ -0,0 +1,150 @@
+//
+#include <bela/async.hpp>
+#include <new>
+
+namespace bela {
+namespace async_internal {
+void CALLBACK OnIoComplete(PTP_CALLBACK_INSTANCE, PVOID, PVOID overlapped, ULONG result, ULONG_PTR bytes, PTP_IO) {
+  auto *op = static_cast<overlapped_operation *>(static_cast<OVERLAPPED *>(overlapped));
+  op->result = result;
+  op->bytes = static_cast<DWORD>(bytes);
+  op->Resume();
+}
+} // namespace async_internal
+
+namespace io {
+constexpr auto readmax = (std::numeric_limits<DWORD>::max)();
+
+void AsyncFile::Free() {
+  if (fd != INVALID_HANDLE_VALUE) {
+    // closing the handle cancels pending reads, their completions still run before the io object goes away
+    CloseHandle(fd);
+    fd = INVALID_HANDLE_VALUE;
+  }
+  if (io != nullptr) {
+    WaitForThreadpoolIoCallbacks(io, FALSE);
+    CloseThreadpoolIo(io);
+    io = nullptr;
+  }
+}
+
+void AsyncFile::MoveFrom(AsyncFile &&o) {
+  Free();
+  fd = std::exchange(o.fd, INVALID_HANDLE_VALUE);
+  io = std::exchange(o.io, nullptr);
+  pool = o.pool;
+  skipOnSuccess = o.skipOnSuccess;
+}
+
+bool AsyncFile::Open(std::wstring_view file, bela::error_code &ec, ThreadPool &pool_) {
+  Free();
+  auto h = CreateFileW(file.data(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE, nullptr, OPEN_EXISTING,
+                       FILE_ATTRIBUTE_NORMAL | FILE_FLAG_OVERLAPPED, nullptr);
+  if (h == INVALID_HANDLE_VALUE) {
+    ec = bela::make_system_error_code(L"CreateFileW() ");
+    return false;
+  }
+  auto tpio = CreateThreadpoolIo(h, async_internal::OnIoComplete, nullptr, nullptr);
+  if (tpio == nullptr) {
+    ec = bela::make_system_error_code(L"CreateThreadpoolIo() ");
+    CloseHandle(h);
+    return false;
+  }
+  fd = h;
+  io = tpio;
+  pool = &pool_;
+  skipOnSuccess = SetFileCompletionNotificationModes(
+                      fd, FILE_SKIP_COMPLETION_PORT_ON_SUCCESS | FILE_SKIP_SET_EVENT_ON_HANDLE) == TRUE;
+  return true;
+}
+
+bool AsyncFile::read_awaiter::await_suspend(std::coroutine_handle<> h) {
+  continuation = h;
+  Offset = static_cast<DWORD>(pos);
+  OffsetHigh = static_cast<DWORD>(static_cast<uint64_t>(pos) >> 32);
+  // copies: once the read is queued, the completion may resume the coroutine and destroy this awaiter
+  auto fd = file->fd;
+  auto io = file->io;
+  auto skipOnSuccess = file->skipOnSuccess;
+  StartThreadpoolIo(io);
+  if (::ReadFile(fd, buffer.data(), static_cast<DWORD>((std::min)(buffer.size(), static_cast<size_t>(readmax))),
+                 nullptr, this) == TRUE) {
+    if (!skipOnSuccess) {
+      return true;
+    }
+    CancelThreadpoolIo(io);
+    result = NO_ERROR;
+    bytes = static_cast<DWORD>(InternalHigh);
+    return false;
+  }
+  auto e = GetLastError();
+  if (e == ERROR_IO_PENDING) {
+    return true;
+  }
+  // failed without queueing a completion
+  CancelThreadpoolIo(io);
+  result = e;
+  bytes = 0;
+  return false;
+}
+
+bool AsyncFile::read_awaiter::await_resume() {
+  if (result != NO_ERROR && result != ERROR_HANDLE_EOF) {
+    ec = bela::make_error_code_from_system(result, L"ReadFile() ");
+    return false;
+  }
+  outlen = static_cast<int64_t>(bytes);
+  return true;
+}
+} // namespace io
+
+namespace async_internal {
+void sleep_awaiter::await_suspend(std::coroutine_handle<> h) {
+  continuation = h;
+  auto timer = CreateThreadpoolTimer(OnTimer, this, nullptr);
+  if (timer == nullptr) {
+    // the only failure is running out of memory
+    throw std::bad_alloc();
+  }
+  ULARGE_INTEGER due;
+  // negative due times are relative
+  due.QuadPart = static_cast<ULONGLONG>(-ticks);
+  FILETIME ft{due.LowPart, due.HighPart};
+  SetThreadpoolTimer(timer, &ft, 0, 0);
+}
+
+void CALLBACK sleep_awaiter::OnTimer(PTP_CALLBACK_INSTANCE, PVOID context, PTP_TIMER timer) {
+  // the timer is released after this callback returns
+  CloseThreadpoolTimer(timer);
+  static_cast<sleep_awaiter *>(context)->Resume();
+}
+
+bool exit_awaiter::await_suspend(std::coroutine_handle<> h) {
+  continuation = h;
+  auto wait = CreateThreadpoolWait(OnExit, this, nullptr);
+  if (wait == nullptr) {
+    result = GetLastError();
+    return false;
+  }
+  SetThreadpoolWait(wait, process, nullptr);
+  return true;
+}
+
+void CALLBACK exit_awaiter::OnExit(PTP_CALLBACK_INSTANCE, PVOID context, PTP_WAIT wait, TP_WAIT_RESULT) {
+  CloseThreadpoolWait(wait);
+  static_cast<exit_awaiter *>(context)->Resume();
+}
+
+bool exit_awaiter::await_resume() {
+  if (result != NO_ERROR) {
+    ec = bela::make_error_code_from_system(result, L"CreateThreadpoolWait() ");
+    return false;
+  }
+  if (GetExitCodeProcess(process, &exitCode) != TRUE) {
+    ec = bela::make_system_error_code(L"GetExitCodeProcess() ");
+    return false;
+  }
+  return true;
+}
+} // namespace async_internal
+} // namespace bela
@@ -0,0 +1,220 @@
+//
+#include <atomic>
+#include <mutex>
+#include <semaphore>
+#include <thread>
+#include <bela/batch_reader.hpp>
+
+namespace bela::io {
+struct BatchReader::Slot {
+  OVERLAPPED ov;
+  HANDLE fd{INVALID_HANDLE_VALUE};
+  uint8_t *buffer{nullptr};
+  size_t index{0};
+  int64_t size{bela::SizeUnInitialized};
+  bela::error_code ec;
+};
+
+BatchReader::BatchReader(size_t bufferSize_, size_t depth_, size_t concurrency_)
+    : bufferSize((std::max)(bufferSize_, static_cast<size_t>(1))), depth((std::max)(depth_, static_cast<size_t>(1))) {
+  concurrency = concurrency_ != 0 ? concurrency_ : (std::max)(std::thread::hardware_concurrency() / 2, 1U);
+  concurrency = (std::min)(concurrency, depth);
+  arena.resize(bufferSize * depth);
+  slots.resize(depth);
+  for (size_t i = 0; i < depth; i++) {
+    slots[i].buffer = arena.data() + i * bufferSize;
+  }
+}
+
+BatchReader::~BatchReader() = default;
+
+class slot_pool {
+public:
+  static constexpr size_t npos = static_cast<size_t>(-1);
+  slot_pool(std::ptrdiff_t n) : available(n) {}
+  void release(size_t i) {
+    {
+      std::scoped_lock lock(mu);
+      free.push_back(i);
+    }
+    available.release();
+  }
+  size_t acquire() {
+    available.acquire();
+    std::scoped_lock lock(mu);
+    if (free.empty()) {
+      return npos; // woken up by cancellation
+    }
+    auto i = free.back();
+    free.pop_back();
+    return i;
+  }
+  void wakeup(size_t n) { available.release(static_cast<std::ptrdiff_t>(n)); }
+  std::vector<size_t> free;
+
+private:
+  std::counting_semaphore<> available;
+  std::mutex mu;
+};
+
+bool BatchReader::Read(std::span<const std::wstring> files, const batch_callback_t &fn, bela::error_code &ec,
+                       int64_t offset) {
+  if (files.empty()) {
+    return true;
+  }
+  auto iocp = CreateIoCompletionPort(INVALID_HANDLE_VALUE, nullptr, 0, 0);
+  if (iocp == nullptr) {
+    ec = bela::make_system_error_code(L"CreateIoCompletionPort() ");
+    return false;
+  }
+  auto closer = bela::finally([&] { CloseHandle(iocp); });
+  slot_pool pool(static_cast<std::ptrdiff_t>(depth));
+  pool.free.reserve(depth);
+  for (size_t i = depth; i > 0; i--) {
+    pool.free.push_back(i - 1);
+  }
+  // completion without any I/O in flight (open or read submission failed)
+  auto post = [&](Slot &slot, DWORD e, const wchar_t *prefix) {
+    slot.ec = bela::make_error_code_from_system(e, prefix);
+    PostQueuedCompletionStatus(iocp, 0, 0, &slot.ov);
+  };
+  std::atomic_size_t next{0};
+  std::atomic_bool canceled{false};
+  auto submitter = [&] {
+    for (;;) {
+      auto pos = pool.acquire();
+      if (pos == slot_pool::npos) {
+        return;
+      }
+      if (canceled.load()) {
+        pool.release(pos);
+        return;
+      }
+      auto index = next.fetch_add(1, std::memory_order_relaxed);
+      if (index >= files.size()) {
+        pool.release(pos);
+        return;
+      }
+      auto &slot = slots[pos];
+      slot.index = index;
+      slot.size = bela::SizeUnInitialized;
+      slot.ec.clear();
+      memset(&slot.ov, 0, sizeof(slot.ov));
+      slot.ov.Offset = static_cast<DWORD>(offset);
+      slot.ov.OffsetHigh = static_cast<DWORD>(static_cast<uint64_t>(offset) >> 32);
+      slot.fd = CreateFileW(files[index].data(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE, nullptr,
+                            OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_OVERLAPPED, nullptr);
+      if (slot.fd == INVALID_HANDLE_VALUE) {
+        post(slot, GetLastError(), L"CreateFileW() ");
+        continue;
+      }
+      FILE_STANDARD_INFO si;
+      if (GetFileInformationByHandleEx(slot.fd, FileStandardInfo, &si, sizeof(si)) == TRUE) {
+        slot.size = si.EndOfFile.QuadPart;
+      }
+      if (slot.size != bela::SizeUnInitialized && slot.size <= offset) {
+        // nothing to read, complete with zero bytes
+        PostQueuedCompletionStatus(iocp, 0, 0, &slot.ov);
+        continue;
+      }
+      if (CreateIoCompletionPort(slot.fd, iocp, 0, 0) == nullptr) {
+        post(slot, GetLastError(), L"CreateIoCompletionPort() ");
+        continue;
+      }
+      if (::ReadFile(slot.fd, slot.buffer, static_cast<DWORD>(bufferSize), nullptr, &slot.ov) != TRUE) {
+        if (auto e = GetLastError(); e != ERROR_IO_PENDING) {
+          post(slot, e, L"ReadFile() ");
+        }
+      }
+    }
+  };
+  std::vector<std::jthread> submitters;
+  submitters.reserve(concurrency);
+  for (size_t i = 0; i < concurrency; i++) {
+    submitters.emplace_back(submitter);
+  }
+  // finish closes the file of a completed slot and hands the slot back to the submitters
+  auto finish = [&](Slot &slot) {
+    if (slot.fd != INVALID_HANDLE_VALUE) {
+      CloseHandle(slot.fd);
+      slot.fd = INVALID_HANDLE_VALUE;
+    }
+    pool.release(static_cast<size_t>(&slot - slots.data()));
+  };
+  OVERLAPPED_ENTRY entries[64];
+  ULONG n = 0;
+  ULONG i = 0;
+  size_t completed = 0;
+  try {
+    while (completed < files.size()) {
+      n = 0;
+      if (GetQueuedCompletionStatusEx(iocp, entries, static_cast<ULONG>(std::size(entries)), &n, INFINITE, FALSE) !=
+          TRUE) {
+        // cannot drain the port: stop the submitters, then cancel whatever is still in flight
+        ec = bela::make_system_error_code(L"GetQueuedCompletionStatusEx() ");
+        canceled.store(true);
+        pool.wakeup(concurrency);
+        submitters.clear();
+        for (auto &slot : slots) {
+          if (slot.fd != INVALID_HANDLE_VALUE) {
+            CancelIoEx(slot.fd, nullptr);
+            CloseHandle(slot.fd);
+            slot.fd = INVALID_HANDLE_VALUE;
+          }
+        }
+        return false;
+      }
+      for (i = 0; i < n; i++) {
+        auto &slot = *CONTAINING_RECORD(entries[i].lpOverlapped, Slot, ov);
+        DWORD bytes = entries[i].dwNumberOfBytesTransferred;
+        if (!slot.ec && slot.fd != INVALID_HANDLE_VALUE && bytes == 0 &&
+            GetOverlappedResult(slot.fd, &slot.ov, &bytes, FALSE) != TRUE) {
+          if (auto e = GetLastError(); e != ERROR_HANDLE_EOF) {
+            slot.ec = bela::make_error_code_from_system(e, L"ReadFile() ");
+          }
+        }
+        fn(BatchCompletion{.index = slot.index,
+                           .size = slot.size,
+                           .data = bela::bytes_view(slot.buffer, slot.ec ? 0 : static_cast<size_t>(bytes)),
+                           .ec = slot.ec});
+        finish(slot);
+        completed++;
+      }
+    }
+  } catch (...) {
+    // fn threw: stop the submitters first, joining them needs a wakeup since they may wait for a free slot
+    canceled.store(true);
+    pool.wakeup(concurrency);
+    submitters.clear();
+    // the completions already dequeued, starting with the one whose callback threw
+    for (; i < n; i++) {
+      finish(*CONTAINING_RECORD(entries[i].lpOverlapped, Slot, ov));
+    }
+    // cancelled reads still complete into their slot buffers, wait until every slot is back before unwinding
+    for (auto &slot : slots) {
+      if (slot.fd != INVALID_HANDLE_VALUE) {
+        CancelIoEx(slot.fd, nullptr);
+      }
+    }
+    while (pool.free.size() < depth) {
+      n = 0;
+      if (GetQueuedCompletionStatusEx(iocp, entries, static_cast<ULONG>(std::size(entries)), &n, INFINITE, FALSE) !=
+          TRUE) {
+        break;
+      }
+      for (i = 0; i < n; i++) {
+        finish(*CONTAINING_RECORD(entries[i].lpOverlapped, Slot, ov));
+      }
+    }
+    for (auto &slot : slots) {
+      if (slot.fd != INVALID_HANDLE_VALUE) {
+        CloseHandle(slot.fd);
+        slot.fd = INVALID_HANDLE_VALUE;
+      }
+    }
+    throw;
+  }
+  return true;
+}
+
+} // namespace bela::io
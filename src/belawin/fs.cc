@@ -1,6 +1,7 @@
 //
 #include <bela/fs.hpp>
 #include <bela/terminal.hpp>
+#include <winternl.h>
 namespace bela::fs {
 inline bool remove_file_hide_attribute(HANDLE FileHandle) {
   FILE_BASIC_INFO bi;
@@ -63,10 +64,10 @@ bool ForceDeleteFile(std::wstring_view path, bela::error_code &ec) {
   auto FileHandle = CreateFileW(path.data(), openflags, shm, nullptr, OPEN_EXISTING, flags, nullptr);
   if (FileHandle == INVALID_HANDLE_VALUE) {
     auto e = GetLastError();
-    if (ec.code == ERROR_FILE_NOT_FOUND) {
+    if (e == ERROR_FILE_NOT_FOUND) {
       return true;
     }
-    if (ec.code != ERROR_ACCESS_DENIED) {
+    if (e != ERROR_ACCESS_DENIED) {
       ec = bela::make_error_code_from_system(e);
       return false;
     }
@@ -80,27 +81,191 @@ bool ForceDeleteFile(std::wstring_view path, bela::error_code &ec) {
   return ForceDeleteFile(FileHandle, ec);
 }
 
-bool force_delete_folders(std::wstring_view path, bela::error_code &ec) {
-  Finder finder;
-  if (!finder.First(path, L"*", ec)) {
-    return false;
+namespace {
+// ntdll is always loaded, its functions are resolved once: NtCreateFile opens a name relative to a directory handle
+struct ntdll_functions {
+  decltype(&::NtCreateFile) createFile{nullptr};
+  decltype(&::RtlNtStatusToDosError) toDosError{nullptr};
+};
+
+const ntdll_functions &Ntdll() {
+  static const ntdll_functions fns = [] {
+    ntdll_functions f;
+    if (auto ntdll = ::GetModuleHandleW(L"ntdll.dll"); ntdll != nullptr) {
+      f.createFile = reinterpret_cast<decltype(&::NtCreateFile)>(GetProcAddress(ntdll, "NtCreateFile"));
+      f.toDosError =
+          reinterpret_cast<decltype(&::RtlNtStatusToDosError)>(GetProcAddress(ntdll, "RtlNtStatusToDosError"));
+    }
+    return f;
+  }();
+  return fns;
+}
+
+// open_relative opens name in the directory parent, it returns a Win32 error code
+DWORD open_relative(HANDLE parent, std::wstring_view name, ACCESS_MASK access, ULONG options, HANDLE &FileHandle) {
+  const auto &nt = Ntdll();
+  if (nt.createFile == nullptr || nt.toDosError == nullptr) {
+    return ERROR_PROC_NOT_FOUND;
   }
-  do {
-    if (finder.Ignore()) {
-      continue;
+  UNICODE_STRING us{
+      .Length = static_cast<USHORT>(name.size() * sizeof(wchar_t)),
+      .MaximumLength = static_cast<USHORT>(name.size() * sizeof(wchar_t)),
+      .Buffer = const_cast<PWSTR>(name.data()),
+  };
+  OBJECT_ATTRIBUTES oa;
+  InitializeObjectAttributes(&oa, &us, 0, parent, nullptr);
+  IO_STATUS_BLOCK iosb{};
+  constexpr auto shm = FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE;
+  constexpr auto flags = FILE_SYNCHRONOUS_IO_NONALERT | FILE_OPEN_REPARSE_POINT | FILE_OPEN_FOR_BACKUP_INTENT;
+  auto status = nt.createFile(&FileHandle, access | SYNCHRONIZE, &oa, &iosb, nullptr, 0, shm, FILE_OPEN,
+                              options | flags, nullptr, 0);
+  return status >= 0 ? ERROR_SUCCESS : nt.toDosError(status);
+}
+
+// enumerate_directory calls fn(name, info) for every entry from the first one on, reading entries a 64K buffer at a
+// time: one call returns hundreds of them with their attributes and sizes
+template <typename Fn> bool enumerate_directory(HANDLE dir, Fn &&fn, bela::error_code &ec) {
+  constexpr size_t bufferSize = 64 * 1024;
+  auto buffer = std::make_unique<uint64_t[]>(bufferSize / sizeof(uint64_t));
+  auto infoClass = FileFullDirectoryRestartInfo;
+  for (;;) {
+    if (GetFileInformationByHandleEx(dir, infoClass, buffer.get(), bufferSize) != TRUE) {
+      auto e = GetLastError();
+      if (e == ERROR_NO_MORE_FILES || e == ERROR_FILE_NOT_FOUND) {
+        return true;
+      }
+      ec = bela::make_error_code_from_system(e, L"GetFileInformationByHandleEx ");
+      return false;
     }
-    auto child = bela::StringCat(path, L"\\", finder.Name());
-    if (finder.IsDir() && !finder.IsReparsePoint()) { // only normal dir remove it. symlink not
-      if (!force_delete_folders(child, ec)) {
+    infoClass = FileFullDirectoryInfo;
+    auto p = reinterpret_cast<const uint8_t *>(buffer.get());
+    for (;;) {
+      auto info = reinterpret_cast<const FILE_FULL_DIR_INFO *>(p);
+      std::wstring_view name(info->FileName, info->FileNameLength / sizeof(wchar_t));
+      if (name != L"." && name != L".." && !fn(name, info)) {
+        return true;
+      }
+      if (info->NextEntryOffset == 0) {
+        break;
+      }
+      p += info->NextEntryOffset;
+    }
+  }
+}
+
+// only normal dir is walked, junctions and symlinks are links
+inline EntryType entry_type(const FILE_FULL_DIR_INFO *info) {
+  if ((info->FileAttributes & FILE_ATTRIBUTE_REPARSE_POINT) != 0) {
+    return EntryType::Symlink;
+  }
+  if ((info->FileAttributes & FILE_ATTRIBUTE_DIRECTORY) != 0) {
+    return EntryType::Directory;
+  }
+  return (info->FileAttributes & FILE_ATTRIBUTE_DEVICE) != 0 ? EntryType::Other : EntryType::File;
+}
+
+struct remove_backend {
+  using handle_type = HANDLE;
+  using string_type = std::wstring;
+  using error_type = bela::error_code;
+  static constexpr HANDLE invalid = nullptr;
+  static constexpr HANDLE root = nullptr;
+  bool OpenDir(HANDLE parent, const std::wstring &name, HANDLE &dir, bela::error_code &ec) {
+    constexpr auto access = DELETE | FILE_LIST_DIRECTORY | FILE_READ_ATTRIBUTES | FILE_WRITE_ATTRIBUTES;
+    if (parent == nullptr) {
+      constexpr auto shm = FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE;
+      constexpr auto flags = FILE_FLAG_BACKUP_SEMANTICS | FILE_FLAG_OPEN_REPARSE_POINT;
+      auto FileHandle = CreateFileW(name.data(), access | SYNCHRONIZE, shm, nullptr, OPEN_EXISTING, flags, nullptr);
+      if (FileHandle == INVALID_HANDLE_VALUE) {
+        ec = bela::make_system_error_code(L"CreateFileW ");
         return false;
       }
-      continue;
+      dir = FileHandle;
+      return true;
     }
-    if (!bela::fs::ForceDeleteFile(child, ec)) {
+    auto e = open_relative(parent, name, access, FILE_DIRECTORY_FILE, dir);
+    if (e == ERROR_ACCESS_DENIED) {
+      e = open_relative(parent, name, DELETE | FILE_LIST_DIRECTORY, FILE_DIRECTORY_FILE, dir);
+    }
+    if (e != ERROR_SUCCESS) {
+      ec = bela::make_error_code_from_system(e, L"NtCreateFile ");
       return false;
     }
-  } while (finder.Next());
-  return bela::fs::ForceDeleteFile(path, ec);
+    return true;
+  }
+  template <typename Fn> bool Enumerate(HANDLE dir, Fn &&fn, bela::error_code &ec) {
+    return enumerate_directory(
+        dir,
+        [&](std::wstring_view name, const FILE_FULL_DIR_INFO *info) {
+          return fn(name, entry_type(info) == EntryType::Directory);
+        },
+        ec);
+  }
+  bool RemoveFile(HANDLE dir, const std::wstring &name, bela::error_code &ec) {
+    HANDLE FileHandle = nullptr;
+    auto e = open_relative(dir, name, DELETE | FILE_READ_ATTRIBUTES | FILE_WRITE_ATTRIBUTES, 0, FileHandle);
+    if (e == ERROR_ACCESS_DENIED) {
+      e = open_relative(dir, name, DELETE, 0, FileHandle);
+    }
+    if (e == ERROR_FILE_NOT_FOUND) {
+      return true;
+    }
+    if (e != ERROR_SUCCESS) {
+      ec = bela::make_error_code_from_system(e, L"NtCreateFile ");
+      return false;
+    }
+    auto closer = bela::finally([&] { CloseHandle(FileHandle); });
+    return ForceDeleteFile(FileHandle, ec);
+  }
+  // the directory is deleted when its handle is closed, right after
+  bool RemoveDir(HANDLE /*parent*/, const std::wstring & /*name*/, HANDLE dir, bela::error_code &ec) {
+    return ForceDeleteFile(dir, ec);
+  }
+  bool NotEmpty(const bela::error_code &ec) { return ec.code == ERROR_DIR_NOT_EMPTY; }
+  void Close(HANDLE dir) { CloseHandle(dir); }
+};
+
+struct walk_backend {
+  using char_type = wchar_t;
+  using handle_type = HANDLE;
+  using error_type = bela::error_code;
+  bool OpenDir(const std::wstring &path, bool root, HANDLE &dir, bela::error_code &ec) {
+    constexpr auto shm = FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE;
+    // subdirectories are walked only when they are no reparse points, one swapped in meanwhile is not followed
+    auto flags = FILE_FLAG_BACKUP_SEMANTICS | (root ? 0 : FILE_FLAG_OPEN_REPARSE_POINT);
+    auto FileHandle = CreateFileW(path.data(), FILE_LIST_DIRECTORY | SYNCHRONIZE, shm, nullptr, OPEN_EXISTING,
+                                  static_cast<DWORD>(flags), nullptr);
+    if (FileHandle == INVALID_HANDLE_VALUE) {
+      ec = bela::make_system_error_code(L"CreateFileW ");
+      return false;
+    }
+    dir = FileHandle;
+    return true;
+  }
+  template <typename Fn> bool Enumerate(HANDLE dir, bool /*sizes*/, Fn &&fn, bela::error_code &ec) {
+    return enumerate_directory(
+        dir,
+        [&](std::wstring_view name, const FILE_FULL_DIR_INFO *info) {
+          auto type = entry_type(info);
+          return fn(name, type, type == EntryType::Directory ? -1 : info->EndOfFile.QuadPart);
+        },
+        ec);
+  }
+  void Close(HANDLE dir) { CloseHandle(dir); }
+};
+} // namespace
+
+bool ForceDeleteFolders(std::wstring_view path, const RemoveOptions &opts, RemoveStats &stats, bela::error_code &ec) {
+  remove_backend backend;
+  fs_internal::remover<remove_backend> r(backend, opts);
+  return r.Remove(std::wstring(path), stats, ec);
+}
+
+bool Walker::Walk(std::wstring_view root, const std::function<void(const WalkEntry &)> &fn, bela::error_code &ec) {
+  stats = WalkStats{};
+  walk_backend backend;
+  fs_internal::walker<walk_backend> w(backend, opts, fn);
+  return w.Walk(root, stats, ec);
 }
 
 bool ForceDeleteFolders(std::wstring_view path, bela::error_code &ec) {
@@ -108,7 +273,8 @@ bool ForceDeleteFolders(std::wstring_view path, bela::error_code &ec) {
     return true;
   }
   if (ec.code == ERROR_DIR_NOT_EMPTY) {
-    return force_delete_folders(path, ec);
+    RemoveStats stats;
+    return ForceDeleteFolders(path, RemoveOptions{}, stats, ec);
   }
   return false;
 }
@@ -83,6 +83,60 @@ std::optional<FD> NewFile(std::wstring_view file, DWORD dwDesiredAccess, DWORD d
   return std::make_optional<FD>(fd, true);
 }
 
+void MappedFile::Free() {
+  if (data != nullptr) {
+    UnmapViewOfFile(data);
+  }
+  data = nullptr;
+  size = 0;
+}
+
+void MappedFile::MoveFrom(MappedFile &&o) {
+  if (this == &o) {
+    return;
+  }
+  Free();
+  data = o.data;
+  size = o.size;
+  o.data = nullptr;
+  o.size = 0;
+}
+
+bool MappedFile::Open(std::wstring_view file, bela::error_code &ec) {
+  Free();
+  auto fd = bela::io::NewFile(file, ec);
+  if (!fd) {
+    return false;
+  }
+  auto fileSize = fd->Size(ec);
+  if (fileSize == bela::SizeUnInitialized) {
+    return false;
+  }
+  if (fileSize == 0) {
+    // empty files cannot be mapped
+    return true;
+  }
+  if (static_cast<uint64_t>(fileSize) > (std::numeric_limits<size_t>::max)()) {
+    ec = bela::make_error_code(L"file too large to map");
+    return false;
+  }
+  // the view keeps the section alive, both handles can be closed once it exists
+  auto section = CreateFileMappingW(fd->NativeFD(), nullptr, PAGE_READONLY, 0, 0, nullptr);
+  if (section == nullptr) {
+    ec = bela::make_system_error_code(L"CreateFileMappingW() ");
+    return false;
+  }
+  auto view = MapViewOfFile(section, FILE_MAP_READ, 0, 0, 0);
+  CloseHandle(section);
+  if (view == nullptr) {
+    ec = bela::make_system_error_code(L"MapViewOfFile() ");
+    return false;
+  }
+  data = static_cast<const uint8_t *>(view);
+  size = static_cast<size_t>(fileSize);
+  return true;
+}
+
 inline void bytes_switch(std::wstring &out, std::wstring_view text) {
   out.resize(text.size());
   auto dest = reinterpret_cast<std::uint16_t *>(out.data());
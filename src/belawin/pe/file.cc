@@ -1,5 +1,6 @@
 //
 #include <bela/io.hpp>
+#include <bela/trace.hpp>
 #include "internal.hpp"
 #include <algorithm>
 
@@ -109,6 +110,8 @@ inline void fromle(SectionHeader32 &sh) {
 }
 
 bool File::parseFile(bela::error_code &ec) {
+  BELA_TRACE_SCOPE("pe.File.parseFile");
+  BELA_TRACE_COUNT("pe.files", 1);
   if (size == SizeUnInitialized) {
     if ((size = fd.Size(ec)) == bela::SizeUnInitialized) {
       return false;
@@ -1,6 +1,7 @@
 ///
 #include <hazel/hazel.hpp>
 #include <hazel/elf.hpp>
+#include <bela/trace.hpp>
 
 namespace hazel::elf {
 // ELF parse code
@@ -20,6 +21,8 @@ bool File::NewFile(HANDLE fd_, int64_t sz, bela::error_code &ec) {
 }
 
 bool File::parseFile(bela::error_code &ec) {
+  BELA_TRACE_SCOPE("elf.File.parseFile");
+  BELA_TRACE_COUNT("elf.files", 1);
   if (size == bela::SizeUnInitialized) {
     if ((size = fd.Size(ec)) == bela::SizeUnInitialized) {
       return false;
@@ -3,11 +3,14 @@
 #include <hazel/hazel.hpp>
 #include <bela/path.hpp>
 #include <bela/os.hpp>
+#include <bela/trace.hpp>
 #include "ina/hazelinc.hpp"
 
 namespace hazel {
 
 using lookup_handle_t = hazel::internal::status_t (*)(const bela::bytes_view &, hazel_result &);
+// the detectors look at most at the first lookupBytes bytes of a file
+constexpr size_t lookupBytes = 4096;
 
 bool LookupBytes(const bela::bytes_view &bv, hazel_result &hr, bela::error_code & /*unused*/) {
   if (auto p = memchr(bv.data(), 0, bv.size()); p != nullptr) {
@@ -33,6 +36,7 @@ bool LookupBytes(const bela::bytes_view &bv, hazel_result &hr, bela::error_code
 }
 
 bool LookupFile(const bela::io::FD &fd, hazel_result &hr, bela::error_code &ec, int64_t offset) {
+  BELA_TRACE_SCOPE("hazel.LookupFile");
   if ((hr.size_ = fd.Size(ec)) == bela::SizeUnInitialized) {
     return false;
   }
@@ -40,13 +44,33 @@ bool LookupFile(const bela::io::FD &fd, hazel_result &hr, bela::error_code &ec,
     ec = bela::make_error_code(ErrGeneral, L"file offset over size");
     return false;
   }
-  uint8_t buffer[4096];
-  auto minSize = (std::min)(hr.size_ - offset, 4096LL);
+  uint8_t buffer[lookupBytes];
+  auto minSize = (std::min)(hr.size_ - offset, static_cast<int64_t>(lookupBytes));
   if (!fd.ReadAt({buffer, static_cast<size_t>(minSize)}, offset, ec)) {
     return false;
   }
+  BELA_TRACE_HISTOGRAM("hazel.file_size", hr.size_);
   bela::bytes_view bv(buffer, static_cast<size_t>(minSize));
   return LookupBytes(bv, hr, ec);
 }
 
+bool LookupFiles(std::span<const std::wstring> files, const lookup_files_callback_t &fn, bela::error_code &ec,
+                 int64_t offset) {
+  bela::io::BatchReader reader(lookupBytes);
+  return reader.Read(
+      files,
+      [&](const bela::io::BatchCompletion &c) {
+        hazel_result hr;
+        hr.size_ = c.size;
+        if (c.ec) {
+          fn(c.index, hr, c.ec);
+          return;
+        }
+        bela::error_code lec;
+        LookupBytes(c.data, hr, lec);
+        fn(c.index, hr, lec);
+      },
+      ec, offset);
+}
+
 } // namespace hazel
\ No newline at end of file
@@ -1,9 +1,12 @@
 ///
 #include "zipinternal.hpp"
 #include <bela/endian.hpp>
+#include <bela/trace.hpp>
 
 namespace hazel::zip {
 bool Reader::Decompress(const File &file, const Writer &w, bela::error_code &ec) const {
+  BELA_TRACE_SCOPE("zip.Reader.Decompress");
+  BELA_TRACE_HISTOGRAM("zip.compressed_size", file.compressed_size);
   auto realPosition = file.position + baseOffset;
   uint8_t buf[fileHeaderLen];
   if (!fd.ReadAt(buf, realPosition, ec)) {
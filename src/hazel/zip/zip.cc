@@ -4,6 +4,7 @@
 #include <bela/bufio.hpp>
 #include <bitset>
 #include <bela/terminal.hpp>
+#include <bela/trace.hpp>
 #include "zipinternal.hpp"
 
 namespace hazel::zip {
@@ -357,6 +358,7 @@ bool readDirectoryHeader(bufioReader &br, bela::Buffer &buffer, File &file, bela
 }
 
 bool Reader::Initialize(bela::error_code &ec) {
+  BELA_TRACE_SCOPE("zip.Reader.Initialize");
   if (size == bela::SizeUnInitialized) {
     if ((size = fd.Size(ec)) == bela::SizeUnInitialized) {
       return false;
@@ -379,7 +381,7 @@ bool Reader::Initialize(bela::error_code &ec) {
   bela::Buffer buffer(16 * 1024);
   bufioReader br(fd.NativeFD());
   for (uint64_t i = 0; i < d.directoryRecords; i++) {
-    File file;
+    File file(resource);
     if (!readDirectoryHeader(br, buffer, file, ec)) {
       return false;
     }
@@ -387,6 +389,7 @@ bool Reader::Initialize(bela::error_code &ec) {
     compressed_size += file.compressed_size;
     files.emplace_back(std::move(file));
   }
+  BELA_TRACE_COUNT("zip.files", files.size());
   return true;
 }
 
@@ -0,0 +1,92 @@
+#include <bela/alloc_stats.hpp>
+#include <bela/terminal.hpp>
+#include <string>
+#include <thread>
+#include <vector>
+
+constinit bela::alloc_stats::Tag namesTag{"names"};
+constinit bela::alloc_stats::Tag symbolsTag{"symbols"};
+constinit bela::alloc_stats::Tag tasksTag{"tasks"};
+
+struct Symbol {
+  uint64_t address;
+  uint32_t size;
+};
+
+bela::alloc_stats::Stats find(const std::vector<bela::alloc_stats::Stats> &stats, std::string_view name) {
+  for (const auto &s : stats) {
+    if (s.name == name) {
+      return s;
+    }
+  }
+  return bela::alloc_stats::Stats{};
+}
+
+int wmain() {
+  bela::alloc_stats::CountingResource resource(namesTag);
+  {
+    std::pmr::vector<std::pmr::string> names(&resource);
+    names.reserve(100);
+    for (int i = 0; i < 100; i++) {
+      names.emplace_back(std::string(100, 'a' + i % 26));
+    }
+    auto s = find(bela::alloc_stats::ThreadReport(), "names");
+    // the table and one heap buffer per name
+    if (s.allocations != 101 || s.live != s.peak || s.bytes < 100 * 100) {
+      bela::FPrintF(stderr, L"names: %d allocations, live %d peak %d\n", s.allocations, s.live, s.peak);
+      return 1;
+    }
+  }
+  auto s = find(bela::alloc_stats::Collect(), "names");
+  if (s.live != 0 || s.deallocations != s.allocations) {
+    bela::FPrintF(stderr, L"names leaked\n");
+    return 1;
+  }
+
+  // allocated on four threads, freed on the main thread: per thread live bytes go negative, the process total is exact
+  std::vector<std::vector<Symbol, bela::alloc_stats::CountingAllocator<Symbol>>> tables;
+  for (int i = 0; i < 4; i++) {
+    tables.emplace_back(symbolsTag);
+  }
+  std::vector<std::thread> workers;
+  for (auto &t : tables) {
+    workers.emplace_back([&t] {
+      for (uint32_t i = 0; i < 10000; i++) {
+        t.push_back(Symbol{i, i});
+      }
+    });
+  }
+  for (auto &w : workers) {
+    w.join();
+  }
+  auto total = find(bela::alloc_stats::Collect(), "symbols");
+  if (total.live < static_cast<int64_t>(4 * 10000 * sizeof(Symbol))) {
+    bela::FPrintF(stderr, L"symbols: live %d\n", total.live);
+    return 1;
+  }
+  tables.clear();
+  total = find(bela::alloc_stats::Collect(), "symbols");
+  auto mine = find(bela::alloc_stats::ThreadReport(), "symbols");
+  if (total.live != 0 || mine.live >= 0) {
+    bela::FPrintF(stderr, L"symbols: live %d after free, %d on this thread\n", total.live, mine.live);
+    return 1;
+  }
+  // one thread per task: the counts of exited threads are retired, Collect still includes them
+  for (int i = 0; i < 200; i++) {
+    std::thread([] {
+      std::vector<Symbol, bela::alloc_stats::CountingAllocator<Symbol>> task(tasksTag);
+      task.resize(10);
+    }).join();
+  }
+  if (auto tasks = find(bela::alloc_stats::Collect(), "tasks"); tasks.allocations != 200 || tasks.deallocations != 200 ||
+                                                                 tasks.bytes != 200 * 10 * sizeof(Symbol)) {
+    bela::FPrintF(stderr, L"tasks: %d allocations, %d deallocations, %d bytes\n", tasks.allocations,
+                  tasks.deallocations, tasks.bytes);
+    return 1;
+  }
+  for (const auto &st : bela::alloc_stats::Collect()) {
+    bela::FPrintF(stderr, L"%s: %d allocations, %d bytes, peak %d bytes\n", st.name, st.allocations, st.bytes,
+                  st.peak);
+  }
+  return 0;
+}
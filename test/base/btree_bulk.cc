@@ -0,0 +1,109 @@
+#include <bela/btree.hpp>
+#include <bela/terminal.hpp>
+#include <bela/time.hpp>
+#include <algorithm>
+#include <random>
+#include <string>
+#include <vector>
+
+// every size around node boundaries: bulk loading must match incremental inserts and stay a valid btree under updates
+int shapes() {
+  for (int n = 0; n < 3000; n++) {
+    std::vector<std::pair<int, std::string>> values;
+    bela::btree_map<int, std::string> expected;
+    for (int i = 0; i < n; i++) {
+      values.emplace_back(i * 2, std::to_string(i));
+      expected.emplace(i * 2, std::to_string(i));
+    }
+    auto m = bela::btree_map<int, std::string>::from_sorted(values);
+    m.verify();
+    if (m != expected) {
+      bela::FPrintF(stderr, L"from_sorted: %d values differ\n", n);
+      return 1;
+    }
+    for (int i = 0; i < n; i += 3) {
+      m.erase(i * 2);
+      m.emplace(i * 2 + 1, "odd");
+    }
+    m.verify();
+  }
+  return 0;
+}
+
+int duplicates() {
+  std::vector<int> sorted{1, 1, 2, 3, 3, 3, 4};
+  auto s = bela::btree_set<int>::from_sorted(sorted);
+  auto ms = bela::btree_multiset<int>::from_sorted(sorted);
+  std::vector<std::pair<int, int>> pairs{{1, 1}, {1, 2}, {2, 3}};
+  auto m = bela::btree_map<int, int>::from_sorted(pairs);
+  if (s.size() != 4 || ms.size() != sorted.size() || m.size() != 2 || m[1] != 1) {
+    bela::FPrintF(stderr, L"duplicates: %d %d %d\n", s.size(), ms.size(), m.size());
+    return 1;
+  }
+  bela::btree_map<int, int> x{{1, 10}, {3, 30}, {5, 50}};
+  bela::btree_map<int, int> y{{2, 20}, {3, 31}, {6, 60}};
+  auto merged = bela::btree_map<int, int>::merge_sorted(x, y);
+  merged.verify();
+  bela::btree_map<int, int> expected{{1, 10}, {2, 20}, {3, 30}, {5, 50}, {6, 60}};
+  if (merged != expected) {
+    bela::FPrintF(stderr, L"merge_sorted: %d values\n", merged.size());
+    return 1;
+  }
+  bela::btree_multimap<int, int> mx{{1, 10}, {3, 30}};
+  bela::btree_multimap<int, int> my{{3, 31}, {4, 40}};
+  auto mm = bela::btree_multimap<int, int>::merge_sorted(std::move(mx), std::move(my));
+  mm.verify();
+  auto [first, last] = mm.equal_range(3);
+  if (mm.size() != 4 || first->second != 30 || std::next(first)->second != 31) {
+    bela::FPrintF(stderr, L"multimap merge_sorted: %d values\n", mm.size());
+    return 1;
+  }
+  return 0;
+}
+
+int wmain() {
+  if (shapes() != 0 || duplicates() != 0) {
+    return 1;
+  }
+  constexpr size_t count = 2000000;
+  std::mt19937_64 rng(7);
+  std::vector<std::pair<uint64_t, uint64_t>> values(count);
+  for (auto &v : values) {
+    v = {rng(), rng()};
+  }
+  std::sort(values.begin(), values.end());
+
+  auto start = bela::MonotonicNow();
+  bela::btree_map<uint64_t, uint64_t> incremental;
+  for (const auto &v : values) {
+    incremental.emplace(v.first, v.second);
+  }
+  auto insertTime = bela::MonotonicNow() - start;
+
+  start = bela::MonotonicNow();
+  auto loaded = bela::btree_map<uint64_t, uint64_t>::from_sorted(values);
+  auto loadTime = bela::MonotonicNow() - start;
+
+  // two halves merged with a linear pass, against inserting the second half into the first
+  std::vector<std::pair<uint64_t, uint64_t>> evens, odds;
+  for (size_t i = 0; i < count; i++) {
+    (i % 2 == 0 ? evens : odds).emplace_back(values[i]);
+  }
+  auto x = bela::btree_map<uint64_t, uint64_t>::from_sorted(evens);
+  auto y = bela::btree_map<uint64_t, uint64_t>::from_sorted(odds);
+  start = bela::MonotonicNow();
+  auto merged = bela::btree_map<uint64_t, uint64_t>::merge_sorted(x, y);
+  auto mergeTime = bela::MonotonicNow() - start;
+  start = bela::MonotonicNow();
+  x.insert(y.begin(), y.end());
+  auto mergeInsertTime = bela::MonotonicNow() - start;
+
+  bela::FPrintF(stderr, L"%d values: insert %s, from_sorted %s; merge: insert %s, merge_sorted %s\n", count,
+                bela::FormatDuration(insertTime), bela::FormatDuration(loadTime),
+                bela::FormatDuration(mergeInsertTime), bela::FormatDuration(mergeTime));
+  if (loaded != incremental || merged != incremental || x != incremental) {
+    bela::FPrintF(stderr, L"bulk loaded maps differ\n");
+    return 1;
+  }
+  return 0;
+}
@@ -0,0 +1,78 @@
+#include <bela/match.hpp>
+#include <bela/simulator.hpp>
+#include <bela/str_cat.hpp>
+#include <bela/terminal.hpp>
+#include <bela/time.hpp>
+
+// the byte-at-a-time FNV-1a hash StringCaseInsensitiveHash used before
+size_t FNV1aIgnoreCase(std::wstring_view wsv) {
+  size_t val = 14695981039346656037ULL;
+  std::string_view sv = {reinterpret_cast<const char *>(wsv.data()), wsv.size() * 2};
+  for (auto c : sv) {
+    val ^= static_cast<size_t>(bela::ascii_tolower(c));
+    val *= 1099511628211ULL;
+  }
+  return val;
+}
+
+int wmain() {
+  constexpr std::wstring_view names[] = {
+      L"Path",
+      L"PATH",
+      L"path",
+      L"SystemRoot",
+      L"SYSTEMROOT",
+      L"C:\\Windows\\System32",
+      L"c:\\windows\\system32",
+      L"ProgramFiles(x86)",
+      L"PROGRAMFILES(X86)",
+      L"Ünïcode-ÄÖ",
+      L"ünïcode-äö",
+      L"",
+  };
+  int errors = 0;
+  for (auto a : names) {
+    for (auto b : names) {
+      if (bela::EqualsIgnoreCase(a, b) && bela::HashIgnoreCase(a) != bela::HashIgnoreCase(b)) {
+        bela::FPrintF(stderr, L"hash mismatch: %s %s\n", a, b);
+        errors++;
+      }
+    }
+    auto narrow = bela::encode_into<wchar_t, char>(a);
+    auto upper = narrow;
+    bela::AsciiStrToUpper(&upper);
+    if (bela::HashIgnoreCase(narrow) != bela::HashIgnoreCase(upper)) {
+      bela::FPrintF(stderr, L"narrow hash mismatch: %s\n", a);
+      errors++;
+    }
+  }
+  std::vector<std::wstring> paths;
+  for (int i = 0; i < 10000; i++) {
+    paths.emplace_back(bela::StringCat(L"C:\\Program Files\\Vendor", i, L"\\Product\\bin"));
+  }
+  size_t sum = 0;
+  auto start = bela::MonotonicNow();
+  for (const auto &p : paths) {
+    sum += bela::HashIgnoreCase(p);
+  }
+  auto folded = bela::MonotonicNow() - start;
+  start = bela::MonotonicNow();
+  for (const auto &p : paths) {
+    sum += FNV1aIgnoreCase(p);
+  }
+  auto fnv = bela::MonotonicNow() - start;
+  bela::env::envmap_t envmap;
+  for (const auto &p : paths) {
+    envmap.emplace(p, p);
+  }
+  for (const auto &p : paths) {
+    auto upper = p;
+    bela::AsciiStrToUpper(&upper);
+    if (!envmap.contains(upper)) {
+      errors++;
+    }
+  }
+  bela::FPrintF(stderr, L"HashIgnoreCase %s FNV-1a %s (%d) %d errors\n", bela::FormatDuration(folded),
+                bela::FormatDuration(fnv), sum & 1, errors);
+  return errors == 0 ? 0 : 1;
+}
@@ -0,0 +1,78 @@
+#include <bela/concurrent_cache.hpp>
+#include <bela/terminal.hpp>
+#include <bela/time.hpp>
+#include <atomic>
+#include <random>
+#include <thread>
+
+// 64 threads miss on the same keys at once: every key must be loaded exactly once
+int single_flight() {
+  bela::ConcurrentCache<uint64_t, std::wstring> cache(100000);
+  constexpr uint64_t keys = 1000;
+  std::vector<std::atomic_int> loads(keys);
+  std::atomic_int errors{0};
+  {
+    std::vector<std::jthread> threads;
+    for (uint64_t t = 0; t < 64; t++) {
+      threads.emplace_back([&, t] {
+        for (uint64_t i = 0; i < keys * 4; i++) {
+          auto key = (i * 7 + t) % keys;
+          auto v = cache.GetOrLoad(key, [&](uint64_t k) {
+            loads[k]++;
+            std::this_thread::sleep_for(std::chrono::microseconds(50));
+            return std::to_wstring(k);
+          });
+          if (v != std::to_wstring(key)) {
+            errors++;
+          }
+        }
+      });
+    }
+  }
+  for (auto &n : loads) {
+    if (n != 1) {
+      errors++;
+    }
+  }
+  auto stats = cache.Stats();
+  bela::FPrintF(stderr, L"single-flight: %d hits %d misses %d loads, %d errors\n", stats.hits, stats.misses,
+                stats.loads, errors.load());
+  return errors == 0 ? 0 : 1;
+}
+
+int wmain() {
+  if (single_flight() != 0) {
+    return 1;
+  }
+  // a hot set that fits in the cache mixed with a scan of cold keys, which CLOCK keeps from flushing the hot set
+  auto concurrency = (std::max)(std::thread::hardware_concurrency(), 1U);
+  for (unsigned n = 1; n <= (std::min)(concurrency, 64U); n *= 2) {
+    bela::ConcurrentCache<uint64_t, uint64_t> cache(4096);
+    constexpr int lookups = 1000000;
+    std::atomic_int errors{0};
+    auto start = bela::MonotonicNow();
+    {
+      std::vector<std::jthread> threads;
+      for (unsigned t = 0; t < n; t++) {
+        threads.emplace_back([&, t] {
+          std::mt19937_64 rng(t);
+          for (int i = 0; i < lookups / static_cast<int>(n); i++) {
+            auto key = (i % 4 == 0) ? rng() % 1000000 : rng() % 1000;
+            if (cache.GetOrLoad(key, [](uint64_t k) { return k * 2; }) != key * 2) {
+              errors++;
+            }
+          }
+        });
+      }
+    }
+    auto elapsed = bela::MonotonicNow() - start;
+    auto stats = cache.Stats();
+    bela::FPrintF(stderr, L"%2d threads: %s, hit ratio %.3f, %d evictions, size %d/%d, %d errors\n", n,
+                  bela::FormatDuration(elapsed), static_cast<double>(stats.hits) / (stats.hits + stats.misses),
+                  stats.evictions, cache.Size(), cache.Capacity(), errors.load());
+    if (errors != 0 || cache.Size() > cache.Capacity()) {
+      return 1;
+    }
+  }
+  return 0;
+}
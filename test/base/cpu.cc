@@ -0,0 +1,83 @@
+#include <bela/cpu.hpp>
+#include <bela/hash.hpp>
+#include <bela/terminal.hpp>
+#include <bela/time.hpp>
+#include <cstring>
+#include <string>
+
+int twice_portable(int v) { return v * 2; }
+int twice_fast(int v) { return v << 1; }
+int twice_impossible(int) { return -1; }
+
+// kernels are tried in order: one that needs a feature no CPU reports in a single mask must never be chosen
+constinit bela::cpu::Dispatcher<int(int)> twice{
+    {bela::cpu::AVX512F | bela::cpu::NEON, twice_impossible, "impossible"},
+    {bela::cpu::SSE2, twice_fast, "sse2"},
+    {bela::cpu::NEON, twice_fast, "neon"},
+    {0, twice_portable, "portable"},
+};
+
+int dispatch() {
+  if (twice(21) != 42) {
+    bela::FPrintF(stderr, L"dispatch: selected %s\n", twice.Name());
+    return 1;
+  }
+  if (twice.Select(0) != twice_portable || twice.Select(bela::cpu::SSE2) != twice_fast) {
+    bela::FPrintF(stderr, L"Select ignores the feature mask\n");
+    return 1;
+  }
+  // tests pin an implementation and restore the detected one afterwards
+  twice.Override(twice_portable);
+  if (twice.Name() != "portable") {
+    return 1;
+  }
+  twice.Override(nullptr);
+  int kernels = 0;
+  twice.Kernels([&](const auto &k) {
+    kernels++;
+    if (k.fn(21) != 42) {
+      bela::FPrintF(stderr, L"kernel %s is wrong\n", k.name);
+    }
+  });
+  bela::FPrintF(stderr, L"twice: %s, %d usable kernels\n", twice.Name(), kernels);
+  return 0;
+}
+
+int sha256() {
+  // FIPS 180-2 test vectors, the second one spans two blocks
+  constexpr struct {
+    const char *input;
+    const char *digest;
+  } vectors[] = {
+      {"abc", "ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad"},
+      {"abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq",
+       "248d6a61d20638b8e5c026930c3e6039a33ce45964ff2167f6ecedd419db06c1"},
+  };
+  for (const auto &v : vectors) {
+    bela::hash::sha256::Hasher h;
+    h.Initialize();
+    h.Update(v.input, strlen(v.input));
+    auto digest = h.Finalize();
+    if (digest != std::wstring(v.digest, v.digest + strlen(v.digest))) {
+      bela::FPrintF(stderr, L"sha256(%s) = %s\n", v.input, digest);
+      return 1;
+    }
+  }
+  std::string data(64 << 20, 'a');
+  auto start = bela::MonotonicNow();
+  bela::hash::sha256::Hasher h;
+  h.Initialize();
+  h.Update(data.data(), data.size());
+  auto digest = h.Finalize();
+  auto elapsed = bela::MonotonicNow() - start;
+  bela::FPrintF(stderr, L"sha256 64MB: %s %.1f MB/s\n", digest, 64.0 / bela::ToDoubleSeconds(elapsed));
+  return 0;
+}
+
+int wmain() {
+  bela::FPrintF(stderr, L"features: %s\n", bela::cpu::FeatureNames(bela::cpu::Features()));
+  if (dispatch() != 0 || sha256() != 0) {
+    return 1;
+  }
+  return 0;
+}
@@ -0,0 +1,86 @@
+#include <bela/interner.hpp>
+#include <bela/terminal.hpp>
+#include <bela/time.hpp>
+#include <atomic>
+#include <random>
+#include <string>
+#include <thread>
+
+// a parser-like stream: a few thousand library names repeated millions of times
+std::vector<std::string> make_names(size_t count, size_t distinct) {
+  std::vector<std::string> names;
+  names.reserve(count);
+  std::mt19937_64 rng(11);
+  for (size_t i = 0; i < count; i++) {
+    names.emplace_back("api-ms-win-core-library-" + std::to_string(rng() % distinct) + "-l1-1-0.dll");
+  }
+  return names;
+}
+
+int single(const std::vector<std::string> &names) {
+  bela::Interner interner;
+  std::vector<uint32_t> ids;
+  ids.reserve(names.size());
+  auto start = bela::MonotonicNow();
+  for (const auto &n : names) {
+    ids.emplace_back(interner.Intern(n));
+  }
+  auto elapsed = bela::MonotonicNow() - start;
+  size_t copies = 0;
+  for (size_t i = 0; i < names.size(); i++) {
+    copies += sizeof(std::string) + names[i].capacity() + 1;
+    auto v = interner.View(ids[i]);
+    if (v != names[i] || v.data()[v.size()] != 0 || interner.Find(names[i]) != ids[i]) {
+      bela::FPrintF(stderr, L"interner: '%s' mismatch\n", names[i]);
+      return 1;
+    }
+  }
+  bela::FPrintF(stderr, L"Interner: %d names, %d distinct in %s, %d KB for strings (%d KB as std::string copies)\n",
+                names.size(), interner.Size(), bela::FormatDuration(elapsed), interner.Bytes() / 1024, copies / 1024);
+  bela::WInterner winterner;
+  auto a = winterner.Intern(L"KERNEL32.dll");
+  auto b = winterner.Intern(std::wstring(10000, L'x'));
+  if (winterner.Intern(L"KERNEL32.dll") != a || a == b || winterner.View(b).size() != 10000 || winterner.Find(L"x")) {
+    bela::FPrintF(stderr, L"WInterner mismatch\n");
+    return 1;
+  }
+  return 0;
+}
+
+int wmain() {
+  auto names = make_names(2000000, 5000);
+  if (single(names) != 0) {
+    return 1;
+  }
+  // every thread interns the whole stream: ids of equal names must agree across threads
+  auto concurrency = (std::min)((std::max)(std::thread::hardware_concurrency(), 1U), 16U);
+  bela::ConcurrentInterner interner;
+  std::vector<std::vector<uint32_t>> ids(concurrency);
+  std::atomic_int errors{0};
+  auto start = bela::MonotonicNow();
+  {
+    std::vector<std::jthread> threads;
+    for (unsigned t = 0; t < concurrency; t++) {
+      threads.emplace_back([&, t] {
+        auto &out = ids[t];
+        out.reserve(names.size());
+        for (const auto &n : names) {
+          auto id = interner.Intern(n);
+          if (interner.View(id) != n) {
+            errors++;
+          }
+          out.emplace_back(id);
+        }
+      });
+    }
+  }
+  auto elapsed = bela::MonotonicNow() - start;
+  for (unsigned t = 1; t < concurrency; t++) {
+    if (ids[t] != ids[0]) {
+      errors++;
+    }
+  }
+  bela::FPrintF(stderr, L"ConcurrentInterner: %d threads x %d names, %d distinct in %s, %d errors\n", concurrency,
+                names.size(), interner.Size(), bela::FormatDuration(elapsed), errors.load());
+  return errors == 0 ? 0 : 1;
+}
@@ -0,0 +1,93 @@
+#include <bela/task.hpp>
+#include <bela/terminal.hpp>
+#include <bela/time.hpp>
+#include <stdexcept>
+#include <string>
+#include <thread>
+
+bela::Task<int> answer() { co_return 42; }
+
+bela::Task<std::string> greet(std::string name) {
+  auto n = co_await answer();
+  co_return name + " " + std::to_string(n);
+}
+
+// a long chain of tasks that complete without suspending: symmetric transfer keeps the stack flat
+bela::Task<uint64_t> count(int n) {
+  uint64_t sum = 0;
+  for (int i = 0; i < n; i++) {
+    sum += static_cast<uint64_t>(co_await answer());
+  }
+  co_return sum;
+}
+
+bela::Task<void> fail() {
+  co_await bela::Schedule();
+  throw std::runtime_error("task failed");
+}
+
+// parse: a CPU-bound piece that hops onto the pool first
+bela::Task<uint64_t> parse(uint64_t seed) {
+  co_await bela::Schedule();
+  uint64_t h = seed;
+  for (int i = 0; i < 100000; i++) {
+    h = (h ^ (h >> 31)) * 0x9E3779B97F4A7C15ULL + static_cast<uint64_t>(i);
+  }
+  co_return h % 1000;
+}
+
+bela::Task<uint64_t> fanout(int n) {
+  std::vector<bela::Task<uint64_t>> tasks;
+  for (int i = 0; i < n; i++) {
+    tasks.emplace_back(parse(static_cast<uint64_t>(i)));
+  }
+  auto results = co_await bela::WhenAll(std::move(tasks));
+  uint64_t sum = 0;
+  for (auto r : results) {
+    sum += r;
+  }
+  co_return sum;
+}
+
+int wmain() {
+  if (auto s = bela::SyncWait(greet("bela")); s != "bela 42") {
+    bela::FPrintF(stderr, L"greet: %s\n", s);
+    return 1;
+  }
+  if (auto n = bela::SyncWait(count(1000000)); n != 42000000) {
+    bela::FPrintF(stderr, L"count: %d\n", n);
+    return 1;
+  }
+  try {
+    bela::SyncWait(fail());
+    bela::FPrintF(stderr, L"exception lost\n");
+    return 1;
+  } catch (const std::runtime_error &) {
+  }
+  std::vector<bela::Task<void>> failing;
+  failing.emplace_back(fail());
+  failing.emplace_back(fail());
+  try {
+    bela::SyncWait(bela::WhenAll(std::move(failing)));
+    bela::FPrintF(stderr, L"WhenAll: exception lost\n");
+    return 1;
+  } catch (const std::runtime_error &) {
+  }
+  if (bela::SyncWait(bela::WhenAll(std::vector<bela::Task<int>>{})).size() != 0) {
+    return 1;
+  }
+  uint64_t expected = 0;
+  for (int i = 0; i < 256; i++) {
+    expected += bela::SyncWait(parse(static_cast<uint64_t>(i)));
+  }
+  auto start = bela::MonotonicNow();
+  auto sum = bela::SyncWait(fanout(256));
+  auto elapsed = bela::MonotonicNow() - start;
+  if (sum != expected) {
+    bela::FPrintF(stderr, L"fanout: %d, expected %d\n", sum, expected);
+    return 1;
+  }
+  bela::FPrintF(stderr, L"256 tasks on %d workers: %s\n", bela::ThreadPool::Default().Concurrency(),
+                bela::FormatDuration(elapsed));
+  return 0;
+}
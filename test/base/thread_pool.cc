@@ -0,0 +1,132 @@
+#include <bela/thread_pool.hpp>
+#include <bela/terminal.hpp>
+#include <bela/time.hpp>
+#include <chrono>
+#include <cmath>
+#include <numeric>
+#include <stdexcept>
+#include <thread>
+
+// nested task groups: every level waits for its children, which only works if waiting threads keep running tasks
+uint64_t fib(bela::ThreadPool &pool, int n) {
+  if (n < 20) {
+    return n < 2 ? n : fib(pool, n - 1) + fib(pool, n - 2);
+  }
+  uint64_t a = 0;
+  bela::TaskGroup group(pool);
+  group.Run([&] { a = fib(pool, n - 1); });
+  auto b = fib(pool, n - 2);
+  group.Wait();
+  return a + b;
+}
+
+int correctness() {
+  std::vector<std::atomic_int> hits(1000003);
+  bela::ParallelFor(0, hits.size(), [&](size_t i) { hits[i]++; }, 1000);
+  for (auto &h : hits) {
+    if (h != 1) {
+      bela::FPrintF(stderr, L"ParallelFor: index visited %d times\n", h.load());
+      return 1;
+    }
+  }
+  std::vector<uint64_t> values(100000);
+  std::iota(values.begin(), values.end(), 0);
+  bela::ParallelForEach(values, [](uint64_t &v) { v *= 2; });
+  if (std::accumulate(values.begin(), values.end(), uint64_t{0}) != uint64_t{99999} * 100000) {
+    bela::FPrintF(stderr, L"ParallelForEach: wrong sum\n");
+    return 1;
+  }
+  if (auto f = fib(bela::ThreadPool::Default(), 30); f != 832040) {
+    bela::FPrintF(stderr, L"fib(30) = %d\n", f);
+    return 1;
+  }
+  // an exception cancels the pieces that have not started and is rethrown by the waiter
+  std::atomic_size_t visited{0};
+  try {
+    bela::ParallelFor(0, 1000000, [&](size_t i) {
+      visited++;
+      if (i == 10) {
+        throw std::runtime_error("stop");
+      }
+    }, 100);
+    bela::FPrintF(stderr, L"ParallelFor: exception lost\n");
+    return 1;
+  } catch (const std::runtime_error &) {
+  }
+  // the calling thread runs the lowest piece: when it throws, the pieces running on workers must be waited for before
+  // the wrapper lambda of ParallelForEach goes out of scope
+  std::vector<int> elements(100000);
+  std::atomic_bool returned{false};
+  std::atomic_size_t started{0};
+  std::atomic_size_t late{0};
+  try {
+    bela::ParallelForEach(elements, [&](int &e) {
+      if (returned) {
+        late++;
+      }
+      if (&e == &elements[0]) {
+        while (started == 0) {
+          std::this_thread::yield();
+        }
+        throw std::runtime_error("stop");
+      }
+      // the first piece of a worker lingers until the caller returned, for at most 100ms
+      if (&e - elements.data() >= 1024 && started++ == 0) {
+        for (int i = 0; i < 100 && !returned; i++) {
+          std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+      }
+    }, 64);
+  } catch (const std::runtime_error &) {
+  }
+  returned = true;
+  std::this_thread::sleep_for(std::chrono::milliseconds(50));
+  if (late != 0) {
+    bela::FPrintF(stderr, L"ParallelForEach: %d calls after the exception was rethrown\n", late.load());
+    return 1;
+  }
+  // cooperative cancellation from outside the loop
+  bela::TaskGroup group;
+  std::atomic_size_t done{0};
+  std::jthread canceller([&] {
+    while (done < 1000) {
+      std::this_thread::yield();
+    }
+    group.Cancel();
+  });
+  bela::ParallelFor(group, 0, 100000000, [&](size_t) { done++; }, 1000);
+  bela::FPrintF(stderr, L"exception after %d of 1000000 iterations, cancelled after %d of 100000000\n", visited.load(),
+                done.load());
+  return done < 100000000 ? 0 : 1;
+}
+
+int wmain() {
+  if (correctness() != 0) {
+    return 1;
+  }
+  // scaling: a compute-bound loop and fine-grained nested groups on pools of 1..N workers
+  auto concurrency = (std::max)(std::thread::hardware_concurrency(), 1U);
+  bela::Duration base[2];
+  for (unsigned n = 1;; n = (std::min)(n * 2, concurrency)) {
+    bela::ThreadPool pool(n);
+    bela::TaskGroup group(pool);
+    std::vector<double> out(1 << 24);
+    auto start = bela::MonotonicNow();
+    bela::ParallelFor(group, 0, out.size(), [&](size_t i) { out[i] = std::sqrt(static_cast<double>(i)) * 1.0001; });
+    auto loop = bela::MonotonicNow() - start;
+    start = bela::MonotonicNow();
+    auto f = fib(pool, 36);
+    auto nested = bela::MonotonicNow() - start;
+    if (n == 1) {
+      base[0] = loop;
+      base[1] = nested;
+    }
+    bela::FPrintF(stderr, L"%2d workers: loop %s (%.2fx), fib(36)=%d %s (%.2fx)\n", n, bela::FormatDuration(loop),
+                  bela::FDivDuration(base[0], loop), f, bela::FormatDuration(nested),
+                  bela::FDivDuration(base[1], nested));
+    if (n == concurrency) {
+      break;
+    }
+  }
+  return 0;
+}
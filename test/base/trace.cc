@@ -0,0 +1,76 @@
+#ifndef BELA_ENABLE_TRACE
+#define BELA_ENABLE_TRACE 1
+#endif
+#include <bela/trace.hpp>
+#include <bela/terminal.hpp>
+#include <bela/time.hpp>
+#include <thread>
+#include <vector>
+
+uint64_t parse(uint64_t size) {
+  BELA_TRACE_SCOPE("parse");
+  BELA_TRACE_COUNT("parse.files", 1);
+  BELA_TRACE_HISTOGRAM("parse.size", size);
+  uint64_t h = size;
+  for (int i = 0; i < 100; i++) {
+    h = (h ^ (h >> 31)) * 0x9E3779B97F4A7C15ULL;
+  }
+  return h;
+}
+
+int wmain() {
+  constexpr int threads = 4;
+  constexpr int perThread = 1000;
+  std::vector<std::thread> workers;
+  for (int t = 0; t < threads; t++) {
+    workers.emplace_back([] {
+      for (uint64_t i = 0; i < perThread; i++) {
+        parse(i);
+      }
+    });
+  }
+  for (auto &w : workers) {
+    w.join();
+  }
+  auto report = bela::trace::Collect();
+  // a worker starting after another exited records into its buffer
+  if (report.events != threads * perThread || report.threads > threads || report.counters.size() != 1 ||
+      report.counters[0].value != threads * perThread) {
+    bela::FPrintF(stderr, L"trace: %d events on %d threads\n", report.events, report.threads);
+    return 1;
+  }
+  const auto &h = report.histograms[0];
+  // 0..999 in log2 buckets: 512..999 is the last one, the median 499 falls into 256..511
+  if (h.count != threads * perThread || h.buckets[10] != threads * 488 || h.Percentile(50) != 511) {
+    bela::FPrintF(stderr, L"histogram: count %d p50 %d\n", h.count, h.Percentile(50));
+    return 1;
+  }
+  auto json = bela::trace::ChromeTrace();
+  if (json.find("\"name\":\"parse\",\"cat\":\"bela\",\"ph\":\"X\"") == std::string::npos ||
+      json.find("\"name\":\"parse.files\",\"ph\":\"C\"") == std::string::npos) {
+    bela::FPrintF(stderr, L"chrome trace: %s\n", json.substr(0, 200));
+    return 1;
+  }
+  // a thread per call: the buffer of an exited thread is reused, the number of buffers does not grow
+  auto buffers = report.threads;
+  for (int i = 0; i < 100; i++) {
+    std::thread([] { parse(1); }).join();
+  }
+  report = bela::trace::Collect();
+  if (report.threads != buffers || report.events != threads * perThread + 100) {
+    bela::FPrintF(stderr, L"thread per call: %d events in %d buffers, %d before\n", report.events, report.threads,
+                  buffers);
+    return 1;
+  }
+  bela::trace::Reset();
+  constexpr int iterations = 1000000;
+  auto start = bela::MonotonicNow();
+  for (int i = 0; i < iterations; i++) {
+    BELA_TRACE_SCOPE("empty");
+  }
+  auto elapsed = bela::MonotonicNow() - start;
+  report = bela::trace::Collect();
+  bela::FPrintF(stderr, L"%d scopes, %d recorded, %d dropped: %.1f ns per scope\n", iterations, report.events,
+                report.dropped, bela::ToDoubleNanoseconds(elapsed) / iterations);
+  return 0;
+}
@@ -0,0 +1,52 @@
+// bela_bench: a small benchmark harness
+#ifndef BELA_BENCH_HPP
+#define BELA_BENCH_HPP
+#include <cstdint>
+#include <functional>
+#include <initializer_list>
+#include <string_view>
+#include <vector>
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#endif
+
+namespace bench {
+// Benchmark runs its operation n times per call. bytes is the input size of one operation, benchmarks that report
+// throughput set it so the runner can print cycles/byte and MB/s.
+struct Benchmark {
+  std::string_view name;
+  uint64_t bytes{0};
+  std::function<void(uint64_t n)> fn;
+};
+
+inline std::vector<Benchmark> &Registry() {
+  static std::vector<Benchmark> benchmarks;
+  return benchmarks;
+}
+
+// Register adds benchmarks from a static initializer:
+//
+//  static const auto registered = bench::Register({
+//      {"StrCat/4", 0, [](uint64_t n) { ... }},
+//  });
+inline bool Register(std::initializer_list<Benchmark> benchmarks) {
+  auto &r = Registry();
+  r.insert(r.end(), benchmarks.begin(), benchmarks.end());
+  return true;
+}
+
+// DoNotOptimize keeps the compiler from discarding a result or hoisting the computation out of the loop
+#if !defined(_MSC_VER) || defined(__clang__)
+template <typename T> inline void DoNotOptimize(const T &value) { __asm__ __volatile__("" : : "g"(&value) : "memory"); }
+#else
+namespace bench_internal {
+void UseCharPointer(const volatile char *);
+} // namespace bench_internal
+template <typename T> inline void DoNotOptimize(const T &value) {
+  bench_internal::UseCharPointer(&reinterpret_cast<const volatile char &>(value));
+  _ReadWriteBarrier();
+}
+#endif
+} // namespace bench
+
+#endif
@@ -0,0 +1,48 @@
+// number conversion benchmarks: bela::to_chars and bela::from_chars on wide strings
+#include <bela/charconv.hpp>
+#include <array>
+#include "bench.hpp"
+
+namespace {
+constexpr std::array<uint64_t, 8> integers{0, 7, 42, 65535, 1000000007, 1ULL << 40, 12345678901234567ULL, ~0ULL};
+constexpr std::array<double, 8> doubles{0.0, 1.5, -3.25, 3.141592653589793, 1e-7, 6.02214076e23, 123456.789, 1e300};
+constexpr std::wstring_view integerText = L"12345678901234567";
+constexpr std::wstring_view doubleText = L"3.141592653589793";
+
+const auto registered = bench::Register({
+    {"to_chars/uint64", 0,
+     [](uint64_t n) {
+       wchar_t buf[32];
+       for (uint64_t i = 0; i < n; i++) {
+         auto r = bela::to_chars(buf, buf + std::size(buf), integers[i % integers.size()]);
+         bench::DoNotOptimize(r);
+       }
+     }},
+    {"to_chars/double", 0,
+     [](uint64_t n) {
+       wchar_t buf[64];
+       for (uint64_t i = 0; i < n; i++) {
+         auto r = bela::to_chars(buf, buf + std::size(buf), doubles[i % doubles.size()]);
+         bench::DoNotOptimize(r);
+       }
+     }},
+    {"from_chars/uint64", integerText.size() * sizeof(wchar_t),
+     [](uint64_t n) {
+       for (uint64_t i = 0; i < n; i++) {
+         uint64_t v = 0;
+         auto r = bela::from_chars(integerText.data(), integerText.data() + integerText.size(), v);
+         bench::DoNotOptimize(r);
+         bench::DoNotOptimize(v);
+       }
+     }},
+    {"from_chars/double", doubleText.size() * sizeof(wchar_t),
+     [](uint64_t n) {
+       for (uint64_t i = 0; i < n; i++) {
+         double v = 0;
+         auto r = bela::from_chars(doubleText.data(), doubleText.data() + doubleText.size(), v);
+         bench::DoNotOptimize(r);
+         bench::DoNotOptimize(v);
+       }
+     }},
+});
+} // namespace
@@ -0,0 +1,49 @@
+// hash benchmarks: every algorithm in belahash over 64 bytes and 1 MiB. The SHA-256 dispatcher and the BLAKE3
+// backends pick their kernels from the CPU features printed in the header.
+#include <bela/hash.hpp>
+#include <string>
+#include "bench.hpp"
+
+namespace {
+constexpr size_t smallSize = 64;
+constexpr size_t largeSize = 1 << 20;
+
+const std::string &Input() {
+  static const std::string input = [] {
+    std::string s(largeSize, '\0');
+    uint32_t x = 2463534242;
+    for (auto &c : s) {
+      x ^= x << 13;
+      x ^= x >> 17;
+      x ^= x << 5;
+      c = static_cast<char>(x);
+    }
+    return s;
+  }();
+  return input;
+}
+
+template <typename Hasher, size_t DigestSize> void Hash(uint64_t n, size_t size) {
+  const auto &input = Input();
+  uint8_t digest[DigestSize];
+  for (uint64_t i = 0; i < n; i++) {
+    Hasher h;
+    h.Initialize();
+    h.Update(input.data(), size);
+    h.Finalize(digest, sizeof(digest));
+    bench::DoNotOptimize(digest);
+  }
+}
+
+#define HASH_BENCHMARKS(name, hasher, digestSize)                                                                     \
+  {name "/64", smallSize, [](uint64_t n) { Hash<hasher, digestSize>(n, smallSize); }},                                 \
+      {name "/1M", largeSize, [](uint64_t n) { Hash<hasher, digestSize>(n, largeSize); }}
+
+const auto registered = bench::Register({
+    HASH_BENCHMARKS("sha256", bela::hash::sha256::Hasher, bela::hash::sha256::sha256_hash_size),
+    HASH_BENCHMARKS("sha512", bela::hash::sha512::Hasher, bela::hash::sha512::sha512_hash_size),
+    HASH_BENCHMARKS("sha3-256", bela::hash::sha3::Hasher, bela::hash::sha3::sha3_256_hash_size),
+    HASH_BENCHMARKS("sm3", bela::hash::sm3::Hasher, bela::hash::sm3::sm3_digest_length),
+    HASH_BENCHMARKS("blake3", bela::hash::blake3::Hasher, BLAKE3_OUT_LEN),
+});
+} // namespace
@@ -0,0 +1,50 @@
+// file type detection benchmarks: hazel::LookupBytes on the first kilobyte of common formats
+#include <hazel/hazel.hpp>
+#include <cstring>
+#include "bench.hpp"
+
+namespace {
+constexpr size_t headerSize = 1024;
+
+std::vector<uint8_t> MakeHeader(std::string_view magic) {
+  std::vector<uint8_t> b(headerSize, 0);
+  memcpy(b.data(), magic.data(), magic.size());
+  return b;
+}
+
+std::vector<uint8_t> MakeText() {
+  constexpr std::string_view line = "#!/usr/bin/env python3\nprint('hello bela')\n";
+  std::vector<uint8_t> b;
+  while (b.size() + line.size() <= headerSize) {
+    b.insert(b.end(), line.begin(), line.end());
+  }
+  return b;
+}
+
+void Lookup(uint64_t n, const std::vector<uint8_t> &data) {
+  for (uint64_t i = 0; i < n; i++) {
+    hazel::hazel_result hr;
+    bela::error_code ec;
+    auto ok = hazel::LookupBytes(bela::bytes_view(data.data(), data.size()), hr, ec);
+    bench::DoNotOptimize(ok);
+  }
+}
+
+const auto registered = bench::Register({
+    {"hazel/LookupBytes/png", headerSize,
+     [](uint64_t n) {
+       static const auto png = MakeHeader(std::string_view("\x89PNG\r\n\x1a\n\0\0\0\x0dIHDR", 16));
+       Lookup(n, png);
+     }},
+    {"hazel/LookupBytes/zip", headerSize,
+     [](uint64_t n) {
+       static const auto zip = MakeHeader(std::string_view("PK\x03\x04\x14\0\0\0\x08\0", 10));
+       Lookup(n, zip);
+     }},
+    {"hazel/LookupBytes/shebang", headerSize,
+     [](uint64_t n) {
+       static const auto text = MakeText();
+       Lookup(n, text);
+     }},
+});
+} // namespace
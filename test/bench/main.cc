@@ -0,0 +1,215 @@
+// bela_bench: run the registered benchmarks, print a table and optionally JSON
+//
+//  bela_bench [--filter=StrCat] [--reps=9] [--min-time=20] [--warmup=100] [--json=results.json]
+//
+// Every benchmark is calibrated until one sample takes at least --min-time milliseconds, warmed up, then sampled
+// --reps times. Statistics are robust: the median and the median absolute deviation, min and mean are printed too.
+// Cycles are CycleClock ticks, the constant-rate counter, not core cycles under frequency scaling.
+#include <bela/codecvt.hpp>
+#include <bela/cpu.hpp>
+#include <bela/cycleclock.hpp>
+#include <bela/io.hpp>
+#include <bela/numbers.hpp>
+#include <bela/str_cat.hpp>
+#include <bela/terminal.hpp>
+#include <bela/time.hpp>
+#include <algorithm>
+#include <cmath>
+#include "bench.hpp"
+
+#if defined(_MSC_VER) && !defined(__clang__)
+namespace bench::bench_internal {
+void UseCharPointer(const volatile char *) {}
+} // namespace bench::bench_internal
+#endif
+
+namespace {
+struct Options {
+  std::wstring_view filter;
+  std::wstring_view json;
+  int reps{9};
+  int64_t minTime{20}; // milliseconds per sample
+  int64_t warmup{100}; // milliseconds per benchmark
+};
+
+struct Sample {
+  double ns;     // per operation
+  double cycles; // per operation
+};
+
+struct Result {
+  std::string_view name;
+  uint64_t bytes{0};
+  uint64_t iterations{0};
+  double median{0};
+  double mad{0};
+  double min{0};
+  double mean{0};
+  double cycles{0};
+};
+
+bool ParseOptions(int argc, wchar_t **argv, Options &opt) {
+  for (int i = 1; i < argc; i++) {
+    std::wstring_view arg(argv[i]);
+    auto value = [&](std::wstring_view name, std::wstring_view &v) {
+      if (!arg.starts_with(name) || arg.size() <= name.size() || arg[name.size()] != '=') {
+        return false;
+      }
+      v = arg.substr(name.size() + 1);
+      return true;
+    };
+    std::wstring_view v;
+    if (value(L"--filter", opt.filter) || value(L"--json", opt.json)) {
+      continue;
+    }
+    if (value(L"--reps", v) && bela::SimpleAtoi(v, &opt.reps) && opt.reps > 0) {
+      continue;
+    }
+    if (value(L"--min-time", v) && bela::SimpleAtoi(v, &opt.minTime) && opt.minTime > 0) {
+      continue;
+    }
+    if (value(L"--warmup", v) && bela::SimpleAtoi(v, &opt.warmup) && opt.warmup >= 0) {
+      continue;
+    }
+    bela::FPrintF(stderr, L"usage: %s [--filter=name] [--reps=N] [--min-time=ms] [--warmup=ms] [--json=file]\n",
+                  argv[0]);
+    return false;
+  }
+  return true;
+}
+
+Sample Measure(const bench::Benchmark &b, uint64_t n) {
+  auto start = bela::MonotonicNow();
+  auto cycles = bela::CycleClock::Now();
+  b.fn(n);
+  cycles = bela::CycleClock::Now() - cycles;
+  auto elapsed = bela::MonotonicNow() - start;
+  return {bela::ToDoubleNanoseconds(elapsed) / static_cast<double>(n),
+          static_cast<double>(cycles) / static_cast<double>(n)};
+}
+
+// Calibrate returns the iteration count for one sample: grow until a sample reaches the minimum time, never more than
+// 10x per step. The first call pays for page faults and lazy initialization, it is not measured.
+uint64_t Calibrate(const bench::Benchmark &b, const Options &opt) {
+  const double target = static_cast<double>(opt.minTime) * 1e6;
+  b.fn(1);
+  uint64_t n = 1;
+  for (;;) {
+    auto s = Measure(b, n);
+    auto total = s.ns * static_cast<double>(n);
+    if (total >= target || n >= (1ULL << 40)) {
+      return n;
+    }
+    auto grow = total > 0 ? target * 1.2 / total : 10.0;
+    n = static_cast<uint64_t>(static_cast<double>(n) * std::clamp(grow, 2.0, 10.0));
+  }
+}
+
+double Median(std::vector<double> v) {
+  std::sort(v.begin(), v.end());
+  auto mid = v.size() / 2;
+  return v.size() % 2 == 0 ? (v[mid - 1] + v[mid]) / 2 : v[mid];
+}
+
+Result Run(const bench::Benchmark &b, const Options &opt) {
+  Result r{.name = b.name, .bytes = b.bytes};
+  r.iterations = Calibrate(b, opt);
+  auto deadline = bela::MonotonicNow() + bela::Milliseconds(opt.warmup);
+  while (bela::MonotonicNow() < deadline) {
+    Measure(b, r.iterations);
+  }
+  std::vector<double> ns;
+  std::vector<double> cycles;
+  for (int i = 0; i < opt.reps; i++) {
+    auto s = Measure(b, r.iterations);
+    ns.push_back(s.ns);
+    cycles.push_back(s.cycles);
+  }
+  r.median = Median(ns);
+  std::vector<double> deviations;
+  for (auto x : ns) {
+    deviations.push_back(std::abs(x - r.median));
+  }
+  r.mad = Median(deviations);
+  r.min = *std::min_element(ns.begin(), ns.end());
+  for (auto x : ns) {
+    r.mean += x;
+  }
+  r.mean /= static_cast<double>(ns.size());
+  r.cycles = Median(cycles);
+  return r;
+}
+
+double CyclesPerByte(const Result &r) { return r.bytes == 0 ? 0 : r.cycles / static_cast<double>(r.bytes); }
+double MegabytesPerSecond(const Result &r) {
+  return r.bytes == 0 || r.median <= 0 ? 0 : static_cast<double>(r.bytes) * 1e3 / r.median;
+}
+
+void AppendJSONString(std::string &out, std::string_view s) {
+  out += '"';
+  for (auto c : s) {
+    if (c == '"' || c == '\\') {
+      out += '\\';
+    }
+    out += c;
+  }
+  out += '"';
+}
+
+std::string EncodeJSON(const std::vector<Result> &results) {
+  std::string out;
+  out += "{\n  \"features\": ";
+  AppendJSONString(out, bela::cpu::FeatureNames(bela::cpu::Features()));
+  bela::StrAppend(&out, ",\n  \"cycle_frequency\": ", bela::CycleClock::Frequency(), ",\n  \"benchmarks\": [");
+  for (size_t i = 0; i < results.size(); i++) {
+    const auto &r = results[i];
+    out += i == 0 ? "\n    {\"name\": " : ",\n    {\"name\": ";
+    AppendJSONString(out, r.name);
+    bela::StrAppend(&out, ", \"iterations\": ", r.iterations, ", \"bytes\": ", r.bytes);
+    bela::StrAppend(&out, ", \"ns_median\": ", r.median, ", \"ns_mad\": ", r.mad);
+    bela::StrAppend(&out, ", \"ns_min\": ", r.min, ", \"ns_mean\": ", r.mean);
+    bela::StrAppend(&out, ", \"cycles\": ", r.cycles, ", \"cycles_per_byte\": ", CyclesPerByte(r));
+    bela::StrAppend(&out, ", \"mb_per_s\": ", MegabytesPerSecond(r), "}");
+  }
+  out += "\n  ]\n}\n";
+  return out;
+}
+} // namespace
+
+int wmain(int argc, wchar_t **argv) {
+  Options opt;
+  if (!ParseOptions(argc, argv, opt)) {
+    return 1;
+  }
+  auto benchmarks = bench::Registry();
+  std::sort(benchmarks.begin(), benchmarks.end(), [](const auto &a, const auto &b) { return a.name < b.name; });
+  bela::FPrintF(stderr, L"features: %s\ncycle clock: %d Hz, %d repetitions\n",
+                bela::cpu::FeatureNames(bela::cpu::Features()), bela::CycleClock::Frequency(), opt.reps);
+  bela::FPrintF(stderr, L"%-32s %12s %8s %12s %12s %10s %10s\n", L"benchmark", L"ns/op", L"mad%", L"min", L"cycles",
+                L"cycles/B", L"MB/s");
+  std::vector<Result> results;
+  for (const auto &b : benchmarks) {
+    if (!opt.filter.empty() && bela::encode_into<char, wchar_t>(b.name).find(opt.filter) == std::wstring::npos) {
+      continue;
+    }
+    const auto &r = results.emplace_back(Run(b, opt));
+    auto madPercent = r.median > 0 ? r.mad * 100 / r.median : 0;
+    if (r.bytes == 0) {
+      bela::FPrintF(stderr, L"%-32s %12.2f %8.2f %12.2f %12.1f %10s %10s\n", r.name, r.median, madPercent, r.min,
+                    r.cycles, L"-", L"-");
+      continue;
+    }
+    bela::FPrintF(stderr, L"%-32s %12.2f %8.2f %12.2f %12.1f %10.3f %10.1f\n", r.name, r.median, madPercent, r.min,
+                  r.cycles, CyclesPerByte(r), MegabytesPerSecond(r));
+  }
+  if (opt.json.empty()) {
+    return 0;
+  }
+  auto json = EncodeJSON(results);
+  bela::error_code ec;
+  if (!bela::io::WriteText(opt.json, {reinterpret_cast<const uint8_t *>(json.data()), json.size()}, ec)) {
+    bela::FPrintF(stderr, L"write %s: %s\n", opt.json, ec);
+    return 1;
+  }
+  return 0;
+}
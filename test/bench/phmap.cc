@@ -0,0 +1,67 @@
+// hash map benchmarks: bela::flat_hash_map lookups with integer and string keys, hits and misses
+#include <bela/phmap.hpp>
+#include <bela/str_cat.hpp>
+#include "bench.hpp"
+
+namespace {
+constexpr size_t mapSize = 1 << 16;
+
+struct Maps {
+  bela::flat_hash_map<uint64_t, uint64_t> integers;
+  bela::flat_hash_map<std::wstring, size_t> strings;
+  std::vector<uint64_t> integerKeys;
+  std::vector<std::wstring> stringKeys;
+  Maps() {
+    for (size_t i = 0; i < mapSize; i++) {
+      // scattered keys so lookups do not walk the table in order
+      auto k = static_cast<uint64_t>(i) * 0x9E3779B97F4A7C15ULL;
+      integers.emplace(k, i);
+      integerKeys.emplace_back(k);
+      auto s = bela::StringCat(L"HKEY_LOCAL_MACHINE\\SOFTWARE\\Bela\\", k);
+      strings.emplace(s, i);
+      stringKeys.emplace_back(std::move(s));
+    }
+  }
+};
+
+const Maps &GetMaps() {
+  static const Maps maps;
+  return maps;
+}
+
+const auto registered = bench::Register({
+    {"phmap/uint64/hit", 0,
+     [](uint64_t n) {
+       const auto &m = GetMaps();
+       for (uint64_t i = 0; i < n; i++) {
+         auto it = m.integers.find(m.integerKeys[i % mapSize]);
+         bench::DoNotOptimize(it->second);
+       }
+     }},
+    {"phmap/uint64/miss", 0,
+     [](uint64_t n) {
+       const auto &m = GetMaps();
+       for (uint64_t i = 0; i < n; i++) {
+         auto found = m.integers.contains(m.integerKeys[i % mapSize] + 1);
+         bench::DoNotOptimize(found);
+       }
+     }},
+    {"phmap/wstring/hit", 0,
+     [](uint64_t n) {
+       const auto &m = GetMaps();
+       for (uint64_t i = 0; i < n; i++) {
+         auto it = m.strings.find(m.stringKeys[i % mapSize]);
+         bench::DoNotOptimize(it->second);
+       }
+     }},
+    {"phmap/wstring/miss", 0,
+     [](uint64_t n) {
+       const auto &m = GetMaps();
+       const std::wstring missing = L"HKEY_LOCAL_MACHINE\\SOFTWARE\\Bela\\missing";
+       for (uint64_t i = 0; i < n; i++) {
+         auto found = m.strings.contains(missing);
+         bench::DoNotOptimize(found);
+       }
+     }},
+});
+} // namespace
@@ -0,0 +1,65 @@
+// string benchmarks: concatenation, splitting, replacement, UTF-8/UTF-16 conversion and glob matching
+#include <bela/codecvt.hpp>
+#include <bela/fnmatch.hpp>
+#include <bela/str_cat.hpp>
+#include <bela/str_replace.hpp>
+#include <bela/str_split.hpp>
+#include "bench.hpp"
+
+namespace {
+constexpr std::wstring_view path = L"C:/Users/bela/AppData/Local/Programs/Microsoft VS Code/resources/app/out/main.js";
+constexpr std::string_view text = "The quick brown fox jumps over the lazy dog. Der schnelle Fuchs. 敏捷的棕色狐狸";
+const std::wstring wtext = bela::encode_into<char, wchar_t>(text);
+
+const auto registered = bench::Register({
+    {"StrCat/4", 0,
+     [](uint64_t n) {
+       for (uint64_t i = 0; i < n; i++) {
+         auto s = bela::StringCat(L"bela-", i, L"-", path);
+         bench::DoNotOptimize(s);
+       }
+     }},
+    {"StrSplit/path", path.size() * sizeof(wchar_t),
+     [](uint64_t n) {
+       for (uint64_t i = 0; i < n; i++) {
+         std::vector<std::wstring_view> parts = bela::StrSplit(path, bela::ByChar('/'), bela::SkipEmpty());
+         bench::DoNotOptimize(parts);
+       }
+     }},
+    {"StrReplaceAll/3", path.size() * sizeof(wchar_t),
+     [](uint64_t n) {
+       for (uint64_t i = 0; i < n; i++) {
+         auto s = bela::StrReplaceAll(path, {{L"/", L"\\"}, {L"bela", L"user"}, {L"Microsoft VS Code", L"Code"}});
+         bench::DoNotOptimize(s);
+       }
+     }},
+    {"encode_into/utf8-utf16", text.size(),
+     [](uint64_t n) {
+       for (uint64_t i = 0; i < n; i++) {
+         auto s = bela::encode_into<char, wchar_t>(text);
+         bench::DoNotOptimize(s);
+       }
+     }},
+    {"encode_into/utf16-utf8", wtext.size() * sizeof(wchar_t),
+     [](uint64_t n) {
+       for (uint64_t i = 0; i < n; i++) {
+         auto s = bela::encode_into<wchar_t, char>(wtext);
+         bench::DoNotOptimize(s);
+       }
+     }},
+    {"FnMatch/star", 0,
+     [](uint64_t n) {
+       for (uint64_t i = 0; i < n; i++) {
+         auto matched = bela::FnMatch(L"C:/Users/*/AppData/*/main.js", path);
+         bench::DoNotOptimize(matched);
+       }
+     }},
+    {"FnMatch/casefold", 0,
+     [](uint64_t n) {
+       for (uint64_t i = 0; i < n; i++) {
+         auto matched = bela::FnMatch(L"*/microsoft vs code/*.[jt]s", path, bela::fnmatch::CaseFold);
+         bench::DoNotOptimize(matched);
+       }
+     }},
+});
+} // namespace
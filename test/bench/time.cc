@@ -0,0 +1,55 @@
+// time benchmarks: RFC 3339 formatting and civil time conversion
+#include <bela/datetime.hpp>
+#include "bench.hpp"
+
+namespace {
+const auto registered = bench::Register({
+    {"FormatDateTime/narrow", 0,
+     [](uint64_t n) {
+       bela::DateTime dt(bela::FromUnixSeconds(1700000000));
+       for (uint64_t i = 0; i < n; i++) {
+         auto s = dt.Format<char>(true);
+         bench::DoNotOptimize(s);
+       }
+     }},
+    {"FormatDateTime/wide", 0,
+     [](uint64_t n) {
+       bela::DateTime dt(bela::FromUnixSeconds(1700000000));
+       for (uint64_t i = 0; i < n; i++) {
+         auto s = dt.Format<wchar_t>(true);
+         bench::DoNotOptimize(s);
+       }
+     }},
+    // stamps 1ms apart: the cached prefix is reused, one refresh per 1000 stamps
+    {"TimestampFormatter/same-second", 0,
+     [](uint64_t n) {
+       bela::TimestampFormatter f;
+       char buffer[bela::TimestampFormatter::MaxLength];
+       auto t = bela::FromUnixSeconds(1700000000);
+       for (uint64_t i = 0; i < n; i++) {
+         auto len = f.Format(t + bela::Milliseconds(static_cast<int64_t>(i)), buffer);
+         bench::DoNotOptimize(len);
+         bench::DoNotOptimize(buffer);
+       }
+     }},
+    // every stamp in a new second: the prefix is formatted each time
+    {"TimestampFormatter/new-second", 0,
+     [](uint64_t n) {
+       bela::TimestampFormatter f;
+       char buffer[bela::TimestampFormatter::MaxLength];
+       auto t = bela::FromUnixSeconds(1700000000);
+       for (uint64_t i = 0; i < n; i++) {
+         auto len = f.Format(t + bela::Seconds(static_cast<int64_t>(i)), buffer);
+         bench::DoNotOptimize(len);
+         bench::DoNotOptimize(buffer);
+       }
+     }},
+    {"DateTime/FromTime", 0,
+     [](uint64_t n) {
+       for (uint64_t i = 0; i < n; i++) {
+         bela::DateTime dt(bela::FromUnixSeconds(static_cast<int64_t>(1700000000 + i * 3607)));
+         bench::DoNotOptimize(dt);
+       }
+     }},
+});
+} // namespace
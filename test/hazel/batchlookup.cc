@@ -0,0 +1,34 @@
+//
+#include <hazel/hazel.hpp>
+#include <bela/terminal.hpp>
+#include <bela/time.hpp>
+
+int wmain(int argc, wchar_t **argv) {
+  if (argc < 2) {
+    bela::FPrintF(stderr, L"usage: %s file...\n", argv[0]);
+    return 1;
+  }
+  std::vector<std::wstring> files;
+  for (int i = 1; i < argc; i++) {
+    files.emplace_back(argv[i]);
+  }
+  bela::error_code ec;
+  auto begin = bela::Now();
+  size_t detected = 0;
+  if (!hazel::LookupFiles(
+          files,
+          [&](size_t index, hazel::hazel_result &hr, const bela::error_code &e) {
+            if (e) {
+              bela::FPrintF(stderr, L"%s: %s\n", files[index], e);
+              return;
+            }
+            detected++;
+            bela::FPrintF(stdout, L"%s: %s (%d bytes)\n", files[index], hr.description(), hr.size());
+          },
+          ec)) {
+    bela::FPrintF(stderr, L"lookup files: %s\n", ec);
+    return 1;
+  }
+  bela::FPrintF(stderr, L"%d/%d files in %s\n", detected, files.size(), bela::FormatDuration(bela::Now() - begin));
+  return 0;
+}
@@ -1,6 +1,7 @@
 //
 #include <hazel/hazel.hpp>
 #include <hazel/zip.hpp>
+#include <bela/alloc_stats.hpp>
 #include <bela/terminal.hpp>
 #include <bela/path.hpp>
 #include <bela/datetime.hpp>
@@ -20,9 +21,12 @@ inline std::string TimeString(time_t t) {
   return buffer;
 }
 
-int listArchive(std::wstring_view path, HANDLE fd, int64_t size, int64_t offset) {
+constinit bela::alloc_stats::Tag zipTag{"hazel.zip"};
+
+int listArchive(std::wstring_view path, HANDLE fd, int64_t size, int64_t offset, bool allocStats) {
   bela::error_code ec;
-  hazel::zip::Reader zr;
+  bela::alloc_stats::CountingResource resource(zipTag);
+  hazel::zip::Reader zr(&resource);
   if (!zr.OpenReader(fd, size, offset, ec)) {
     bela::FPrintF(stderr, L"open zip file: %s error %s\n", path, ec);
     return 1;
@@ -74,12 +78,23 @@ int listArchive(std::wstring_view path, HANDLE fd, int64_t size, int64_t offset)
   }
   bela::FPrintF(stdout, L"Files: %d CompressedSize: %d UncompressedSize: %d\n", zr.Files().size(), zr.CompressedSize(),
                 zr.UncompressedSize());
+  if (allocStats) {
+    for (const auto &s : bela::alloc_stats::ThreadReport()) {
+      bela::FPrintF(stderr, L"%s: %d allocations, %d bytes, peak %d bytes\n", s.name, s.allocations, s.bytes, s.peak);
+    }
+  }
   return 0;
 }
 
 int wmain(int argc, wchar_t **argv) {
+  // --alloc-stats: report what reading the archive allocated
+  bool allocStats = argc > 2 && std::wstring_view(argv[1]) == L"--alloc-stats";
+  if (allocStats) {
+    argv++;
+    argc--;
+  }
   if (argc < 2) {
-    bela::FPrintF(stderr, L"usage: %s zipfile\n", argv[0]);
+    bela::FPrintF(stderr, L"usage: %s [--alloc-stats] zipfile\n", argv[0]);
     return 1;
   }
   bela::error_code ec;
@@ -104,7 +119,7 @@ int wmain(int argc, wchar_t **argv) {
   }
   if (hr.LooksLikeZIP()) {
 
-    return listArchive(path, fd->NativeFD(), hr.size(), 0);
+    return listArchive(path, fd->NativeFD(), hr.size(), 0, allocStats);
   }
   if (!hr.LooksLikePE()) {
     bela::FPrintF(stderr, L"file: %s not zip file\n", argv[1]);
@@ -119,5 +134,5 @@ int wmain(int argc, wchar_t **argv) {
     bela::FPrintF(stderr, L"file: %s not zip file\n", argv[1]);
     return 1;
   }
-  return listArchive(path, fd->NativeFD(), hr.size(), file.OverlayOffset());
+  return listArchive(path, fd->NativeFD(), hr.size(), file.OverlayOffset(), allocStats);
 }
\ No newline at end of file
@@ -0,0 +1,95 @@
+#include <bela/async.hpp>
+#include <bela/str_cat.hpp>
+#include <bela/terminal.hpp>
+#include <bela/time.hpp>
+#include <stdexcept>
+
+constexpr int64_t chunkSize = 1024 * 1024;
+
+// one chunk: the read is pending without a thread, the checksum runs on the pool as soon as the bytes arrived
+bela::Task<uint64_t> checksum(const bela::io::AsyncFile &file, int64_t pos) {
+  std::vector<uint8_t> buffer(chunkSize);
+  int64_t n = 0;
+  bela::error_code ec;
+  if (!co_await file.ReadAt(buffer, pos, n, ec)) {
+    throw std::runtime_error("ReadAt failed");
+  }
+  uint64_t sum = 0;
+  for (int64_t i = 0; i < n; i++) {
+    sum = sum * 31 + buffer[i];
+  }
+  co_return sum;
+}
+
+bela::Task<uint64_t> checksums(const bela::io::AsyncFile &file, int64_t size) {
+  std::vector<bela::Task<uint64_t>> chunks;
+  for (int64_t pos = 0; pos < size; pos += chunkSize) {
+    chunks.emplace_back(checksum(file, pos));
+  }
+  uint64_t total = 0;
+  for (auto s : co_await bela::WhenAll(std::move(chunks))) {
+    total ^= s;
+  }
+  co_return total;
+}
+
+bela::Task<int> child(int code) {
+  auto cmd = bela::StringCat(L"cmd /c exit ", code);
+  STARTUPINFOW si{sizeof(si)};
+  PROCESS_INFORMATION pi{};
+  if (CreateProcessW(nullptr, cmd.data(), nullptr, nullptr, FALSE, CREATE_NO_WINDOW, nullptr, nullptr, &si, &pi) !=
+      TRUE) {
+    co_return -1;
+  }
+  CloseHandle(pi.hThread);
+  DWORD exitCode = 0;
+  bela::error_code ec;
+  auto ok = co_await bela::process::WaitExit(pi.hProcess, exitCode, ec);
+  CloseHandle(pi.hProcess);
+  co_return ok ? static_cast<int>(exitCode) : -1;
+}
+
+int wmain(int argc, wchar_t **argv) {
+  if (argc < 2) {
+    bela::FPrintF(stderr, L"usage: %s file\n", argv[0]);
+    return 1;
+  }
+  bela::error_code ec;
+  bela::io::AsyncFile file;
+  if (!file.Open(argv[1], ec)) {
+    bela::FPrintF(stderr, L"open file %s\n", ec);
+    return 1;
+  }
+  auto size = file.Size(ec);
+  if (size < 0) {
+    bela::FPrintF(stderr, L"file size %s\n", ec);
+    return 1;
+  }
+  auto start = bela::MonotonicNow();
+  auto sum = bela::SyncWait(checksums(file, size));
+  bela::FPrintF(stderr, L"%d bytes in %d chunks: %08x %s\n", size, (size + chunkSize - 1) / chunkSize, sum,
+                bela::FormatDuration(bela::MonotonicNow() - start));
+
+  // 100 timers in flight on a handful of threads
+  start = bela::MonotonicNow();
+  std::vector<bela::Task<void>> sleepers;
+  for (int i = 0; i < 100; i++) {
+    sleepers.emplace_back([]() -> bela::Task<void> { co_await bela::SleepFor(std::chrono::milliseconds(50)); }());
+  }
+  bela::SyncWait(bela::WhenAll(std::move(sleepers)));
+  bela::FPrintF(stderr, L"100 x 50ms sleeps: %s\n", bela::FormatDuration(bela::MonotonicNow() - start));
+
+  std::vector<bela::Task<int>> children;
+  for (int i = 0; i < 4; i++) {
+    children.emplace_back(child(i + 1));
+  }
+  auto codes = bela::SyncWait(bela::WhenAll(std::move(children)));
+  for (size_t i = 0; i < codes.size(); i++) {
+    if (codes[i] != static_cast<int>(i + 1)) {
+      bela::FPrintF(stderr, L"child %d exited with %d\n", i, codes[i]);
+      return 1;
+    }
+  }
+  bela::FPrintF(stderr, L"children exited with 1..%d\n", codes.size());
+  return 0;
+}
@@ -0,0 +1,76 @@
+#include <bela/batch_reader.hpp>
+#include <bela/io.hpp>
+#include <bela/str_cat.hpp>
+#include <bela/terminal.hpp>
+#include <stdexcept>
+
+// batchreader_test [dir]: read the headers of a few hundred files, then throw from the callback partway through a
+// batch; Read must propagate the exception instead of hanging and the reader must stay usable
+int wmain(int argc, wchar_t **argv) {
+  std::wstring dir = argc > 1 ? argv[1] : L"batchreader.tmp";
+  CreateDirectoryW(dir.data(), nullptr);
+  std::vector<std::wstring> files;
+  bela::error_code ec;
+  for (int i = 0; i < 500; i++) {
+    auto file = bela::StringCat(dir, L"\\", i, L".txt");
+    auto text = bela::StringCat("file ", i);
+    if (!bela::io::WriteText(file, {reinterpret_cast<const uint8_t *>(text.data()), text.size()}, ec)) {
+      bela::FPrintF(stderr, L"write %s: %s\n", file, ec);
+      return 1;
+    }
+    files.emplace_back(std::move(file));
+  }
+  auto cleanup = bela::finally([&] {
+    for (const auto &file : files) {
+      DeleteFileW(file.data());
+    }
+    RemoveDirectoryW(dir.data());
+  });
+  int failed = 0;
+  // depth 16 and 4 submitters: submitters are blocked on a full pool when the callback throws
+  bela::io::BatchReader reader(64, 16, 4);
+  auto read = [&]() -> size_t {
+    size_t matched = 0;
+    if (!reader.Read(
+            files,
+            [&](const bela::io::BatchCompletion &c) {
+              if (!c.ec && std::string_view(reinterpret_cast<const char *>(c.data.data()), c.data.size()) ==
+                               bela::StringCat("file ", c.index)) {
+                matched++;
+              }
+            },
+            ec)) {
+      bela::FPrintF(stderr, L"read: %s\n", ec);
+    }
+    return matched;
+  };
+  if (auto matched = read(); matched != files.size()) {
+    bela::FPrintF(stderr, L"\x1b[31mread %d of %d files\x1b[0m\n", matched, files.size());
+    failed++;
+  }
+  size_t calls = 0;
+  try {
+    reader.Read(
+        files,
+        [&](const bela::io::BatchCompletion &) {
+          if (++calls == 100) {
+            throw std::runtime_error("stop");
+          }
+        },
+        ec);
+    bela::FPrintF(stderr, L"\x1b[31mexception lost\x1b[0m\n");
+    failed++;
+  } catch (const std::runtime_error &) {
+  }
+  if (calls != 100) {
+    bela::FPrintF(stderr, L"\x1b[31mcallback called %d times after the exception\x1b[0m\n", calls - 100);
+    failed++;
+  }
+  // every slot came back: a second pass reads all files again
+  if (auto matched = read(); matched != files.size()) {
+    bela::FPrintF(stderr, L"\x1b[31mread %d of %d files after the exception\x1b[0m\n", matched, files.size());
+    failed++;
+  }
+  bela::FPrintF(stderr, L"batchreader: %d failed\n", failed);
+  return failed == 0 ? 0 : 1;
+}
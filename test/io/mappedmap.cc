@@ -0,0 +1,67 @@
+#include <bela/mapped_hash_map.hpp>
+#include <bela/terminal.hpp>
+#include <bela/time.hpp>
+#include <random>
+
+// mappedmap_test [snapshot]: save a file-identity style table, map it back and probe every key in place
+int wmain(int argc, wchar_t **argv) {
+  std::wstring file = argc > 1 ? argv[1] : L"mappedmap.snapshot";
+  constexpr size_t count = 2000000;
+  bela::flat_hash_map<uint64_t, uint64_t> table;
+  std::vector<uint64_t> keys(count);
+  std::mt19937_64 rng(20231018);
+  for (auto &k : keys) {
+    k = rng();
+    table[k] = k ^ 0x5A5A5A5A5A5A5A5AULL;
+  }
+  bela::error_code ec;
+  auto start = bela::MonotonicNow();
+  if (!bela::MappedFlatHashMap<uint64_t, uint64_t>::Save(file, table, ec)) {
+    bela::FPrintF(stderr, L"save %s: %s\n", file, ec);
+    return 1;
+  }
+  auto saved = bela::MonotonicNow() - start;
+  bela::MappedFlatHashMap<uint64_t, uint64_t> mapped;
+  start = bela::MonotonicNow();
+  if (!mapped.Open(file, ec)) {
+    bela::FPrintF(stderr, L"open %s: %s\n", file, ec);
+    return 1;
+  }
+  auto opened = bela::MonotonicNow() - start;
+  size_t errors = 0;
+  start = bela::MonotonicNow();
+  for (auto k : keys) {
+    if (auto e = mapped.Find(k); e == nullptr || e->second != (k ^ 0x5A5A5A5A5A5A5A5AULL)) {
+      errors++;
+    }
+  }
+  auto probed = bela::MonotonicNow() - start;
+  for (int i = 0; i < 100000; i++) {
+    if (auto k = rng(); mapped.Contains(k) != table.contains(k)) {
+      errors++;
+    }
+  }
+  // moving hands the mapping over and leaves the source empty, a self-move keeps it
+  auto moved = std::move(mapped);
+  if (!mapped.Empty() || mapped.Find(keys[0]) != nullptr || moved.Size() != count) {
+    errors++;
+  }
+  auto &self = moved;
+  moved = std::move(self);
+  if (auto e = moved.Find(keys[0]); e == nullptr || e->second != (keys[0] ^ 0x5A5A5A5A5A5A5A5AULL)) {
+    errors++;
+  }
+  mapped = std::move(moved);
+  if (!moved.Empty() || mapped.Size() != count || !mapped.Contains(keys[count - 1])) {
+    errors++;
+  }
+  // a snapshot must not open with another value type
+  if (bela::MappedFlatHashMap<uint64_t, uint32_t> other; other.Open(file, ec)) {
+    errors++;
+  }
+  bela::FPrintF(stderr, L"%d entries: save %s open %s probe %s, %d errors\n", mapped.Size(),
+                bela::FormatDuration(saved), bela::FormatDuration(opened), bela::FormatDuration(probed), errors);
+  mapped.Close();
+  DeleteFileW(file.data());
+  return errors == 0 ? 0 : 1;
+}
@@ -0,0 +1,118 @@
+// Equivalence checks between the Neri-Schneider civil date conversion and the previous cycle/loop based code.
+#include <bela/datetime.hpp>
+#include <bela/terminal.hpp>
+#include <random>
+
+namespace reference {
+// previous DaysSinceEpoch: sum month lengths, valid from year 1
+constexpr int64_t DaysSinceEpoch(int64_t y, int mon, int d) {
+  auto days = bela::time_internal::daysSinceEpoch(y);
+  for (auto i = 1; i < mon; i++) {
+    days += bela::time_internal::Months[i - 1];
+  }
+  if (mon > 2 && bela::IsLeapYear(y)) {
+    days++;
+  }
+  return days + d - 1;
+}
+
+// previous MakeDateTime (port from musl)
+bela::time_internal::civil_day CivilFromDays(int64_t days) {
+  static constexpr const uint8_t days_in_month[] = {31, 30, 31, 30, 31, 31, 30, 31, 30, 31, 31, 29};
+  days -= 10957 + 31 + 29; // 2000-03-01
+  auto qccycles = days / bela::daysPer400Years;
+  auto remdays = days % bela::daysPer400Years;
+  if (remdays < 0) {
+    remdays += bela::daysPer400Years;
+    qccycles--;
+  }
+  auto ccycles = remdays / bela::daysPer100Years;
+  if (ccycles == 4) {
+    ccycles--;
+  }
+  remdays -= ccycles * bela::daysPer100Years;
+  auto qcycles = remdays / bela::daysPer4Years;
+  if (qcycles == 25) {
+    qcycles--;
+  }
+  remdays -= qcycles * bela::daysPer4Years;
+  auto remyears = remdays / 365;
+  if (remyears == 4) {
+    remyears--;
+  }
+  remdays -= remyears * 365;
+  auto years = remyears + 4 * qcycles + 100 * ccycles + 400LL * qccycles;
+  int months = 0;
+  for (; days_in_month[months] <= remdays; months++) {
+    remdays -= days_in_month[months];
+  }
+  if (months >= 10) {
+    months -= 12;
+    years++;
+  }
+  return {years + 2000, months + 3, static_cast<int>(remdays + 1)};
+}
+} // namespace reference
+
+bool check(int64_t days) {
+  auto a = bela::time_internal::CivilFromDays(days);
+  auto b = reference::CivilFromDays(days);
+  if (a.year != b.year || a.month != b.month || a.day != b.day) {
+    bela::FPrintF(stderr, L"CivilFromDays(%d): %d-%d-%d expected %d-%d-%d\n", days, a.year, a.month, a.day, b.year,
+                  b.month, b.day);
+    return false;
+  }
+  if (auto d = bela::time_internal::DaysFromCivil(a.year, a.month, a.day); d != days) {
+    bela::FPrintF(stderr, L"DaysFromCivil(%d-%d-%d): %d expected %d\n", a.year, a.month, a.day, d, days);
+    return false;
+  }
+  // the previous DaysSinceEpoch truncated divisions and was only correct from year 1
+  if (auto d = reference::DaysSinceEpoch(a.year, a.month, a.day); a.year > 0 && d != days) {
+    bela::FPrintF(stderr, L"reference DaysSinceEpoch(%d-%d-%d): %d expected %d\n", a.year, a.month, a.day, d, days);
+    return false;
+  }
+  return true;
+}
+
+int wmain() {
+  // exhaustive over years [-400000, 400000]
+  constexpr int64_t span = 400000LL * bela::daysPer400Years / 400;
+  for (int64_t days = -span; days <= span; days++) {
+    if (!check(days)) {
+      return 1;
+    }
+  }
+  // sampled over the whole range accepted by MakeDateTime
+  constexpr int64_t limit = (static_cast<int64_t>(INT_MAX) - 2000) * 365;
+  std::mt19937_64 rng(20201206);
+  std::uniform_int_distribution<int64_t> dist(-limit, limit);
+  for (int i = 0; i < 10000000; i++) {
+    if (!check(dist(rng))) {
+      return 1;
+    }
+  }
+  // batch conversion matches DateTime
+  std::vector<bela::Time> times;
+  for (int i = 0; i < 100000; i++) {
+    times.emplace_back(bela::FromUnix(dist(rng) / 1000, i));
+  }
+  auto n = times.size();
+  std::vector<std::int_fast64_t> year(n);
+  std::vector<std::int_least8_t> month(n), day(n), hour(n), minute(n), second(n), weekday(n);
+  std::vector<std::int_least32_t> nsec(n);
+  if (!bela::MakeDateTimes(times, {year, month, day, hour, minute, second, weekday, nsec})) {
+    bela::FPrintF(stderr, L"MakeDateTimes failed\n");
+    return 1;
+  }
+  for (size_t i = 0; i < n; i++) {
+    bela::DateTime dt(times[i]);
+    if (dt.Year() != year[i] || dt.Month() != month[i] || dt.Day() != day[i] || dt.Hour() != hour[i] ||
+        dt.Minute() != minute[i] || dt.Second() != second[i] || dt.Weekday() != weekday[i] ||
+        static_cast<int32_t>(i) != nsec[i]) {
+      bela::FPrintF(stderr, L"MakeDateTimes mismatch at %d: %s\n", i, dt.Format());
+      return 1;
+    }
+  }
+  bela::FPrintF(stderr, L"civil date conversion: ok\n");
+  return 0;
+}
@@ -0,0 +1,38 @@
+//
+#include <bela/cycleclock.hpp>
+#include <bela/terminal.hpp>
+#include <chrono>
+
+template <typename F> void Bench(std::wstring_view name, F &&fn, int64_t n = 10'000'000) {
+  int64_t sink = 0;
+  auto start = bela::MonotonicNow();
+  for (int64_t i = 0; i < n; i++) {
+    sink += fn();
+  }
+  auto elapsed = bela::MonotonicNow() - start;
+  bela::FPrintF(stdout, L"%-24s %6.2f ns/call (%d)\n", name,
+                bela::ToDoubleNanoseconds(elapsed) / static_cast<double>(n), sink & 1);
+}
+
+int wmain() {
+  auto m = bela::MonotonicNow();
+  auto frequency = bela::CycleClock::Frequency(); // first use calibrates
+  auto calibrate = bela::MonotonicNow() - m;
+  bela::FPrintF(stdout, L"CycleClock: %d Hz invariant: %b calibrate: %s\n", frequency, bela::CycleClock::Invariant(),
+                bela::FormatDuration(calibrate));
+  Bench(L"bela::CycleClock::Now", [] { return bela::CycleClock::Now(); });
+  Bench(L"bela::MonotonicNow", [] { return bela::ToInt64Nanoseconds(bela::MonotonicNow()); });
+  Bench(L"bela::CoarseMonotonicNow", [] { return bela::ToInt64Nanoseconds(bela::CoarseMonotonicNow()); });
+  Bench(L"bela::CoarseNow", [] { return bela::ToUnixNanos(bela::CoarseNow()); });
+  Bench(L"bela::Now", [] { return bela::ToUnixNanos(bela::Now()); });
+  Bench(L"steady_clock::now", [] { return std::chrono::steady_clock::now().time_since_epoch().count(); });
+  Bench(L"CycleClock::ToDuration", [i = int64_t{0}]() mutable {
+    return bela::ToInt64Nanoseconds(bela::CycleClock::ToDuration(i += 12345));
+  });
+  auto m0 = bela::MonotonicNow();
+  auto t0 = bela::CycleClock::Now();
+  bela::SleepFor(bela::Milliseconds(100));
+  bela::FPrintF(stdout, L"SleepFor(100ms): MonotonicNow %s CycleClock %s\n",
+                bela::FormatDuration(bela::MonotonicNow() - m0), bela::FormatDuration(bela::CycleClock::Elapsed(t0)));
+  return 0;
+}
@@ -0,0 +1,355 @@
+//
+#include <bela/time.hpp>
+#include <bela/strip.hpp>
+#include <bela/terminal.hpp>
+#include <random>
+
+namespace legacy {
+using bela::Duration;
+using namespace bela;
+// FormatDuration and ParseDuration as they were before the allocation-free formatter and the integer fast path, kept
+// as reference and benchmark baseline
+// Formats a positive 64-bit integer in the given field width.  Note that
+// it is up to the caller of Format64() to ensure that there is sufficient
+// space before ep to hold the conversion.
+wchar_t *Format64(wchar_t *ep, int width, int64_t v) {
+  do {
+    --width;
+    *--ep = L'0' + (v % 10); // contiguous digits
+  } while ((v /= 10) != 0);
+  while (--width >= 0) {
+    *--ep = L'0'; // zero pad
+  }
+  return ep;
+}
+
+// Helpers for FormatDuration() that format 'n' and append it to 'out'
+// followed by the given 'unit'.  If 'n' formats to "0", nothing is
+// appended (not even the unit).
+
+// A type that encapsulates how to display a value of a particular unit. For
+// values that are displayed with fractional parts, the precision indicates
+// where to round the value. The precision varies with the display unit because
+// a Duration can hold only quarters of a nanosecond, so displaying information
+// beyond that is just noise.
+//
+// For example, a microsecond value of 42.00025xxxxx should not display beyond 5
+// fractional digits, because it is in the noise of what a Duration can
+// represent.
+struct DisplayUnit {
+  std::wstring_view abbr;
+  int prec;
+  double pow10;
+};
+constexpr DisplayUnit kDisplayNano = {L"ns", 2, 1e2};
+constexpr DisplayUnit kDisplayMicro = {L"us", 5, 1e5};
+constexpr DisplayUnit kDisplayMilli = {L"ms", 8, 1e8};
+constexpr DisplayUnit kDisplaySec = {L"s", 11, 1e11};
+constexpr DisplayUnit kDisplayMin = {L"m", -1, 0.0};  // prec ignored
+constexpr DisplayUnit kDisplayHour = {L"h", -1, 0.0}; // prec ignored
+
+void AppendNumberUnit(std::wstring *out, int64_t n, DisplayUnit unit) {
+  constexpr auto kBufferSize = sizeof("2562047788015216");
+  wchar_t buf[kBufferSize]; // hours in max duration
+  wchar_t *const ep = buf + kBufferSize;
+  wchar_t *bp = Format64(ep, 0, n);
+  if (*bp != L'0' || bp + 1 != ep) {
+    out->append(bp, ep - bp);
+    out->append(unit.abbr);
+  }
+}
+
+// Note: unit.prec is limited to double's digits10 value (typically 15) so it
+// always fits in buf[].
+void AppendNumberUnit(std::wstring *out, double n, DisplayUnit unit) {
+  constexpr int kBufferSize = std::numeric_limits<double>::digits10;
+  const int prec = (std::min)(kBufferSize, unit.prec);
+  wchar_t buf[kBufferSize]; // also large enough to hold integer part
+  wchar_t *ep = buf + kBufferSize;
+  double d = 0;
+  auto frac_part = static_cast<int64_t>(std::round(std::modf(n, &d) * unit.pow10));
+  auto int_part = static_cast<int64_t>(d);
+  if (int_part != 0 || frac_part != 0) {
+    wchar_t *bp = Format64(ep, 0, int_part); // always < 1000
+    out->append(bp, ep - bp);
+    if (frac_part != 0) {
+      out->push_back('.');
+      bp = Format64(ep, prec, frac_part);
+      while (ep[-1] == '0') {
+        --ep;
+      }
+      out->append(bp, ep - bp);
+    }
+    out->append(unit.abbr);
+  }
+}
+
+std::wstring LegacyFormatDuration(Duration d) {
+  constexpr Duration kMinDuration = Seconds((std::numeric_limits<int64_t>::min)());
+  if (d == kMinDuration) {
+    // Avoid needing to negate (std::numeric_limits<int64_t>::min)() by directly returning what the
+    // following code should produce in that case.
+    return L"-2562047788015215h30m8s";
+  }
+  std::wstring s;
+  if (d < ZeroDuration()) {
+    s.append(L"-");
+    d = -d;
+  }
+  if (d == InfiniteDuration()) {
+    s.append(L"inf");
+  } else if (d < Seconds(1)) {
+    // Special case for durations with a magnitude < 1 second.  The duration
+    // is printed as a fraction of a single unit, e.g., "1.2ms".
+    if (d < Microseconds(1)) {
+      AppendNumberUnit(&s, FDivDuration(d, Nanoseconds(1)), kDisplayNano);
+    } else if (d < Milliseconds(1)) {
+      AppendNumberUnit(&s, FDivDuration(d, Microseconds(1)), kDisplayMicro);
+    } else {
+      AppendNumberUnit(&s, FDivDuration(d, Milliseconds(1)), kDisplayMilli);
+    }
+  } else {
+    AppendNumberUnit(&s, IDivDuration(d, Hours(1), &d), kDisplayHour);
+    AppendNumberUnit(&s, IDivDuration(d, Minutes(1), &d), kDisplayMin);
+    AppendNumberUnit(&s, FDivDuration(d, Seconds(1)), kDisplaySec);
+  }
+  if (s.empty() || s == L"-") {
+    s = L"0";
+  }
+  return s;
+}
+
+// A helper for ParseDuration() that parses a leading number from the given
+// string and stores the result in *int_part/*frac_part/*frac_scale.  The
+// given string pointer is modified to point to the first unconsumed char.
+bool ConsumeDurationNumber(const wchar_t **dpp, const wchar_t *ep, int64_t *int_part, int64_t *frac_part,
+                           int64_t *frac_scale) {
+  *int_part = 0;
+  *frac_part = 0;
+  *frac_scale = 1; // invariant: *frac_part < *frac_scale
+  const wchar_t *start = *dpp;
+  for (; *dpp != ep; *dpp += 1) {
+    const int d = **dpp - '0'; // contiguous digits
+    if (d < 0 || 10 <= d) {
+      break;
+    }
+
+    if (*int_part > (std::numeric_limits<int64_t>::max)() / 10) {
+      return false;
+    }
+    *int_part *= 10;
+    if (*int_part > (std::numeric_limits<int64_t>::max)() - d) {
+      return false;
+    }
+    *int_part += d;
+  }
+  const bool int_part_empty = (*dpp == start);
+  if (*dpp == ep || **dpp != '.') {
+    return !int_part_empty;
+  }
+
+  for (*dpp += 1; *dpp != ep; *dpp += 1) {
+    const int d = **dpp - '0'; // contiguous digits
+    if (d < 0 || 10 <= d) {
+      break;
+    }
+    if (*frac_scale <= (std::numeric_limits<int64_t>::max)() / 10) {
+      *frac_part *= 10;
+      *frac_part += d;
+      *frac_scale *= 10;
+    }
+  }
+  return !int_part_empty || *frac_scale != 1;
+}
+
+// A helper for ParseDuration() that parses a leading unit designator (e.g.,
+// ns, us, ms, s, m, h) from the given string and stores the resulting unit
+// in "*unit".  The given string pointer is modified to point to the first
+// unconsumed char.
+bool ConsumeDurationUnit(const wchar_t **start, const wchar_t *end, Duration *unit) {
+  size_t size = end - *start;
+  switch (size) {
+  case 0:
+    return false;
+  default:
+    switch (**start) {
+    case L'n':
+      if (*(*start + 1) == L's') {
+        *start += 2;
+        *unit = Nanoseconds(1);
+        return true;
+      }
+      break;
+    case L'u':
+      if (*(*start + 1) == L's') {
+        *start += 2;
+        *unit = Microseconds(1);
+        return true;
+      }
+      break;
+    case L'm':
+      if (*(*start + 1) == L's') {
+        *start += 2;
+        *unit = Milliseconds(1);
+        return true;
+      }
+      break;
+    default:
+      break;
+    }
+    [[fallthrough]];
+  case 1:
+    switch (**start) {
+    case L's':
+      *unit = Seconds(1);
+      *start += 1;
+      return true;
+    case L'm':
+      *unit = Minutes(1);
+      *start += 1;
+      return true;
+    case L'h':
+      *unit = Hours(1);
+      *start += 1;
+      return true;
+    default:
+      return false;
+    }
+  }
+}
+
+bool LegacyParseDuration(std::wstring_view dur_sv, Duration *d) {
+  int sign = 1;
+  if (bela::ConsumePrefix(&dur_sv, L"-")) {
+    sign = -1;
+  } else {
+    bela::ConsumePrefix(&dur_sv, L"+");
+  }
+  if (dur_sv.empty()) {
+    return false;
+  }
+
+  // Special case for a string of "0".
+  if (dur_sv == L"0") {
+    *d = ZeroDuration();
+    return true;
+  }
+
+  if (dur_sv == L"inf") {
+    *d = sign * InfiniteDuration();
+    return true;
+  }
+
+  const wchar_t *start = dur_sv.data();
+  const wchar_t *end = start + dur_sv.size();
+
+  Duration dur;
+  while (start != end) {
+    int64_t int_part;
+    int64_t frac_part;
+    int64_t frac_scale;
+    Duration unit;
+    if (!ConsumeDurationNumber(&start, end, &int_part, &frac_part, &frac_scale) ||
+        !ConsumeDurationUnit(&start, end, &unit)) {
+      return false;
+    }
+    if (int_part != 0) {
+      dur += sign * int_part * unit;
+    }
+    if (frac_part != 0) {
+      dur += sign * frac_part * unit / frac_scale;
+    }
+  }
+  *d = dur;
+  return true;
+}
+} // namespace legacy
+
+template <typename F> double Bench(F &&fn, int64_t n) {
+  auto start = bela::MonotonicNow();
+  for (int64_t i = 0; i < n; i++) {
+    fn(i);
+  }
+  return bela::ToDoubleNanoseconds(bela::MonotonicNow() - start) / static_cast<double>(n);
+}
+
+int wmain() {
+  std::mt19937_64 rng(83);
+  std::vector<bela::Duration> durations;
+  for (int i = 0; i < 100000; i++) {
+    auto v = static_cast<int64_t>(rng() >> (rng() % 64));
+    durations.emplace_back(bela::Nanoseconds(i % 2 == 0 ? v : -v) / static_cast<int64_t>(rng() % 7 + 1));
+  }
+  durations.emplace_back(bela::InfiniteDuration());
+  durations.emplace_back(-bela::InfiniteDuration());
+  durations.emplace_back(bela::Seconds((std::numeric_limits<int64_t>::min)()));
+  durations.emplace_back(bela::ZeroDuration());
+  int errors = 0;
+  std::vector<std::wstring> inputs;
+  for (const auto d : durations) {
+    auto ws = bela::FormatDuration(d);
+    wchar_t wbuf[bela::DurationMaxLength];
+    char buf[bela::DurationMaxLength];
+    auto wn = bela::FormatDuration(d, wbuf);
+    auto n = bela::FormatDuration(d, buf);
+    if (ws != legacy::LegacyFormatDuration(d) || std::wstring_view(wbuf, wn) != ws || n != ws.size() || !std::equal(buf, buf + n, ws.begin()) ||
+        bela::FormatDuration(d, std::span<char>(buf, n - 1)) != 0) {
+      bela::FPrintF(stderr, L"format mismatch %s\n", ws);
+      errors++;
+    }
+    inputs.emplace_back(std::move(ws));
+  }
+  // integer unit forms, including ones that overflow int64 nanoseconds
+  for (int i = 0; i < 100000; i++) {
+    std::wstring s = i % 3 == 0 ? L"-" : L"";
+    constexpr std::wstring_view units[] = {L"h", L"m", L"s", L"ms", L"us", L"ns"};
+    for (auto k = rng() % 4 + 1; k > 0; k--) {
+      s.append(std::to_wstring(rng() >> (rng() % 64))).append(units[rng() % 6]);
+    }
+    inputs.emplace_back(std::move(s));
+  }
+  for (auto s : {L"", L"-", L"+", L"1", L"1x", L"ms", L"1.s", L".5h", L"1h2", L"99999999999999999999s", L"inf", L"+0",
+                 L"1m1ms1us1ns1s1h", L"1us2"}) {
+    inputs.emplace_back(s);
+  }
+  for (const auto &s : inputs) {
+    bela::Duration a;
+    bela::Duration b;
+    auto ra = bela::ParseDuration(s, &a);
+    auto rb = legacy::LegacyParseDuration(s, &b);
+    std::string narrow(s.begin(), s.end());
+    bela::Duration c;
+    auto rc = bela::ParseDuration(narrow, &c);
+    if (ra != rb || rc != ra || (ra && (a != b || a != c))) {
+      bela::FPrintF(stderr, L"parse mismatch '%s'\n", s);
+      errors++;
+    }
+  }
+  bela::FPrintF(stderr, L"%d durations %d inputs %d errors\n", durations.size(), inputs.size(), errors);
+
+  constexpr int64_t n = 2000000;
+  size_t sink = 0;
+  auto m = durations.size();
+  bela::FPrintF(stdout, L"FormatDuration legacy        %6.2f ns\n",
+                Bench([&](int64_t i) { sink += legacy::LegacyFormatDuration(durations[i % m]).size(); }, n));
+  bela::FPrintF(stdout, L"FormatDuration std::wstring  %6.2f ns\n",
+                Bench([&](int64_t i) { sink += bela::FormatDuration(durations[i % m]).size(); }, n));
+  auto formatBuffer = [&](int64_t i) {
+    wchar_t buf[bela::DurationMaxLength];
+    sink += bela::FormatDuration(durations[i % m], buf);
+  };
+  bela::FPrintF(stdout, L"FormatDuration span<wchar_t> %6.2f ns\n", Bench(formatBuffer, n));
+  std::vector<std::wstring> common = {L"300ms", L"2h45m", L"10s", L"1500us", L"-42m", L"1h2m3s"};
+  auto k = common.size();
+  bela::Duration d;
+  bela::FPrintF(stdout, L"ParseDuration legacy          %6.2f ns\n",
+                Bench([&](int64_t i) { sink += legacy::LegacyParseDuration(common[i % k], &d) ? 1 : 0; }, n));
+  bela::FPrintF(stdout, L"ParseDuration                 %6.2f ns\n",
+                Bench([&](int64_t i) { sink += bela::ParseDuration(common[i % k], &d) ? 1 : 0; }, n));
+  bela::FPrintF(stdout, L"ParseDuration fraction legacy %6.2f ns\n",
+                Bench([&](int64_t) { sink += legacy::LegacyParseDuration(L"1.5h", &d) ? 1 : 0; }, n));
+  bela::FPrintF(stdout, L"ParseDuration fraction        %6.2f ns\n",
+                Bench([&](int64_t) { sink += bela::ParseDuration(L"1.5h", &d) ? 1 : 0; }, n));
+  bela::FPrintF(stdout, L"(%d)\n", sink & 1);
+  return errors == 0 ? 0 : 1;
+}
@@ -0,0 +1,52 @@
+//
+#include <bela/datetime.hpp>
+#include <bela/terminal.hpp>
+
+struct rfc3339_case {
+  std::string_view text;
+  bool ok;
+  int64_t sec;
+  uint32_t nsec;
+};
+
+int wmain() {
+  constexpr rfc3339_case cases[] = {
+      {"2023-11-14T22:13:20Z", true, 1700000000, 0},
+      {"2023-11-15T06:13:20.123456789+08:00", true, 1700000000, 123456789},
+      {"2023-11-14t22:13:20.1z", true, 1700000000, 100000000},
+      {"2023-11-14 22:13:20-01:30", true, 1700005400, 0},
+      {"2024-02-29T00:00:00Z", true, 1709164800, 0},
+      {"1970-01-01T00:00:00.0000000019Z", true, 0, 1},
+      {"0001-01-01T00:00:00Z", true, -62135596800, 0},
+      {"2023-02-29T00:00:00Z", false, 0, 0},
+      {"2023-11-14T24:13:20Z", false, 0, 0},
+      {"2023-11-14T22:13:20", false, 0, 0},
+      {"2023-1-14T22:13:20Z", false, 0, 0},
+      {"2023-11-14T22:13:20.Z", false, 0, 0},
+      {"2023-11-14T22:13:20+08:0x", false, 0, 0},
+  };
+  int failed = 0;
+  for (const auto &c : cases) {
+    bela::Time t;
+    bela::Time tw;
+    auto ok = bela::ParseRFC3339(c.text, &t);
+    auto wtext = bela::encode_into<char, wchar_t>(c.text);
+    auto okw = bela::ParseRFC3339(wtext, &tw);
+    auto parts = bela::Split(t);
+    if (ok != c.ok || okw != c.ok || (ok && (parts.sec != c.sec || parts.nsec != c.nsec || t != tw))) {
+      bela::FPrintF(stderr, L"\x1b[31mParseRFC3339(%s) = %b %d.%09d\x1b[0m\n", c.text, ok, parts.sec, parts.nsec);
+      failed++;
+      continue;
+    }
+    if (ok) {
+      // must round trip through the formatter
+      bela::Time t2;
+      if (!bela::ParseRFC3339(bela::FormatUniversalTime<char>(t, true), &t2) || t2 != t) {
+        bela::FPrintF(stderr, L"\x1b[31mround trip %s failed\x1b[0m\n", c.text);
+        failed++;
+      }
+    }
+  }
+  bela::FPrintF(stderr, L"rfc3339: %d failed\n", failed);
+  return failed == 0 ? 0 : 1;
+}
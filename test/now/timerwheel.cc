@@ -0,0 +1,81 @@
+//
+#include <bela/timer_wheel.hpp>
+#include <bela/terminal.hpp>
+#include <random>
+#include <thread>
+
+// drive the wheel with a synthetic clock and check every timer fires after its deadline and within one tick of it
+int check(int64_t count) {
+  const auto tick = bela::Milliseconds(1);
+  bela::TimerWheel wheel(tick, bela::ZeroDuration());
+  std::mt19937_64 rng(20231018);
+  std::vector<bela::Duration> deadlines(count);
+  std::vector<bela::Duration> fired(count, bela::InfiniteDuration());
+  std::vector<bela::Duration> previous(count);
+  std::vector<bela::TimerWheel::timer_id> ids(count);
+  bela::Duration now;
+  bela::Duration last;
+  for (int64_t i = 0; i < count; i++) {
+    // mostly short timeouts, some spanning several levels and a few beyond the top wheel
+    auto range = (i % 100 == 0) ? int64_t{1} << 40 : (i % 10 == 0) ? int64_t{1} << 26 : int64_t{1} << 14;
+    deadlines[i] = bela::Microseconds(static_cast<int64_t>(rng() % static_cast<uint64_t>(range)) * 997);
+    ids[i] = wheel.ScheduleAt(deadlines[i], [&, i] {
+      fired[i] = now;
+      previous[i] = last;
+    });
+  }
+  std::vector<bool> canceled(count);
+  for (int64_t i = 0; i < count; i += 3) {
+    canceled[i] = wheel.Cancel(ids[i]);
+  }
+  int64_t steps = 0;
+  while (!wheel.Empty()) {
+    now += bela::Milliseconds(static_cast<int64_t>(rng() % 5000)) +
+           bela::Microseconds(static_cast<int64_t>(rng() % 1000));
+    if (rng() % 64 == 0) {
+      now += bela::Hours(static_cast<int64_t>(rng() % 100000));
+    }
+    wheel.Advance(now);
+    last = now;
+    steps++;
+  }
+  int64_t errors = 0;
+  for (int64_t i = 0; i < count; i++) {
+    if (canceled[i]) {
+      if (fired[i] != bela::InfiniteDuration()) {
+        errors++;
+      }
+      continue;
+    }
+    // fired on the first Advance whose time reached the deadline rounded up to a tick
+    auto due = (std::max)(bela::Ceil(deadlines[i], tick), tick);
+    if (fired[i] < due || previous[i] >= due || wheel.Cancel(ids[i])) {
+      errors++;
+    }
+  }
+  bela::FPrintF(stderr, L"%d timers %d steps %d errors\n", count, steps, errors);
+  return errors == 0 ? 0 : 1;
+}
+
+int wmain() {
+  if (check(200000) != 0) {
+    return 1;
+  }
+  // real clock: posts from another thread, waits go through bela::SleepFor
+  bela::TimerWheel wheel(bela::Milliseconds(1));
+  std::atomic_int done{0};
+  auto start = bela::MonotonicNow();
+  std::jthread poster([&] {
+    for (int i = 0; i < 10; i++) {
+      wheel.Post(bela::Milliseconds(10 * (i + 1)), [&, i] {
+        bela::FPrintF(stderr, L"timer %d after %s\n", i, bela::FormatDuration(bela::MonotonicNow() - start));
+        done++;
+      });
+    }
+  });
+  poster.join();
+  while (done < 10) {
+    wheel.Run(bela::Milliseconds(50));
+  }
+  return 0;
+}
@@ -0,0 +1,95 @@
+//
+#include <bela/datetime.hpp>
+#include <bela/terminal.hpp>
+
+// Expected formats t like DateTime::Format with the given offset, keeping digits fractional digits
+std::string Expected(bela::Time t, std::int_least32_t tz, int digits) {
+  auto full = bela::DateTime(t - bela::Seconds(tz), tz).Format<char>(false);
+  if (digits == 0) {
+    return full;
+  }
+  char fraction[11] = ".000000000";
+  auto nsec = bela::Split(t).nsec;
+  for (int i = 9; i > 0; i--) {
+    fraction[i] = static_cast<char>('0' + nsec % 10);
+    nsec /= 10;
+  }
+  // the seconds end at the 19th character of a four digit year
+  full.insert(19, fraction, static_cast<size_t>(digits + 1));
+  return full;
+}
+
+// check formats a sequence of times stepping across boundary with one formatter, so most stamps hit the cached prefix
+// and every change of second, minute or day refreshes it
+int check(bela::TimestampFormatter &f, bela::Time boundary, int digits) {
+  int failed = 0;
+  char buffer[bela::TimestampFormatter::MaxLength];
+  wchar_t wbuffer[bela::TimestampFormatter::MaxLength];
+  for (auto t = boundary - bela::Seconds(2); t < boundary + bela::Seconds(2); t += bela::Nanoseconds(123456789)) {
+    auto want = Expected(t, f.TimeZoneOffset(), digits);
+    auto n = f.Format(t, buffer);
+    auto wn = f.Format(t, wbuffer);
+    std::string_view got(buffer, n);
+    if (got != want || bela::encode_into<wchar_t, char>(std::wstring_view(wbuffer, wn)) != want) {
+      bela::FPrintF(stderr, L"\x1b[31mTimestampFormatter(%d, %d) = %s want %s\x1b[0m\n", f.TimeZoneOffset(), digits,
+                    got, want);
+      failed++;
+    }
+  }
+  return failed;
+}
+
+int wmain() {
+  int failed = 0;
+  // 2024-01-01, 1970-01-01 and the day after the 2024 leap day, all 00:00:00 UTC
+  constexpr int64_t days[] = {1704067200, 0, 1709251200};
+  // the local zone of FormatTime, UTC and offsets east and west of it, one of them not a whole hour
+  const std::int_least32_t zones[] = {bela::TimeZoneOffset(), 0, -28800, 18000, -19800};
+  for (auto tz : zones) {
+    for (auto digits : {9, 3, 0}) {
+      // one formatter per zone and precision across all boundaries: going back in time refreshes the prefix as well
+      bela::TimestampFormatter f(tz, digits);
+      for (auto day : days) {
+        // midnight of the zone: the day, minute and second change at once
+        auto midnight = bela::FromUnixSeconds(day) + bela::Seconds(tz);
+        failed += check(f, midnight, digits);
+        failed += check(f, midnight + bela::Minutes(1), digits);
+        failed += check(f, midnight + bela::Seconds(37), digits);
+      }
+    }
+  }
+  // the stamps of FormatTime, which formats in the local zone
+  bela::TimestampFormatter local(bela::TimeZoneOffset());
+  char buffer[bela::TimestampFormatter::MaxLength];
+  for (auto t = bela::FromUnixSeconds(1704067198) + bela::Nanoseconds(1); t < bela::FromUnixSeconds(1704067202);
+       t += bela::Milliseconds(250)) {
+    auto want = bela::FormatTime<char>(t, true);
+    std::string_view got(buffer, local.Format(t, buffer));
+    if (got != want) {
+      bela::FPrintF(stderr, L"\x1b[31mFormatTime %s TimestampFormatter %s\x1b[0m\n", want, got);
+      failed++;
+    }
+  }
+  // formatters of two zones sharing the seconds keep their own prefix
+  bela::TimestampFormatter utc(0);
+  bela::TimestampFormatter east(-28800);
+  auto t = bela::FromUnixSeconds(1700000000) + bela::Nanoseconds(5);
+  for (int i = 0; i < 4; i++, t += bela::Milliseconds(400)) {
+    std::string_view a(buffer, utc.Format(t, buffer));
+    if (a != Expected(t, 0, 9)) {
+      bela::FPrintF(stderr, L"\x1b[31mUTC %s\x1b[0m\n", a);
+      failed++;
+    }
+    std::string_view b(buffer, east.Format(t, buffer));
+    if (b != Expected(t, -28800, 9)) {
+      bela::FPrintF(stderr, L"\x1b[31m+08:00 %s\x1b[0m\n", b);
+      failed++;
+    }
+  }
+  if (utc.Format(t, std::span<char>(buffer, 10)) != 0) {
+    bela::FPrintF(stderr, L"\x1b[31mshort buffer accepted\x1b[0m\n");
+    failed++;
+  }
+  bela::FPrintF(stderr, L"timestamp: %d failed\n", failed);
+  return failed == 0 ? 0 : 1;
+}
@@ -0,0 +1,211 @@
+//
+#include <bela/zoneinfo.hpp>
+#include <bela/terminal.hpp>
+
+struct zone_type {
+  int32_t offset;
+  bool dst;
+  std::string_view abbreviation;
+};
+
+void AppendBE32(std::vector<uint8_t> &out, uint32_t v) {
+  for (int shift = 24; shift >= 0; shift -= 8) {
+    out.push_back(static_cast<uint8_t>(v >> shift));
+  }
+}
+
+void AppendBE64(std::vector<uint8_t> &out, uint64_t v) {
+  AppendBE32(out, static_cast<uint32_t>(v >> 32));
+  AppendBE32(out, static_cast<uint32_t>(v));
+}
+
+void AppendHeader(std::vector<uint8_t> &out, uint32_t timecnt, uint32_t typecnt, uint32_t charcnt) {
+  constexpr uint8_t magic[] = {'T', 'Z', 'i', 'f', '2'};
+  out.insert(out.end(), std::begin(magic), std::end(magic));
+  out.insert(out.end(), 15, 0);
+  for (auto v : {0U, 0U, 0U, timecnt, typecnt, charcnt}) {
+    AppendBE32(out, v);
+  }
+}
+
+// MakeTZif builds a TZif v2 image: an empty v1 block, then the transitions, types and POSIX TZ footer
+std::vector<uint8_t> MakeTZif(std::span<const int64_t> transitions, std::span<const uint8_t> indexes,
+                              std::span<const zone_type> types, std::string_view footer) {
+  std::string designations;
+  std::vector<uint8_t> out;
+  AppendHeader(out, 0, 1, 1);
+  out.insert(out.end(), {0, 0, 0, 0, 0, 0, 0});
+  for (const auto &t : types) {
+    designations.append(t.abbreviation).push_back('\0');
+  }
+  AppendHeader(out, static_cast<uint32_t>(transitions.size()), static_cast<uint32_t>(types.size()),
+               static_cast<uint32_t>(designations.size()));
+  for (auto t : transitions) {
+    AppendBE64(out, static_cast<uint64_t>(t));
+  }
+  out.insert(out.end(), indexes.begin(), indexes.end());
+  size_t index = 0;
+  for (const auto &t : types) {
+    AppendBE32(out, static_cast<uint32_t>(t.offset));
+    out.push_back(t.dst ? 1 : 0);
+    out.push_back(static_cast<uint8_t>(index));
+    index += t.abbreviation.size() + 1;
+  }
+  out.insert(out.end(), designations.begin(), designations.end());
+  out.push_back('\n');
+  out.insert(out.end(), footer.begin(), footer.end());
+  out.push_back('\n');
+  return out;
+}
+
+struct expected_offset {
+  int64_t sec;
+  int32_t offset;
+  std::string_view abbreviation;
+};
+
+int check(const bela::TimeZone &tz, std::span<const expected_offset> cases) {
+  int failed = 0;
+  std::vector<int64_t> seconds;
+  for (const auto &c : cases) {
+    const auto &zt = tz.Lookup(c.sec);
+    if (zt.offset != c.offset || zt.abbreviation != c.abbreviation) {
+      bela::FPrintF(stderr, L"\x1b[31m%s at %d: %d %s, want %d %s\x1b[0m\n", tz.Name(), c.sec, zt.offset,
+                    zt.abbreviation, c.offset, c.abbreviation);
+      failed++;
+    }
+    seconds.emplace_back(c.sec);
+  }
+  // the batch path must agree with Lookup
+  std::vector<std::int_least32_t> offsets(seconds.size());
+  tz.Offsets(seconds, offsets);
+  for (size_t i = 0; i < cases.size(); i++) {
+    if (offsets[i] != cases[i].offset) {
+      bela::FPrintF(stderr, L"\x1b[31m%s Offsets at %d: %d, want %d\x1b[0m\n", tz.Name(), cases[i].sec, offsets[i],
+                    cases[i].offset);
+      failed++;
+    }
+  }
+  return failed;
+}
+
+int check_local(const bela::TimeZone &tz, int64_t sec, std::wstring_view want) {
+  auto got = tz.LocalDateTime(bela::FromUnixSeconds(sec)).Format();
+  if (got != want) {
+    bela::FPrintF(stderr, L"\x1b[31m%s LocalDateTime(%d) = %s, want %s\x1b[0m\n", tz.Name(), sec, got, want);
+    return 1;
+  }
+  return 0;
+}
+
+// US and EU DST boundaries of 2024 and a fixed offset: every zone is built from its rule, so the test does not
+// depend on a tzdata installation
+int check_rules() {
+  int failed = 0;
+  bela::error_code ec;
+  constexpr zone_type est[] = {{-18000, false, "EST"}};
+  auto data = MakeTZif({}, {}, est, "EST5EDT,M3.2.0,M11.1.0");
+  auto newYork = bela::TimeZone::Parse(L"US/Eastern", bela::bytes_view(data.data(), data.size()), ec);
+  if (!newYork) {
+    bela::FPrintF(stderr, L"\x1b[31mparse US/Eastern: %s\x1b[0m\n", ec);
+    return 1;
+  }
+  // 2024-03-10 02:00 EST and 2024-11-03 02:00 EDT
+  constexpr expected_offset us[] = {
+      {1710053999, -18000, "EST"}, {1710054000, -14400, "EDT"}, {1730613599, -14400, "EDT"},
+      {1730613600, -18000, "EST"}, {1735689600, -18000, "EST"}, {4102444800, -18000, "EST"},
+  };
+  failed += check(*newYork, us);
+  failed += check_local(*newYork, 1710053999, L"2024-03-10T01:59:59-05:00");
+  failed += check_local(*newYork, 1710054000, L"2024-03-10T03:00:00-04:00");
+
+  constexpr zone_type cet[] = {{3600, false, "CET"}};
+  data = MakeTZif({}, {}, cet, "CET-1CEST,M3.5.0,M10.5.0/3");
+  auto berlin = bela::TimeZone::Parse(L"Europe/Berlin", bela::bytes_view(data.data(), data.size()), ec);
+  if (!berlin) {
+    bela::FPrintF(stderr, L"\x1b[31mparse Europe/Berlin: %s\x1b[0m\n", ec);
+    return 1;
+  }
+  // 2024-03-31 01:00 UTC and 2024-10-27 01:00 UTC
+  constexpr expected_offset eu[] = {
+      {1711846799, 3600, "CET"},  {1711846800, 7200, "CEST"}, {1729990799, 7200, "CEST"},
+      {1729990800, 3600, "CET"},  {1719792000, 7200, "CEST"}, {1704067200, 3600, "CET"},
+  };
+  failed += check(*berlin, eu);
+  failed += check_local(*berlin, 1729990800, L"2024-10-27T02:00:00+01:00");
+
+  // a table ending in a fixed offset: local mean time, a half-hour offset from 1950, then the footer
+  constexpr zone_type kolkata[] = {{21208, false, "LMT"}, {19800, false, "IST"}, {23400, true, "+0630"}};
+  constexpr int64_t transitions[] = {-2524541608, -880000000, -860000000};
+  constexpr uint8_t indexes[] = {1, 2, 1};
+  data = MakeTZif(transitions, indexes, kolkata, "IST-5:30");
+  auto india = bela::TimeZone::Parse(L"Asia/Kolkata", bela::bytes_view(data.data(), data.size()), ec);
+  if (!india) {
+    bela::FPrintF(stderr, L"\x1b[31mparse Asia/Kolkata: %s\x1b[0m\n", ec);
+    return 1;
+  }
+  constexpr expected_offset in[] = {
+      {-2600000000, 21208, "LMT"}, {-2524541608, 19800, "IST"}, {-870000000, 23400, "+0630"},
+      {-860000000, 19800, "IST"},  {1700000000, 19800, "IST"},  {7258118400, 19800, "IST"},
+  };
+  failed += check(*india, in);
+  failed += check_local(*india, 1700000000, L"2023-11-15T03:43:20+05:30");
+  return failed;
+}
+
+// check_names: names escaping the zoneinfo directory are rejected before any file is opened
+int check_names() {
+  int failed = 0;
+  constexpr std::wstring_view names[] = {
+      L"", L"../secret", L"Asia/../../secret", L"\\Windows\\win.ini", L"/etc/localtime",
+      L"C:\\Windows\\win.ini", L"C:zone", L"\\\\server\\share\\zone", L"Asia/Shanghai:stream",
+  };
+  for (auto name : names) {
+    bela::error_code ec;
+    if (bela::LoadTimeZone(name, ec) || !ec.message.starts_with(L"invalid time zone name")) {
+      bela::FPrintF(stderr, L"\x1b[31mLoadTimeZone(%s) not rejected: %s\x1b[0m\n", name, ec);
+      failed++;
+    }
+  }
+  return failed;
+}
+
+// check_installed: with a zoneinfo directory, the installed zones must agree with the rules
+int check_installed(std::wstring_view dir) {
+  bela::SetZoneInfoDirectory(dir);
+  struct installed_case {
+    std::wstring_view name;
+    int64_t sec;
+    int32_t offset;
+  };
+  constexpr installed_case cases[] = {
+      {L"America/New_York", 1710053999, -18000}, {L"America/New_York", 1710054000, -14400},
+      {L"America/New_York", 1730613600, -18000}, {L"Europe/Berlin", 1711846800, 7200},
+      {L"Europe/Berlin", 1729990800, 3600},      {L"Asia/Kolkata", 1700000000, 19800},
+      {L"Asia/Shanghai", 1700000000, 28800},
+  };
+  int failed = 0;
+  for (const auto &c : cases) {
+    bela::error_code ec;
+    auto tz = bela::LoadTimeZone(c.name, ec);
+    if (!tz) {
+      bela::FPrintF(stderr, L"\x1b[31mload %s: %s\x1b[0m\n", c.name, ec);
+      failed++;
+      continue;
+    }
+    if (auto offset = tz->Offset(c.sec); offset != c.offset) {
+      bela::FPrintF(stderr, L"\x1b[31m%s at %d: %d, want %d\x1b[0m\n", c.name, c.sec, offset, c.offset);
+      failed++;
+    }
+  }
+  return failed;
+}
+
+int wmain(int argc, wchar_t **argv) {
+  auto failed = check_rules() + check_names();
+  if (argc > 1) {
+    failed += check_installed(argv[1]);
+  }
+  bela::FPrintF(stderr, L"zoneinfo: %d failed\n", failed);
+  return failed == 0 ? 0 : 1;
+}
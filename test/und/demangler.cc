@@ -0,0 +1,56 @@
+//
+#include <bela/und.hpp>
+#include <bela/io.hpp>
+#include <bela/str_split_narrow.hpp>
+#include <bela/terminal.hpp>
+#include <bela/time.hpp>
+#include <thread>
+
+// demangler_test symbols.txt: one mangled name per line (e.g. nm or dumpbin output reduced to names)
+int wmain(int argc, wchar_t **argv) {
+  if (argc < 2) {
+    bela::FPrintF(stderr, L"usage: %s symbols.txt\n", argv[0]);
+    return 1;
+  }
+  std::string content;
+  bela::error_code ec;
+  if (!bela::io::ReadFile(argv[1], content, ec)) {
+    bela::FPrintF(stderr, L"read %s: %s\n", argv[1], ec);
+    return 1;
+  }
+  std::vector<std::string_view> names =
+      bela::narrow::StrSplit(content, bela::narrow::ByAnyChar("\r\n"), bela::narrow::SkipEmpty());
+  bela::Demangler demangler;
+  size_t mismatch = 0;
+  for (auto name : names) {
+    if (demangler.Demangle(name) != bela::demangle(name)) {
+      bela::FPrintF(stderr, L"mismatch: %s\n", name);
+      mismatch++;
+    }
+  }
+  auto start = bela::MonotonicNow();
+  size_t total = 0;
+  for (auto name : names) {
+    total += bela::demangle(name).size();
+  }
+  auto single = bela::MonotonicNow() - start;
+  bela::DemangledNames out;
+  start = bela::MonotonicNow();
+  demangler.Demangle(names, out);
+  auto batch = bela::MonotonicNow() - start;
+  bela::FPrintF(stdout, L"%d names %d mismatch, %d bytes\nbela::demangle   %s\nDemangler batch  %s\n", names.size(),
+                mismatch, total, bela::FormatDuration(single), bela::FormatDuration(batch));
+  for (size_t concurrency = 1; concurrency <= std::thread::hardware_concurrency(); concurrency *= 2) {
+    start = bela::MonotonicNow();
+    auto all = bela::DemangleAll(names, concurrency);
+    auto elapsed = bela::MonotonicNow() - start;
+    for (size_t i = 0; i < names.size(); i++) {
+      if (all[i] != out[i]) {
+        bela::FPrintF(stderr, L"DemangleAll mismatch: %s\n", names[i]);
+        mismatch++;
+      }
+    }
+    bela::FPrintF(stdout, L"DemangleAll %2d threads %s\n", concurrency, bela::FormatDuration(elapsed));
+  }
+  return mismatch == 0 ? 0 : 1;
+}
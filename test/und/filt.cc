@@ -0,0 +1,26 @@
+//
+#include <bela/und.hpp>
+#include <bela/io.hpp>
+#include <bela/terminal.hpp>
+#include <bela/time.hpp>
+#include <cstdio>
+
+// undfilt file: c++filt for a whole file, the demangled text goes to stdout and the throughput to stderr
+int wmain(int argc, wchar_t **argv) {
+  if (argc < 2) {
+    bela::FPrintF(stderr, L"usage: %s file\n", argv[0]);
+    return 1;
+  }
+  std::string content;
+  bela::error_code ec;
+  if (!bela::io::ReadFile(argv[1], content, ec, 4ull * 1024 * 1024 * 1024)) {
+    bela::FPrintF(stderr, L"read %s: %s\n", argv[1], ec);
+    return 1;
+  }
+  auto start = bela::MonotonicNow();
+  auto n = bela::DemangleText(content, [](std::string_view sv) { fwrite(sv.data(), 1, sv.size(), stdout); });
+  auto elapsed = bela::MonotonicNow() - start;
+  bela::FPrintF(stderr, L"%d names replaced in %d bytes, %s (%.1f MB/s)\n", n, content.size(),
+                bela::FormatDuration(elapsed), static_cast<double>(content.size()) / bela::ToDoubleMicroseconds(elapsed));
+  return 0;
+}
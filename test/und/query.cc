@@ -0,0 +1,85 @@
+//
+#include <bela/und.hpp>
+#include <bela/io.hpp>
+#include <bela/str_split_narrow.hpp>
+#include <bela/terminal.hpp>
+#include <bela/time.hpp>
+
+// printed scope "a::b<int>::c" is in "a::b"
+bool ScopeStartsWith(std::string_view printed, std::string_view scope) {
+  if (!printed.starts_with(scope)) {
+    return false;
+  }
+  auto rest = printed.substr(scope.size());
+  return rest.empty() || rest.starts_with("::") || rest.starts_with('<');
+}
+
+// check_scopes: Scope prints the qualifier of the entity, a local entity is qualified by its function
+int check_scopes(bela::Demangler &demangler) {
+  constexpr std::string_view cases[][2] = {
+      {"_ZN1a1b1cEv", "a::b"},
+      {"_ZZ3foovE1x", "foo()"},
+      {"_ZZ3foovEN1S1fEv", "foo()::S"},
+      {"_ZZN1a3fooEvEN1S1fEv", "a::foo()::S"},
+  };
+  int failed = 0;
+  for (const auto &c : cases) {
+    if (!demangler.Parse(c[0])) {
+      bela::FPrintF(stderr, L"\x1b[31mparse %s failed\x1b[0m\n", c[0]);
+      failed++;
+      continue;
+    }
+    if (auto got = demangler.Scope(); got != c[1]) {
+      bela::FPrintF(stderr, L"\x1b[31mScope(%s) = '%s', want '%s'\x1b[0m\n", c[0], got, c[1]);
+      failed++;
+    }
+  }
+  return failed;
+}
+
+// undquery symbols.txt [scope]: count functions declared in scope (default std) without printing names, and check
+// the answer against the printed scope
+int wmain(int argc, wchar_t **argv) {
+  bela::Demangler demangler;
+  if (check_scopes(demangler) != 0) {
+    return 1;
+  }
+  if (argc < 2) {
+    bela::FPrintF(stderr, L"usage: %s symbols.txt [scope]\n", argv[0]);
+    return 1;
+  }
+  std::string content;
+  bela::error_code ec;
+  if (!bela::io::ReadFile(argv[1], content, ec)) {
+    bela::FPrintF(stderr, L"read %s: %s\n", argv[1], ec);
+    return 1;
+  }
+  auto scope = argc > 2 ? bela::encode_into<wchar_t, char>(argv[2]) : std::string("std");
+  std::vector<std::string_view> names =
+      bela::narrow::StrSplit(content, bela::narrow::ByAnyChar("\r\n"), bela::narrow::SkipEmpty());
+  size_t matched = 0;
+  auto start = bela::MonotonicNow();
+  for (auto name : names) {
+    if (demangler.Parse(name) && demangler.IsFunction() && demangler.InScope(scope)) {
+      matched++;
+    }
+  }
+  auto query = bela::MonotonicNow() - start;
+  size_t printed = 0;
+  start = bela::MonotonicNow();
+  for (auto name : names) {
+    if (demangler.Parse(name) && demangler.IsFunction() && ScopeStartsWith(demangler.Scope(), scope)) {
+      printed++;
+    }
+  }
+  auto render = bela::MonotonicNow() - start;
+  start = bela::MonotonicNow();
+  for (auto name : names) {
+    demangler.Demangle(name);
+  }
+  auto demangle = bela::MonotonicNow() - start;
+  bela::FPrintF(stdout, L"%d names, %d functions in %s (%d by printed scope)\n", names.size(), matched, scope, printed);
+  bela::FPrintF(stdout, L"Parse+InScope %s\nParse+Scope   %s\nDemangle      %s\n", bela::FormatDuration(query),
+                bela::FormatDuration(render), bela::FormatDuration(demangle));
+  return 0;
+}